@@ -0,0 +1,30 @@
+/**
+  ******************************************************************************
+  * @file    boot_request.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the bootloader entry
+  *          request functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_REQUEST_H
+#define __BOOT_REQUEST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Left in TAMP->BKP0R across the reset, as Core/Inc/main.h */
+#define BOOT_REQUEST_MENU       ((uint32_t)0x52504149) /* "IAPR": main menu */
+#define BOOT_REQUEST_DOWNLOAD   ((uint32_t)0x57504149) /* "IAPW": YMODEM download at once */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void Boot_Request(uint32_t request);
+
+#endif  /* __BOOT_REQUEST_H */
+
+/*******************************END OF FILE************************************/
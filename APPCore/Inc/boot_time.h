@@ -0,0 +1,50 @@
+/**
+  ******************************************************************************
+  * @file    boot_time.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the boot phase timing
+  *          report functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_TIME_H
+#define __BOOT_TIME_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Record left by the bootloader in the last 64 bytes of the RAM, out of the
+ * RAM of the project. Shared with Core/Inc/boot_time.h. */
+#define BOOT_TIME_ADDRESS       ((uint32_t)0x20008FC0)
+#define BOOT_TIME_MAGIC         ((uint32_t)0x42504149) /* "IAPB" */
+#define BOOT_TIME_TIMER         TIM6  /* Left counting at 1 MHz by the bootloader */
+#define BOOT_PHASE_NB           ((uint32_t)7)
+#define BOOT_PHASE_JUMP         ((uint32_t)6) /* Jump to main, stamped here */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Boot timing record, as Core/Inc/boot_time.h
+  */
+typedef struct
+{
+  uint32_t magic;       /* BOOT_TIME_MAGIC once the bootloader jumped */
+  uint32_t stamp[BOOT_PHASE_NB]; /* us from reset to the end of each phase */
+  uint32_t inputs;      /* Inputs of the boot decision, 0 to start the application */
+  uint32_t base;        /* us from reset to the jump */
+  uint32_t jump_count;  /* BOOT_TIME_TIMER count at the jump */
+} BootTime_RecordTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+#define BOOT_TIME               ((BootTime_RecordTypeDef *)BOOT_TIME_ADDRESS)
+
+/* Exported functions ------------------------------------------------------- */
+uint32_t BootTime_Enter(void);
+int BootTime_Format(char *p_text, uint32_t size);
+
+#endif  /* __BOOT_TIME_H */
+
+/*******************************END OF FILE************************************/
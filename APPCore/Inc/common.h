@@ -1,71 +0,0 @@
-/**
-  ******************************************************************************
-  * @file    IAP_Main/Inc/common.h
-  * @author  MCD Application Team
-  * @version 1.0.0
-  * @date    8-April-2015
-  * @brief   This file provides all the headers of the common functions.
-  ******************************************************************************
-  * @attention
-  *
-  * <h2><center>&copy; COPYRIGHT(c) 2015 STMicroelectronics</center></h2>
-  *
-  * Redistribution and use in source and binary forms, with or without modification,
-  * are permitted provided that the following conditions are met:
-  *   1. Redistributions of source code must retain the above copyright notice,
-  *      this list of conditions and the following disclaimer.
-  *   2. Redistributions in binary form must reproduce the above copyright notice,
-  *      this list of conditions and the following disclaimer in the documentation
-  *      and/or other materials provided with the distribution.
-  *   3. Neither the name of STMicroelectronics nor the names of its contributors
-  *      may be used to endorse or promote products derived from this software
-  *      without specific prior written permission.
-  *
-  * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS"
-  * AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE
-  * IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
-  * DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE
-  * FOR ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL
-  * DAMAGES (INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
-  * SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
-  * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY,
-  * OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE
-  * OF THIS SOFTWARE, EVEN IF ADVISED OF THE POSSIBILITY OF SUCH DAMAGE.
-  *
-  ******************************************************************************
-  */
-
-/* Define to prevent recursive inclusion -------------------------------------*/
-#ifndef __COMMON_H
-#define __COMMON_H
-
-/* Includes ------------------------------------------------------------------*/
-#include "stm32g0xx.h"
-//#include "stm32l073z_eval.h"
-
-/* Exported types ------------------------------------------------------------*/
-/* Exported constants --------------------------------------------------------*/
-/* Constants used by Serial Command Line Mode */
-#define TX_TIMEOUT          ((uint32_t)100)
-#define RX_TIMEOUT          HAL_MAX_DELAY
-
-/* Exported macro ------------------------------------------------------------*/
-#define IS_CAP_LETTER(c)    (((c) >= 'A') && ((c) <= 'F'))
-#define IS_LC_LETTER(c)     (((c) >= 'a') && ((c) <= 'f'))
-#define IS_09(c)            (((c) >= '0') && ((c) <= '9'))
-#define ISVALIDHEX(c)       (IS_CAP_LETTER(c) || IS_LC_LETTER(c) || IS_09(c))
-#define ISVALIDDEC(c)       IS_09(c)
-#define CONVERTDEC(c)       (c - '0')
-
-#define CONVERTHEX_ALPHA(c) (IS_CAP_LETTER(c) ? ((c) - 'A'+10) : ((c) - 'a'+10))
-#define CONVERTHEX(c)       (IS_09(c) ? ((c) - '0') : CONVERTHEX_ALPHA(c))
-
-/* Exported functions ------------------------------------------------------- */
-void Int2Str(uint8_t *p_str, uint32_t intnum);
-uint32_t Str2Int(uint8_t *inputstr, uint32_t *intnum);
-void Serial_PutString(uint8_t *p_string);
-HAL_StatusTypeDef Serial_PutByte(uint8_t param);
-
-#endif  /* __COMMON_H */
-
-/************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
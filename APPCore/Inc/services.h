@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    services.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the table of the services exported by the
+  *          bootloader (Core/Src/services.c).
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SERVICES_H
+#define __SERVICES_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The table sits at a fixed address of the bootloader, after the vector table.
+ * Shared with Core/Inc/services.h. */
+#define SVC_TABLE_ADDRESS       ((uint32_t)0x08000200)
+#define SVC_MAGIC               ((uint32_t)0x56504149) /* "IAPV" */
+#define SVC_VERSION             ((uint16_t)1)
+#define SVC_COUNT               ((uint16_t)6)          /* Services of SVC_VERSION */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Service table. New services are only appended: an application
+  *         checks the magic and that count covers the services it calls.
+  * @note   The services keep no state and use no HAL handle, they run on the
+  *         RAM and the stack of the caller. Flash and CRC registers are used
+  *         directly, the CRC configuration of the caller is restored.
+  */
+typedef struct
+{
+  uint32_t magic;       /* SVC_MAGIC */
+  uint16_t version;     /* SVC_VERSION of the bootloader */
+  uint16_t count;       /* Services in the table */
+
+  /* Erase the pages of [start, start + length), 1 if erased. Writes and
+   * erases stay inside a staging, calibration or resource slot. */
+  uint32_t (*FlashErase)(uint32_t start, uint32_t length);
+  /* Program and read back length bytes, multiple of 8, 1 if written */
+  uint32_t (*FlashWrite)(uint32_t destination, const uint8_t *p_source, uint32_t length);
+  /* CRC16-XMODEM, running value: 0 to start */
+  uint16_t (*Crc16)(uint16_t crc, const uint8_t *p_data, uint32_t length);
+  /* CRC-32 (zlib), running value: 0xFFFFFFFF to start, to invert at the end */
+  uint32_t (*Crc32)(uint32_t crc, const uint8_t *p_data, uint32_t length);
+  /* Check a YMODEM packet in the layout of ymodem_packet.h, data bytes or 0 */
+  uint32_t (*YmodemCheck)(const uint8_t *p_packet);
+  /* Frame the data of a YMODEM packet, bytes to send from PACKET_START_INDEX */
+  uint32_t (*YmodemFrame)(uint8_t *p_packet, uint8_t number, uint32_t size);
+} Svc_TableTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+#define SVC_TABLE               ((const Svc_TableTypeDef *)SVC_TABLE_ADDRESS)
+
+#endif  /* __SERVICES_H */
+
+/*******************************END OF FILE************************************/
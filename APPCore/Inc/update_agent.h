@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    update_agent.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the background update agent
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __UPDATE_AGENT_H
+#define __UPDATE_AGENT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define AGENT_START_KEY         ((uint8_t)'U')    /* Sent by the host to start a download */
+#define AGENT_BOOT_KEY          ((uint8_t)'B')    /* Sent by the host to download in the bootloader */
+#define AGENT_SLICE_BYTES       ((uint32_t)128)   /* Programmed per Agent_Poll: 16 doublewords */
+#define AGENT_CHECK_BYTES       ((uint32_t)1024)  /* Read back per Agent_Poll */
+#define AGENT_RX_RING_SIZE      ((uint32_t)2048)  /* Power of two, above one 1K packet */
+#define AGENT_TIMEOUT           ((uint32_t)1000)  /* ms without a byte before a retry */
+#define AGENT_MAX_RETRIES       ((uint32_t)30)    /* Retries in a row before the download is dropped */
+
+/* Flash layout shared with the bootloader: Core/Inc/partition.h and stage.h */
+#define AGENT_PART_TABLE_ADDRESS ((uint32_t)0x0801F800)
+#define AGENT_PART_MAGIC        ((uint32_t)0x50504149) /* "IAPP" */
+#define AGENT_PART_VERSION      ((uint8_t)1)
+#define AGENT_PART_MAX_SLOTS    ((uint32_t)8)
+#define AGENT_PART_TYPE_APP     ((uint8_t)0x02)
+#define AGENT_PART_TYPE_STAGING ((uint8_t)0x07)
+#define AGENT_STAGE_MAGIC       ((uint32_t)0x55504149) /* "IAPU" */
+#define AGENT_STAGE_IMAGE_OFFSET FLASH_PAGE_SIZE
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Agent states
+  */
+typedef enum
+{
+  AGENT_IDLE      = 0x00,  /* Waiting for AGENT_START_KEY or AGENT_BOOT_KEY */
+  AGENT_RECEIVING = 0x01,  /* YMODEM download to the staging slot */
+  AGENT_CHECKING  = 0x02,  /* Staged image read back */
+  AGENT_STAGED    = 0x03,  /* Ready for Agent_Handoff */
+  AGENT_ERROR     = 0x04   /* Last download failed, AGENT_START_KEY starts again */
+} Agent_StateTypeDef;
+
+/**
+  * @brief  Update statistics, times from a 1 us timer that keeps counting
+  *         while the core is stalled by the Flash
+  */
+typedef struct
+{
+  uint32_t bytes;       /* Image bytes received */
+  uint32_t slices;      /* Agent_Poll calls that erased, programmed or read back */
+  uint32_t slice_max;   /* us, longest Agent_Poll */
+  uint32_t loop_min;    /* us, shortest time between two Agent_Poll calls */
+  uint32_t loop_max;    /* us, longest time between two Agent_Poll calls */
+  uint32_t rx_errors;   /* Overrun, framing or noise errors, bytes lost to a full ring */
+} Agent_StatsTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+void Agent_Init(UART_HandleTypeDef *p_huart);
+void Agent_IRQHandler(void);
+void Agent_Poll(void);
+Agent_StateTypeDef Agent_GetState(void);
+const Agent_StatsTypeDef *Agent_GetStats(void);
+void Agent_Handoff(void);
+
+#endif  /* __UPDATE_AGENT_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,52 @@
+/**
+  ******************************************************************************
+  * @file    boot_request.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the entry in the bootloader without the Key
+  *          push-button: the request is left in a TAMP backup register, which
+  *          keeps its value across a system reset, then the MCU is reset. The
+  *          bootloader skips the application checks and opens the UART at
+  *          once.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_request.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Restart in the bootloader
+  * @note   Does not return. Anything still being sent is cut: wait for the
+  *         end of the transmissions first.
+  * @param  request: BOOT_REQUEST_MENU or BOOT_REQUEST_DOWNLOAD
+  * @retval None
+  */
+void Boot_Request(uint32_t request)
+{
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+  HAL_PWR_EnableBkUpAccess();
+  TAMP->BKP0R = request;
+  HAL_PWR_DisableBkUpAccess();
+
+  NVIC_SystemReset();
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    boot_time.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the report of the boot phase times measured
+  *          by the bootloader, see Core/Src/boot_time.c. The line is read by
+  *          Tools/boot_time.py.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_time.h"
+#include "stdio.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static const char * const aPhaseName[BOOT_PHASE_NB] =
+{
+  "reset", "hal", "gpio", "key", "clock", "check", "jump"
+};
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Stamp the end of the jump, first thing in main
+  * @note   Before any change of the clock: the timer still runs on the
+  *         prescaler of the bootloader.
+  * @param  None
+  * @retval 1 if the bootloader left a record, 0 otherwise
+  */
+uint32_t BootTime_Enter(void)
+{
+  if (BOOT_TIME->magic != BOOT_TIME_MAGIC)
+  {
+    return 0;
+  }
+  BOOT_TIME->stamp[BOOT_PHASE_JUMP] = BOOT_TIME->base +
+    ((BOOT_TIME_TIMER->CNT - BOOT_TIME->jump_count) & 0xFFFFU);
+  /* Reported once */
+  BOOT_TIME->magic = 0;
+  return 1;
+}
+
+/**
+  * @brief  Format the time of each phase, in us
+  * @param  p_text: output buffer
+  * @param  size: size of the buffer
+  * @retval Length of the text, as snprintf
+  */
+int BootTime_Format(char *p_text, uint32_t size)
+{
+  uint32_t i, last = 0;
+  int length, total;
+
+  total = snprintf(p_text, size, "\r\nBoot (us):");
+  for (i = 0; (i < BOOT_PHASE_NB) && (total >= 0) && ((uint32_t)total < size); i++)
+  {
+    length = snprintf(&p_text[total], size - total, " %s %u,", aPhaseName[i],
+                      (unsigned int)(BOOT_TIME->stamp[i] - last));
+    last = BOOT_TIME->stamp[i];
+    total = (length < 0) ? length : (total + length);
+  }
+  if ((total >= 0) && ((uint32_t)total < size))
+  {
+    length = snprintf(&p_text[total], size - total, " total %u, inputs 0x%02X\r\n",
+                      (unsigned int)last, (unsigned int)BOOT_TIME->inputs);
+    total = (length < 0) ? length : (total + length);
+  }
+  return total;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
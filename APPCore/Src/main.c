@@ -24,6 +24,9 @@
 /* USER CODE BEGIN Includes */
 #include "usart.h"
 #include "gpio.h"
+#include "update_agent.h"
+#include "boot_time.h"
+#include "stdio.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -33,6 +36,7 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
+#define LED_PERIOD      ((uint32_t)1000)  /* ms */
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
@@ -44,17 +48,48 @@
 
 /* USER CODE BEGIN PV */
 static uint8_t test_words[] = "test application 1\r\n";
+static char aReport[160];
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
-
+static void App_Report(Agent_StateTypeDef state);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+/**
+  * @brief  Print the outcome of a download, the line is free again
+  * @param  state: new state of the update agent
+  * @retval None
+  */
+static void App_Report(Agent_StateTypeDef state)
+{
+  const Agent_StatsTypeDef *p_stats = Agent_GetStats();
+  int length;
+
+  if (state == AGENT_STAGED)
+  {
+    length = snprintf(aReport, sizeof(aReport),
+                      "\r\nUpdate staged: %u bytes, %u slices, loop %u..%u us, slice max %u us, rx errors %u\r\n",
+                      (unsigned int)p_stats->bytes, (unsigned int)p_stats->slices,
+                      (unsigned int)p_stats->loop_min, (unsigned int)p_stats->loop_max,
+                      (unsigned int)p_stats->slice_max, (unsigned int)p_stats->rx_errors);
+  }
+  else if (state == AGENT_ERROR)
+  {
+    length = snprintf(aReport, sizeof(aReport), "\r\nUpdate failed after %u bytes\r\n",
+                      (unsigned int)p_stats->bytes);
+  }
+  else
+  {
+    return;
+  }
+  HAL_UART_Transmit(&huart2, (uint8_t *)aReport, (uint16_t)length, 100);
+}
+
 /* USER CODE END 0 */
 
 /**
@@ -64,6 +99,11 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+  Agent_StateTypeDef state, last = AGENT_IDLE;
+  uint32_t led_tick, boot_timed;
+  int length;
+
+  boot_timed = BootTime_Enter();
   __enable_irq();
   /* USER CODE END 1 */
 
@@ -88,17 +128,45 @@ int main(void)
   MX_GPIO_Init();
   HAL_GPIO_WritePin(LED_GREEN_GPIO_Port, LED_GREEN_Pin, GPIO_PIN_SET);
   MX_USART2_UART_Init();
-
-
+  if (boot_timed)
+  {
+    length = BootTime_Format(aReport, sizeof(aReport));
+    if ((length > 0) && ((uint32_t)length < sizeof(aReport)))
+    {
+      HAL_UART_Transmit(&huart2, (uint8_t *)aReport, (uint16_t)length, 100);
+    }
+  }
+  /* Updates are received in the background, 'U' starts one; 'B' restarts
+     in the bootloader download */
+  Agent_Init(&huart2);
+  led_tick = HAL_GetTick();
   /* USER CODE END 2 */
 
   /* Infinite loop */
   /* USER CODE BEGIN WHILE */
   while (1)
   {
-      HAL_UART_Transmit(&huart2, test_words, sizeof(test_words)-1, 100);
+    /* The real-time work of the application never waits for more than
+       one slice of the update */
+    Agent_Poll();
+    state = Agent_GetState();
+    if (state != last)
+    {
+      App_Report(state);
+      last = state;
+    }
+    if ((HAL_GetTick() - led_tick) >= LED_PERIOD)
+    {
+      led_tick += LED_PERIOD;
       HAL_GPIO_TogglePin(LED_GREEN_GPIO_Port, LED_GREEN_Pin);
-      HAL_Delay(1000);
+      /* The line carries the download otherwise */
+      if ((state == AGENT_IDLE) || (state == AGENT_ERROR))
+      {
+        HAL_UART_Transmit(&huart2, test_words, sizeof(test_words)-1, 100);
+      }
+    }
+    /* Restart in the bootloader, which installs the update */
+    Agent_Handoff();
     /* USER CODE END WHILE */
 
     /* USER CODE BEGIN 3 */
@@ -0,0 +1,645 @@
+/**
+  ******************************************************************************
+  * @file    update_agent.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the background update agent of the
+  *          application: a YMODEM download on USART2, received by interrupt
+  *          and written to the staging slot by Agent_Poll in short slices from
+  *          the main loop. The bootloader installs the staged image at the
+  *          next reset (Core/Src/stage.c).
+  *
+  *          YMODEM waits for each ACK, so the line is quiet while a packet is
+  *          written: nothing is lost while the Flash stalls the core. An
+  *          Agent_Poll call does one of: erase one page, program
+  *          AGENT_SLICE_BYTES, read back AGENT_CHECK_BYTES, or take in the
+  *          bytes received and check at most one packet.
+  *
+  *          Flash, CRC and packet checks are services of the bootloader
+  *          (Core/Src/services.c): without them no download is started.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "update_agent.h"
+#include "boot_request.h"
+#include "services.h"
+#include "ymodem_packet.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Partition table, same layout as Core/Inc/partition.h */
+typedef struct
+{
+  uint32_t offset;
+  uint32_t size;
+  uint8_t  type;
+  uint8_t  flags;
+  uint16_t reserved;
+} Agent_SlotTypeDef;
+
+typedef struct
+{
+  uint32_t magic;
+  uint8_t  version;
+  uint8_t  count;
+  uint16_t crc;
+  Agent_SlotTypeDef slot[AGENT_PART_MAX_SLOTS];
+} Agent_TableTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define AGENT_TIMER             TIM6  /* Free running at 1 MHz, 16 bits */
+#define AGENT_PACKET_SIZE       (PACKET_DATA_INDEX + PACKET_1K_SIZE + PACKET_TRAILER_SIZE)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static UART_HandleTypeDef *AgentUart;
+static const Svc_TableTypeDef *pAgentSvc; /* NULL if the bootloader has no services */
+static Agent_StateTypeDef AgentState;
+static Agent_StatsTypeDef AgentStats;
+static uint16_t AgentLoopLast;   /* Timer at the last Agent_Poll */
+
+/* Receive ring, filled by Agent_IRQHandler */
+static uint8_t aAgentRing[AGENT_RX_RING_SIZE];
+static __IO uint32_t AgentRingHead;
+static uint32_t AgentRingTail;
+
+/* Packet in the layout of ymodem_packet.h, word aligned for the doubleword copies */
+static uint32_t aAgentPacket[(AGENT_PACKET_SIZE + 3) / 4];
+static uint32_t AgentFill;       /* Bytes received from PACKET_START_INDEX, 0 between packets */
+static uint32_t AgentPacketSize; /* Data bytes, from the start byte */
+static uint32_t AgentLastByte;   /* HAL tick of the last byte or retry */
+static uint32_t AgentRetries;
+static uint8_t  AgentCancel;     /* Last byte was CA */
+
+/* Download */
+static uint32_t AgentStage;      /* Staging slot */
+static uint32_t AgentStageSize;
+static uint32_t AgentBlock;      /* Next packet number */
+static uint32_t AgentSize;       /* File size, 0 until the header is received */
+static uint32_t AgentLeft;       /* File bytes not received yet */
+static uint32_t AgentCrc;        /* CRC-32 of the bytes received, not inverted */
+static uint8_t  AgentEnd;        /* EOT received, waiting for the closing header */
+
+/* Flash work left before the packet is acknowledged */
+static const uint8_t *pAgentSrc;
+static uint32_t AgentWork;       /* Bytes left to program, multiple of 8 */
+static uint32_t AgentDest;       /* Next address to program */
+static uint32_t AgentErased;     /* End of the erased part of the staging slot */
+static uint32_t AgentCheck;      /* Next address to read back */
+static uint32_t AgentCheckCrc;
+
+/* Private function prototypes -----------------------------------------------*/
+static const Agent_SlotTypeDef *Agent_FindSlot(uint8_t type);
+static void Agent_Send(uint8_t byte);
+static void Agent_Fail(void);
+static void Agent_Start(void);
+static void Agent_Program(void);
+static void Agent_ReadBack(void);
+static void Agent_Packet(void);
+static void Agent_Receive(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Look for a slot in the partition table of the bootloader
+  * @param  type: slot type of Core/Inc/partition.h
+  * @retval The slot, NULL if none or without a valid table
+  */
+static const Agent_SlotTypeDef *Agent_FindSlot(uint8_t type)
+{
+  const Agent_TableTypeDef *p_table = (const Agent_TableTypeDef *)AGENT_PART_TABLE_ADDRESS;
+  uint32_t i;
+
+  if ((p_table->magic != AGENT_PART_MAGIC) || (p_table->version != AGENT_PART_VERSION) ||
+      (p_table->count == 0) || (p_table->count > AGENT_PART_MAX_SLOTS) ||
+      (pAgentSvc->Crc16(0, (const uint8_t *)p_table->slot, p_table->count * sizeof(Agent_SlotTypeDef)) != p_table->crc))
+  {
+    return NULL;
+  }
+  for (i = 0; i < p_table->count; i++)
+  {
+    if (p_table->slot[i].type == type)
+    {
+      return &p_table->slot[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+  * @brief  Send a control byte
+  * @note   Blocking, one character time: the transmit state of the handle
+  *         stays free for the application.
+  * @param  byte: byte to send
+  * @retval None
+  */
+static void Agent_Send(uint8_t byte)
+{
+  HAL_UART_Transmit(AgentUart, &byte, 1, AGENT_TIMEOUT);
+}
+
+/**
+  * @brief  Cancel the download
+  * @param  None
+  * @retval None
+  */
+static void Agent_Fail(void)
+{
+  Agent_Send(CA);
+  Agent_Send(CA);
+  AgentWork = 0;
+  AgentState = AGENT_ERROR;
+}
+
+/**
+  * @brief  Start a download to the staging slot
+  * @note   The slot is erased page by page ahead of the data, its header
+  *         page first: a previous staged image is dropped.
+  * @param  None
+  * @retval None
+  */
+static void Agent_Start(void)
+{
+  const Agent_SlotTypeDef *p_stage = (pAgentSvc != NULL) ? Agent_FindSlot(AGENT_PART_TYPE_STAGING) : NULL;
+
+  memset(&AgentStats, 0, sizeof(AgentStats));
+  AgentStats.loop_min = 0xFFFFFFFFU;
+  if ((pAgentSvc == NULL) || (p_stage == NULL) || (p_stage->size <= AGENT_STAGE_IMAGE_OFFSET))
+  {
+    AgentState = AGENT_ERROR;
+    return;
+  }
+  AgentStage = FLASH_BASE + p_stage->offset;
+  AgentStageSize = p_stage->size;
+
+  AgentRingTail = AgentRingHead;
+  AgentFill = 0;
+  AgentRetries = 0;
+  AgentCancel = 0;
+  AgentBlock = 0;
+  AgentSize = 0;
+  AgentLeft = 0;
+  AgentCrc = 0xFFFFFFFFU;
+  AgentEnd = 0;
+  AgentWork = 0;
+  AgentDest = AgentStage + AGENT_STAGE_IMAGE_OFFSET;
+  AgentErased = AgentStage;
+  AgentState = AGENT_RECEIVING;
+
+  AgentLastByte = HAL_GetTick();
+  Agent_Send(CRC16);
+}
+
+/**
+  * @brief  One slice of the packet write: erase the next page, or program up
+  *         to AGENT_SLICE_BYTES in the erased part. ACK once all is written.
+  * @param  None
+  * @retval None
+  */
+static void Agent_Program(void)
+{
+  uint32_t count = AgentWork;
+
+  if (AgentDest >= AgentErased)
+  {
+    if (!pAgentSvc->FlashErase(AgentErased, FLASH_PAGE_SIZE))
+    {
+      Agent_Fail();
+      return;
+    }
+    AgentErased += FLASH_PAGE_SIZE;
+    return;
+  }
+
+  if (count > AGENT_SLICE_BYTES)
+  {
+    count = AGENT_SLICE_BYTES;
+  }
+  if (count > (AgentErased - AgentDest))
+  {
+    count = AgentErased - AgentDest;
+  }
+  if (!pAgentSvc->FlashWrite(AgentDest, pAgentSrc, count))
+  {
+    Agent_Fail();
+    return;
+  }
+  pAgentSrc += count;
+  AgentDest += count;
+  AgentWork -= count;
+
+  if (AgentWork == 0)
+  {
+    AgentLastByte = HAL_GetTick();
+    Agent_Send(ACK);
+  }
+}
+
+/**
+  * @brief  One slice of the read back of the staged image. The header is
+  *         written once the whole image matches the bytes received.
+  * @param  None
+  * @retval None
+  */
+static void Agent_ReadBack(void)
+{
+  uint32_t end = AgentStage + AGENT_STAGE_IMAGE_OFFSET + AgentSize;
+  uint32_t length = end - AgentCheck;
+  uint32_t header[2];
+
+  if (length > AGENT_CHECK_BYTES)
+  {
+    length = AGENT_CHECK_BYTES;
+  }
+  AgentCheckCrc = pAgentSvc->Crc32(AgentCheckCrc, (const uint8_t *)AgentCheck, length);
+  AgentCheck += length;
+  if (AgentCheck != end)
+  {
+    return;
+  }
+
+  AgentState = AGENT_ERROR;
+  if (AgentCheckCrc == AgentCrc)
+  {
+    /* Length and CRC first, the magic last */
+    header[0] = AgentSize;
+    header[1] = AgentCrc ^ 0xFFFFFFFFU;
+    if (pAgentSvc->FlashWrite(AgentStage, (const uint8_t *)header, sizeof(header)))
+    {
+      header[0] = 0xFFFFFFFFU;
+      header[1] = AGENT_STAGE_MAGIC;
+      if (pAgentSvc->FlashWrite(AgentStage + 8, (const uint8_t *)header, sizeof(header)))
+      {
+        AgentState = AGENT_STAGED;
+      }
+    }
+  }
+}
+
+/**
+  * @brief  Handle a complete packet
+  * @param  None
+  * @retval None
+  */
+static void Agent_Packet(void)
+{
+  uint8_t *p_packet = (uint8_t *)aAgentPacket;
+  uint8_t *p_data = &p_packet[PACKET_DATA_INDEX];
+  const Agent_SlotTypeDef *p_app;
+  uint32_t number = p_packet[PACKET_NUMBER_INDEX];
+  uint32_t i, length, size = 0;
+
+  if (pAgentSvc->YmodemCheck(p_packet) != AgentPacketSize)
+  {
+    if (++AgentRetries > AGENT_MAX_RETRIES)
+    {
+      Agent_Fail();
+    }
+    else
+    {
+      Agent_Send(NAK);
+    }
+    return;
+  }
+  AgentRetries = 0;
+
+  if ((AgentSize == 0) || AgentEnd)
+  {
+    /* Header: file name, then its size in decimal */
+    if (number != 0)
+    {
+      Agent_Send(NAK);
+      return;
+    }
+    if (AgentEnd)
+    {
+      /* Closing header, one file per download */
+      Agent_Send(ACK);
+      if (p_data[0] != 0)
+      {
+        Agent_Send(CA);
+        Agent_Send(CA);
+      }
+      AgentCheck = AgentStage + AGENT_STAGE_IMAGE_OFFSET;
+      AgentCheckCrc = 0xFFFFFFFFU;
+      AgentState = AGENT_CHECKING;
+      return;
+    }
+    for (i = 0; (i < FILE_NAME_LENGTH) && (p_data[i] != 0); i++)
+    {
+    }
+    for (i++; (i < AgentPacketSize) && (p_data[i] >= '0') && (p_data[i] <= '9'); i++)
+    {
+      size = (size * 10) + (p_data[i] - '0');
+    }
+    p_app = Agent_FindSlot(AGENT_PART_TYPE_APP);
+    if ((p_data[0] == 0) || (size == 0) || (size > (AgentStageSize - AGENT_STAGE_IMAGE_OFFSET)) ||
+        (p_app == NULL) || (size > p_app->size))
+    {
+      Agent_Fail();
+      return;
+    }
+    AgentSize = size;
+    AgentLeft = size;
+    AgentBlock = 1;
+    Agent_Send(ACK);
+    Agent_Send(CRC16);
+  }
+  else if (number == (AgentBlock & 0xFFU))
+  {
+    /* Programmed whole doublewords, the padding after the file as erased */
+    length = (AgentPacketSize < AgentLeft) ? AgentPacketSize : AgentLeft;
+    AgentCrc = pAgentSvc->Crc32(AgentCrc, p_data, length);
+    AgentLeft -= length;
+    AgentStats.bytes += length;
+    AgentWork = (length + 7U) & ~7U;
+    memset(&p_data[length], 0xFF, AgentWork - length);
+    pAgentSrc = p_data;
+    AgentBlock++;
+    if (AgentWork == 0)
+    {
+      Agent_Send(ACK);
+    }
+  }
+  else if (number == ((AgentBlock - 1) & 0xFFU))
+  {
+    /* Our ACK was lost */
+    Agent_Send(ACK);
+  }
+  else
+  {
+    Agent_Fail();
+  }
+}
+
+/**
+  * @brief  Take in the bytes received, up to the end of one packet
+  * @param  None
+  * @retval None
+  */
+static void Agent_Receive(void)
+{
+  uint8_t *p_packet = (uint8_t *)aAgentPacket;
+  uint8_t byte;
+
+  while (AgentRingTail != AgentRingHead)
+  {
+    byte = aAgentRing[AgentRingTail & (AGENT_RX_RING_SIZE - 1)];
+    AgentRingTail++;
+    AgentLastByte = HAL_GetTick();
+
+    if (AgentFill != 0)
+    {
+      p_packet[PACKET_START_INDEX + AgentFill] = byte;
+      AgentFill++;
+      if (AgentFill == (PACKET_HEADER_SIZE + AgentPacketSize + PACKET_TRAILER_SIZE))
+      {
+        AgentFill = 0;
+        Agent_Packet();
+        return;
+      }
+      continue;
+    }
+
+    switch (byte)
+    {
+      case SOH:
+      case STX:
+        AgentPacketSize = (byte == SOH) ? PACKET_SIZE : PACKET_1K_SIZE;
+        p_packet[PACKET_START_INDEX] = byte;
+        AgentFill = 1;
+        break;
+      case EOT:
+        if ((AgentSize == 0) || (AgentLeft != 0))
+        {
+          Agent_Fail();
+          return;
+        }
+        AgentEnd = 1;
+        Agent_Send(ACK);
+        Agent_Send(CRC16);
+        break;
+      case CA:
+        if (AgentCancel)
+        {
+          AgentState = AGENT_ERROR;
+          return;
+        }
+        break;
+      default:
+        /* Noise between packets */
+        break;
+    }
+    AgentCancel = (byte == CA);
+  }
+
+  /* Silence: the packet is dropped and asked again */
+  if ((HAL_GetTick() - AgentLastByte) > AGENT_TIMEOUT)
+  {
+    AgentLastByte = HAL_GetTick();
+    AgentFill = 0;
+    if (++AgentRetries > AGENT_MAX_RETRIES)
+    {
+      Agent_Fail();
+    }
+    else
+    {
+      Agent_Send(((AgentSize == 0) || AgentEnd) ? CRC16 : NAK);
+    }
+  }
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Start listening for AGENT_START_KEY
+  * @note   The UART must be initialised, its interrupt handler must call
+  *         Agent_IRQHandler. TIM6 is taken as the time base of the
+  *         statistics. A bootloader without the services of SVC_VERSION
+  *         leaves the agent in AGENT_ERROR at each AGENT_START_KEY.
+  * @param  p_huart: UART of the downloads
+  * @retval None
+  */
+void Agent_Init(UART_HandleTypeDef *p_huart)
+{
+  AgentUart = p_huart;
+  AgentState = AGENT_IDLE;
+  pAgentSvc = NULL;
+  if ((SVC_TABLE->magic == SVC_MAGIC) && (SVC_TABLE->count >= SVC_COUNT))
+  {
+    pAgentSvc = SVC_TABLE;
+  }
+  AgentRingHead = 0;
+  AgentRingTail = 0;
+
+  /* APB prescaler 1: the timer runs on the core clock */
+  __HAL_RCC_TIM6_CLK_ENABLE();
+  AGENT_TIMER->PSC = (SystemCoreClock / 1000000U) - 1U;
+  AGENT_TIMER->ARR = 0xFFFFU;
+  AGENT_TIMER->EGR = TIM_EGR_UG;
+  AGENT_TIMER->CR1 = TIM_CR1_CEN;
+  AgentLoopLast = (uint16_t)AGENT_TIMER->CNT;
+
+  __HAL_UART_ENABLE_IT(p_huart, UART_IT_RXNE);
+}
+
+/**
+  * @brief  Receive interrupt, to call first in the UART interrupt handler
+  * @note   The errors are cleared here so that HAL_UART_IRQHandler does not
+  *         stop the reception.
+  * @param  None
+  * @retval None
+  */
+void Agent_IRQHandler(void)
+{
+  USART_TypeDef *p_usart;
+  uint32_t isr;
+  uint8_t byte;
+
+  if (AgentUart == NULL)
+  {
+    return;
+  }
+  p_usart = AgentUart->Instance;
+  isr = p_usart->ISR;
+  if (isr & (USART_ISR_ORE | USART_ISR_NE | USART_ISR_FE | USART_ISR_PE))
+  {
+    p_usart->ICR = USART_ICR_ORECF | USART_ICR_NECF | USART_ICR_FECF | USART_ICR_PECF;
+    AgentStats.rx_errors++;
+  }
+  if (isr & USART_ISR_RXNE_RXFNE)
+  {
+    byte = (uint8_t)p_usart->RDR;
+    if ((AgentRingHead - AgentRingTail) < AGENT_RX_RING_SIZE)
+    {
+      aAgentRing[AgentRingHead & (AGENT_RX_RING_SIZE - 1)] = byte;
+      AgentRingHead++;
+    }
+    else
+    {
+      AgentStats.rx_errors++;
+    }
+  }
+}
+
+/**
+  * @brief  Run one slice of the update, to call from the main loop
+  * @note   While a download runs, the time between calls and the time
+  *         spent in each are kept in the statistics. Gaps above 65 ms wrap
+  *         the timer; a page erase stalls the core for 40 ms at most.
+  * @param  None
+  * @retval None
+  */
+void Agent_Poll(void)
+{
+  uint16_t start = (uint16_t)AGENT_TIMER->CNT;
+  uint32_t elapsed, busy = (AgentState == AGENT_RECEIVING) || (AgentState == AGENT_CHECKING);
+  uint8_t byte;
+
+  if (busy)
+  {
+    elapsed = (uint16_t)(start - AgentLoopLast);
+    if (elapsed > AgentStats.loop_max)
+    {
+      AgentStats.loop_max = elapsed;
+    }
+    if (elapsed < AgentStats.loop_min)
+    {
+      AgentStats.loop_min = elapsed;
+    }
+  }
+  AgentLoopLast = start;
+
+  switch (AgentState)
+  {
+    case AGENT_RECEIVING:
+      if (AgentWork != 0)
+      {
+        Agent_Program();
+        AgentStats.slices++;
+      }
+      else
+      {
+        Agent_Receive();
+      }
+      break;
+    case AGENT_CHECKING:
+      Agent_ReadBack();
+      AgentStats.slices++;
+      break;
+    case AGENT_STAGED:
+      AgentRingTail = AgentRingHead;
+      break;
+    default:
+      while (AgentRingTail != AgentRingHead)
+      {
+        byte = aAgentRing[AgentRingTail++ & (AGENT_RX_RING_SIZE - 1)];
+        if (byte == AGENT_START_KEY)
+        {
+          Agent_Start();
+          break;
+        }
+        if (byte == AGENT_BOOT_KEY)
+        {
+          /* Download with the application stopped, the sender is waiting */
+          Boot_Request(BOOT_REQUEST_DOWNLOAD);
+        }
+      }
+      break;
+  }
+
+  if (busy)
+  {
+    elapsed = (uint16_t)((uint16_t)AGENT_TIMER->CNT - start);
+    if (elapsed > AgentStats.slice_max)
+    {
+      AgentStats.slice_max = elapsed;
+    }
+  }
+}
+
+/**
+  * @brief  Current state of the agent
+  * @param  None
+  * @retval Agent_StateTypeDef
+  */
+Agent_StateTypeDef Agent_GetState(void)
+{
+  return AgentState;
+}
+
+/**
+  * @brief  Statistics of the last download
+  * @param  None
+  * @retval Cleared when a download starts
+  */
+const Agent_StatsTypeDef *Agent_GetStats(void)
+{
+  return &AgentStats;
+}
+
+/**
+  * @brief  Reset into the bootloader, which installs the staged image
+  * @note   Does nothing unless the state is AGENT_STAGED.
+  * @param  None
+  * @retval None
+  */
+void Agent_Handoff(void)
+{
+  if (AgentState == AGENT_STAGED)
+  {
+    NVIC_SystemReset();
+  }
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,27 @@
+/**
+  ******************************************************************************
+  * @file    boot_select.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the boot decision
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_SELECT_H
+#define __BOOT_SELECT_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported constants --------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t BootSelect_Early(uint32_t request, GPIO_PinState key);
+uint32_t BootSelect_Image(uint32_t stack_pointer, uint32_t (*p_verify)(void));
+
+#endif  /* __BOOT_SELECT_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,75 @@
+/**
+  ******************************************************************************
+  * @file    boot_time.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the boot phase timing
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __BOOT_TIME_H
+#define __BOOT_TIME_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The record sits in the last 64 bytes of the RAM, left out of the RAM of
+ * both projects so neither start-up clears it. Shared with
+ * APPCore/Inc/boot_time.h. */
+#define BOOT_TIME_ADDRESS       ((uint32_t)0x20008FC0)
+#define BOOT_TIME_MAGIC         ((uint32_t)0x42504149) /* "IAPB" */
+#define BOOT_TIME_TIMER         TIM6  /* 1 MHz, 16 bits, extended by its interrupt */
+
+/* Inputs of the boot decision, the application is started with none */
+#define BOOT_INPUT_REQUEST      ((uint32_t)0x01)  /* Boot request from the application */
+#define BOOT_INPUT_KEY          ((uint32_t)0x02)  /* Key push-button pressed */
+#define BOOT_INPUT_NO_IMAGE     ((uint32_t)0x04)  /* No stack pointer in the application slot */
+#define BOOT_INPUT_UNVERIFIED   ((uint32_t)0x08)  /* Verify_Boot failed */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Boot phases, in their order
+  */
+typedef enum
+{
+  BOOT_PHASE_RESET = 0, /* Reset to main: C library start-up */
+  BOOT_PHASE_HAL,       /* HAL_Init */
+  BOOT_PHASE_GPIO,      /* MX_GPIO_Init */
+  BOOT_PHASE_KEY,       /* Partition table, boot request and key sampling */
+  BOOT_PHASE_CLOCK,     /* SystemClock_Config: PLL lock */
+  BOOT_PHASE_CHECK,     /* Staged update install and image check */
+  BOOT_PHASE_JUMP,      /* Jump to the main of the application, stamped by it */
+  BOOT_PHASE_NB
+} BootTime_PhaseTypeDef;
+
+/**
+  * @brief  Boot timing record, in RAM left out of the start-up
+  */
+typedef struct
+{
+  uint32_t magic;       /* BOOT_TIME_MAGIC once the bootloader jumped */
+  uint32_t stamp[BOOT_PHASE_NB]; /* us from reset to the end of each phase, 0 if skipped */
+  uint32_t inputs;      /* BOOT_INPUT_* seen by the decision */
+  uint32_t base;        /* us counted before the current timer period */
+  uint32_t jump_count;  /* BOOT_TIME_TIMER count at the jump */
+} BootTime_RecordTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+#define BOOT_TIME               ((BootTime_RecordTypeDef *)BOOT_TIME_ADDRESS)
+
+/* Exported functions ------------------------------------------------------- */
+void BootTime_Start(void);
+void BootTime_IRQHandler(void);
+void BootTime_Clock(void);
+void BootTime_Mark(BootTime_PhaseTypeDef phase);
+void BootTime_Input(uint32_t input);
+void BootTime_Jump(void);
+void BootTime_Stop(void);
+
+#endif  /* __BOOT_TIME_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    chacha20.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the ChaCha20 functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __CHACHA20_H
+#define __CHACHA20_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define CHACHA20_KEY_SIZE       ((uint32_t)32)
+#define CHACHA20_NONCE_SIZE     ((uint32_t)12)
+#define CHACHA20_BLOCK_SIZE     ((uint32_t)64)
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Stream in progress
+  */
+typedef struct
+{
+  uint32_t input[16];                          /* Constants, key, block counter, nonce */
+  uint32_t keystream[CHACHA20_BLOCK_SIZE / 4]; /* Current block */
+  uint32_t used;                               /* Bytes of the block consumed */
+} Chacha20_CtxTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+void Chacha20_Init(Chacha20_CtxTypeDef *p_ctx, const uint8_t *p_key, const uint8_t *p_nonce, uint32_t counter);
+void Chacha20_Xor(Chacha20_CtxTypeDef *p_ctx, uint8_t *p_data, uint32_t length);
+#ifdef IAP_PROFILE
+uint32_t Chacha20_SelfTest(void);
+#endif /* IAP_PROFILE */
+
+#endif  /* __CHACHA20_H */
+
+/*******************************END OF FILE************************************/
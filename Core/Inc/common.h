@@ -48,6 +48,8 @@
 /* Constants used by Serial Command Line Mode */
 #define TX_TIMEOUT          ((uint32_t)100)
 #define RX_TIMEOUT          HAL_MAX_DELAY
+#define TX_RING_SIZE        ((uint32_t)1024) /* Console output ring, power of 2 */
+#define TX_RING_CHUNK       ((uint32_t)32)   /* Longest ring transfer: 2.8 ms at 115200 */
 
 /* Exported macro ------------------------------------------------------------*/
 #define IS_CAP_LETTER(c)    (((c) >= 'A') && ((c) <= 'F'))
@@ -63,8 +65,13 @@
 /* Exported functions ------------------------------------------------------- */
 void Int2Str(uint8_t *p_str, uint32_t intnum);
 uint32_t Str2Int(uint8_t *inputstr, uint32_t *intnum);
+uint32_t Serial_Enqueue(const uint8_t *p_data, uint32_t length);
+void Serial_PutData(const uint8_t *p_data, uint32_t length);
 void Serial_PutString(uint8_t *p_string);
 HAL_StatusTypeDef Serial_PutByte(uint8_t param);
+HAL_StatusTypeDef Serial_PutFrame(uint8_t *p_frame, uint16_t length);
+void Serial_WaitTxDone(void);
+void Serial_Flush(void);
 
 #endif  /* __COMMON_H */
 
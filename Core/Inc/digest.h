@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file    digest.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the flash digest functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __DIGEST_H
+#define __DIGEST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Algorithms, part of the DIGEST_REQUEST_KEY format: append only */
+#define DIGEST_ALGO_CRC32       ((uint8_t)0x01)  /* CRC-32 as zlib, 4 bytes LE */
+#define DIGEST_ALGO_SHA256      ((uint8_t)0x02)  /* SHA-256, 32 bytes */
+
+#define DIGEST_MAX_SIZE         ((uint32_t)32)
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t Digest_Size(uint8_t algorithm);
+void Digest_Compute(uint8_t algorithm, uint32_t start, uint32_t length, uint8_t *p_digest);
+uint32_t Digest_Crc32(uint32_t start, uint32_t length);
+
+#endif  /* __DIGEST_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,33 @@
+/**
+  ******************************************************************************
+  * @file    ed25519.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the Ed25519 signature
+  *          verification functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __ED25519_H
+#define __ED25519_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define ED25519_PUBLIC_KEY_SIZE ((uint32_t)32)
+#define ED25519_SIGNATURE_SIZE  ((uint32_t)64)
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t Ed25519_Verify(const uint8_t *p_signature, const uint8_t *p_public_key,
+                        const uint8_t *p_message, uint32_t length);
+#ifdef IAP_PROFILE
+uint32_t Ed25519_SelfTest(void);
+#endif /* IAP_PROFILE */
+
+#endif  /* __ED25519_H */
+
+/*******************************END OF FILE************************************/
@@ -71,14 +71,16 @@ enum {
 };
 
 /* Define the address from where user application will be loaded.
-   Note: this area is reserved for the IAP code                  */
+   Note: this area is reserved for the IAP code, 48 Kbytes: keep the IROM
+   size of BOOT_MDK-ARM and Tools/part_table.py BOOT_SIZE in step */
 #define FLASH_PAGE_STEP         FLASH_PAGE_SIZE           /* Size of page : 2 Kbytes */
-#define APPLICATION_ADDRESS     (uint32_t)0x08004000      /* Start user code address: ADDR_FLASH_PAGE_8 */
+#define APPLICATION_ADDRESS     (uint32_t)0x0800C000      /* Start user code address: ADDR_FLASH_PAGE_24 */
 
 /* Notable Flash addresses */
 #define FLASH_START_BANK1             ((uint32_t)0x08000000)
 #define WORDS_IN_HALF_PAGE            ((uint32_t)2)
 #define FLASH_HALF_PAGE_SIZE          ((uint32_t)WORDS_IN_HALF_PAGE*4)
+#define FLASH_ROW_SIZE                ((uint32_t)256)  /* 32 doublewords, one fast programming operation */
 #define FLASH_LAST_SECTOR_BANK1       ((uint32_t)0x08017000)
 #define FLASH_LAST_PAGE_BANK1         ((uint32_t)0x08017F00)
 #define FLASH_END_BANK1               ((uint32_t)0x08017FFF)
@@ -87,7 +89,15 @@ enum {
 #define FLASH_BANK1_MASK              ((uint32_t)0xF0FFFFFF)
 
 /* Define the user application size */
-#define USER_FLASH_SIZE               ((uint32_t)0x00013000) /* Small default template application */
+#define USER_FLASH_SIZE               ((uint32_t)0x0000B000) /* Application slot, up to the calibration data */
+
+/* Data regions after the application, each one erased on its own. The last
+   two pages of the Flash hold the download journal and the partition table. */
+#define CALIBRATION_ADDRESS           ((uint32_t)0x08017000)
+#define CALIBRATION_SIZE              ((uint32_t)0x00001000)
+#define RESOURCE_ADDRESS              ((uint32_t)0x08018000)
+#define RESOURCE_SIZE                 ((uint32_t)0x00007000)
+#define JOURNAL_ADDRESS               ((uint32_t)0x0801F000)
 
 
 /* Exported macro ------------------------------------------------------------*/
@@ -103,8 +113,15 @@ enum {
 /* Exported functions ------------------------------------------------------- */
 void FLASH_If_Init(void);
 uint32_t FLASH_If_Erase(uint32_t StartSector);
+uint32_t FLASH_If_EraseRange(uint32_t start, uint32_t length);
 //uint32_t FLASH_If_GetWriteProtectionStatus(void);
 uint32_t FLASH_If_Write(uint32_t destination, uint32_t *p_source, uint32_t length);
+uint32_t FLASH_If_IsErased(uint32_t start, uint32_t length);
+uint32_t FLASH_If_GetImageSize(uint32_t start, uint32_t size);
+void FLASH_If_StreamOpen(uint32_t destination);
+uint32_t FLASH_If_StreamWrite(const uint8_t *p_data, uint32_t length);
+uint32_t FLASH_If_StreamFlush(void);
+uint32_t FLASH_If_StreamClose(void);
 //uint32_t FLASH_If_WriteProtectionConfig(uint32_t protectionstate);
 
 #endif  /* __FLASH_IF_H */
@@ -0,0 +1,39 @@
+/**
+  ******************************************************************************
+  * @file    journal.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the download progress
+  *          journal functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __JOURNAL_H
+#define __JOURNAL_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Record tags, in the top byte of the second word: never 0xFF so that a
+ * record can not read as erased Flash */
+#define JOURNAL_TAG_IMAGE       ((uint32_t)0x01) /* w0: size, w1: slot type, header CRC16 */
+#define JOURNAL_TAG_PROGRESS    ((uint32_t)0x02) /* w0: bytes programmed and verified */
+#define JOURNAL_TAG_DONE        ((uint32_t)0x03) /* Image complete, nothing to resume */
+#define JOURNAL_TAG_VERIFIED    ((uint32_t)0x04) /* w0: CRC-32 of the checked app, w1: its size */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+uint32_t Journal_Open(uint8_t type, uint32_t size, uint16_t header_crc);
+void Journal_Progress(uint32_t offset);
+void Journal_Rewind(uint32_t offset);
+void Journal_Close(void);
+void Journal_Invalidate(void);
+void Journal_Verified(uint32_t size, uint32_t crc);
+uint32_t Journal_GetVerified(uint32_t *p_size, uint32_t *p_crc);
+
+#endif  /* __JOURNAL_H */
+
+/*******************************END OF FILE************************************/
@@ -42,7 +42,11 @@ extern "C" {
 
 /* Exported constants --------------------------------------------------------*/
 /* USER CODE BEGIN EC */
-
+/* Boot request: the application writes one of these to TAMP->BKP0R then
+ * resets (APPCore/Inc/boot_request.h). The backup register keeps it across
+ * the reset, the bootloader clears it. */
+#define BOOT_REQUEST_MENU       ((uint32_t)0x52504149) /* "IAPR": main menu */
+#define BOOT_REQUEST_DOWNLOAD   ((uint32_t)0x57504149) /* "IAPW": YMODEM download at once */
 /* USER CODE END EC */
 
 /* Exported macro ------------------------------------------------------------*/
@@ -0,0 +1,66 @@
+/**
+  ******************************************************************************
+  * @file    manifest.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the page manifest functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __MANIFEST_H
+#define __MANIFEST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+#include "ed25519.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define MANIFEST_MAGIC          ((uint32_t)0x4D504149) /* "IAPM" */
+#define MANIFEST_VERSION        ((uint8_t)1)
+#define MANIFEST_HEADER_SIZE    ((uint32_t)80)
+#define MANIFEST_ALIGN          ((uint32_t)1024)       /* Padded with 0xFF to whole 1K blocks */
+#define MANIFEST_PAGE_RETRIES   ((uint32_t)2)          /* Requests of a block completing a bad page */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Start of the manifest, little endian, followed by the SHA-256 leaf
+  *         of each Flash page of the image: SHA-256(0x00 | page). Inner
+  *         nodes are SHA-256(0x01 | left | right), an odd node goes up as
+  *         is. The signature covers the first 16 bytes, then the root.
+  */
+typedef struct
+{
+  uint32_t magic;                                /* MANIFEST_MAGIC */
+  uint8_t  version;                              /* MANIFEST_VERSION */
+  uint8_t  reserved;
+  uint16_t leaves;                               /* Pages of the image */
+  uint32_t length;                               /* Image bytes after the manifest */
+  uint32_t reserved2;
+  uint8_t  signature[ED25519_SIGNATURE_SIZE];    /* Made with the key of verify.c */
+} Manifest_HeaderTypeDef;
+
+/**
+  * @brief  Manifest reception result
+  */
+typedef enum
+{
+  MANIFEST_MORE = 0,    /* Waiting for the next block of the manifest */
+  MANIFEST_DONE,        /* Received and signature checked */
+  MANIFEST_FORMAT,      /* Not a manifest, or not for this Flash */
+  MANIFEST_SIGNATURE    /* Root not signed with the key of the images */
+} Manifest_StatusTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+void Manifest_Start(void);
+Manifest_StatusTypeDef Manifest_Receive(const uint8_t *p_data, uint32_t length);
+uint32_t Manifest_Size(void);
+uint32_t Manifest_ImageLength(void);
+uint32_t Manifest_CheckFlash(uint32_t start, uint32_t length);
+uint32_t Manifest_CheckBlock(uint32_t offset, const uint8_t *p_data, uint32_t length);
+uint32_t Manifest_Verified(void);
+
+#endif  /* __MANIFEST_H */
+
+/*******************************END OF FILE************************************/
@@ -42,18 +42,38 @@
 /* Includes ------------------------------------------------------------------*/
 #include "flash_if.h"
 #include "ymodem.h"
+#include "sha256.h"
 
 /* Imported variables --------------------------------------------------------*/
 extern uint8_t aFileName[FILE_NAME_LENGTH];
+extern uint8_t aFileDigest[SHA256_DIGEST_SIZE];
 
 /* Private variables ---------------------------------------------------------*/
 typedef  void (*pFunction)(void);
 
 /* Exported types ------------------------------------------------------------*/
 /* Exported constants --------------------------------------------------------*/
+#define MENU_KEY_TIMEOUT        ((uint32_t)1000) /* Download starts if no key is pressed in time */
+#define SESSION_QUERY_TIMEOUT   ((uint32_t)500)  /* Window for host queries after a download */
+#define SPARSE_REQUEST_KEY      ((uint8_t)'S')   /* Sent ahead of 'C' to upload the sparse form */
+#define IDLE_AHB_DIVIDER        RCC_SYSCLK_DIV8  /* Core clock while waiting for the host */
+
+/* Flash digest: the key, then algorithm, flags, 2 reserved bytes, start
+ * address and length (LE 32-bit). The answer is the DIGEST_MAGIC frame. */
+#define DIGEST_REQUEST_KEY      ((uint8_t)'D')
+#define DIGEST_REQUEST_SIZE     ((uint32_t)12)
+#define DIGEST_MAGIC            ((uint32_t)0x44504149) /* "IAPD" */
+#define DIGEST_VERSION          ((uint8_t)1)
+#define DIGEST_FLAG_PAGES       ((uint8_t)0x01)  /* Add the digest of each Flash page of the range */
+#define DIGEST_STATUS_OK        ((uint8_t)0)
+#define DIGEST_STATUS_RANGE     ((uint8_t)1)     /* Range not inside the Flash */
+#define DIGEST_STATUS_ALGO      ((uint8_t)2)     /* Algorithm not supported */
+
 /* Exported macro ------------------------------------------------------------*/
 /* Exported functions ------------------------------------------------------- */
 void Main_Menu(void);
+void Main_Download(void);
+void Main_IdleClock(uint32_t idle);
 
 #endif  /* __MENU_H */
 
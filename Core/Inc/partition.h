@@ -0,0 +1,77 @@
+/**
+  ******************************************************************************
+  * @file    partition.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the flash partition table
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PARTITION_H
+#define __PARTITION_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define PART_TABLE_ADDRESS      ((uint32_t)0x0801F800) /* Last Flash page */
+#define PART_MAGIC              ((uint32_t)0x50504149) /* "IAPP" */
+#define PART_VERSION            ((uint8_t)1)
+#define PART_MAX_SLOTS          ((uint32_t)8)
+
+/* Slot flags */
+#define PART_FLAG_READONLY      ((uint8_t)0x01)  /* Never erased nor written by the IAP */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Slot types, part of the stored format: append only
+  */
+typedef enum
+{
+  PART_TYPE_BOOT        = 0x01,
+  PART_TYPE_APP         = 0x02,
+  PART_TYPE_CALIBRATION = 0x03,
+  PART_TYPE_RESOURCE    = 0x04,
+  PART_TYPE_TABLE       = 0x05,
+  PART_TYPE_JOURNAL     = 0x06,
+  PART_TYPE_STAGING     = 0x07   /* Update written by the running application */
+} Part_TypeTypeDef;
+
+/**
+  * @brief  One slot, 12 bytes, little endian in Flash
+  */
+typedef struct
+{
+  uint32_t offset;      /* From FLASH_BASE, page aligned */
+  uint32_t size;        /* Multiple of FLASH_PAGE_SIZE */
+  uint8_t  type;        /* Part_TypeTypeDef */
+  uint8_t  flags;       /* PART_FLAG_xxx */
+  uint16_t reserved;
+} Part_SlotTypeDef;
+
+/**
+  * @brief  Table stored at PART_TABLE_ADDRESS
+  */
+typedef struct
+{
+  uint32_t magic;       /* PART_MAGIC */
+  uint8_t  version;     /* PART_VERSION */
+  uint8_t  count;       /* Slots in use */
+  uint16_t crc;         /* CRC16-XMODEM of the slots in use */
+  Part_SlotTypeDef slot[PART_MAX_SLOTS];
+} Part_TableTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+void Part_Init(void);
+uint32_t Part_IsDefault(void);
+const Part_SlotTypeDef *Part_Find(Part_TypeTypeDef type);
+uint32_t Part_Address(Part_TypeTypeDef type);
+uint32_t Part_Size(Part_TypeTypeDef type);
+uint32_t Part_IsWritable(uint32_t start, uint32_t length);
+
+#endif  /* __PARTITION_H */
+
+/*******************************END OF FILE************************************/
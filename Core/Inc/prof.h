@@ -0,0 +1,95 @@
+/**
+  ******************************************************************************
+  * @file    prof.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the hot-path profiling
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __PROF_H
+#define __PROF_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Uncomment to build the profiling probes in, they compile out otherwise */
+/* #define IAP_PROFILE */
+
+#define PROF_HIST_BUCKETS       ((uint32_t)8)
+#define PROF_HIST_BASE          ((uint32_t)256)  /* Upper bound of bucket 0, in core cycles */
+#define PROF_HIST_SHIFT         ((uint32_t)2)    /* Each further bucket is 4 times wider */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Profiled phases
+  */
+typedef enum
+{
+  PROF_RX_WAIT = 0,     /* ReceivePacket: waiting for the start byte */
+  PROF_RX_XFER,         /* ReceivePacket: receiving the packet body */
+  PROF_CRC,             /* HAL_CRC_Calculate over a packet */
+  PROF_ERASE,           /* FLASH_If_Erase */
+  PROF_WRITE,           /* FLASH_If_Write of one block */
+  PROF_ACK,             /* End of a packet or EOT to its ACK or NAK being sent */
+  PROF_TX,              /* Ymodem_Transmit: sending one packet */
+  PROF_HASH,            /* Sha256_Update over a received block */
+  PROF_DECRYPT,         /* Chacha20_Xor over a received block */
+  PROF_NB
+} Prof_IdTypeDef;
+
+/**
+  * @brief  Statistics of one phase, all times in core cycles
+  */
+typedef struct
+{
+  uint32_t count;
+  uint32_t min;
+  uint32_t max;
+  uint64_t sum;
+  uint32_t hist[PROF_HIST_BUCKETS];
+} Prof_EntryTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef IAP_PROFILE
+#define PROF_START(id)          (Prof_StartStamp[(id)] = Prof_Now())
+#define PROF_STOP(id)           Prof_Record((id), Prof_Now() - Prof_StartStamp[(id)])
+#else
+#define PROF_START(id)          ((void)0)
+#define PROF_STOP(id)           ((void)0)
+#endif /* IAP_PROFILE */
+
+/* Exported variables --------------------------------------------------------*/
+extern uint32_t Prof_StartStamp[PROF_NB];
+
+/* Exported functions ------------------------------------------------------- */
+/**
+  * @brief  Free-running core cycle count built from uwTick and SysTick
+  * @note   Cortex-M0+ has no DWT cycle counter. uwTick is read twice so a
+  *         SysTick reload between the two reads cannot tear the result.
+  * @retval Core cycles since HAL_Init, wrapping at 32 bits
+  */
+__STATIC_INLINE uint32_t Prof_Now(void)
+{
+  uint32_t ms, val;
+
+  do
+  {
+    ms = uwTick;
+    val = SysTick->VAL;
+  } while (ms != uwTick);
+
+  return ms * (SysTick->LOAD + 1) + (SysTick->LOAD - val);
+}
+
+void Prof_Reset(void);
+void Prof_Record(Prof_IdTypeDef id, uint32_t cycles);
+void Prof_Dump(void);
+
+#endif  /* __PROF_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,61 @@
+/**
+  ******************************************************************************
+  * @file    rpc.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the binary command protocol
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __RPC_H
+#define __RPC_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Binary command protocol, entered with RPC_REQUEST_KEY from the main menu
+ * (Tools/flash_rpc.py). Each frame is COBS encoded and ends with a 0x00.
+ * Decoded, a request is the command, 0, its id (LE 16-bit), the arguments
+ * and the CRC-32 (zlib, LE) of all previous bytes. The answer carries the
+ * command | RPC_REPLY, a status, the same id, the results and a CRC-32.
+ * Requests are served in order, a host may keep several outstanding as long
+ * as they fit in RX_RING_SIZE. Frames with a bad CRC are dropped: the host
+ * sends them again after a timeout, a WRITE repeated reports RPC_OK. */
+#define RPC_REQUEST_KEY         ((uint8_t)'R')
+#define RPC_VERSION             ((uint8_t)1)
+#define RPC_IDLE_TIMEOUT        ((uint32_t)10000) /* ms without a byte, back to the menu */
+#define RPC_HEADER_SIZE         ((uint32_t)4)
+#define RPC_CRC_SIZE            ((uint32_t)4)
+#define RPC_MAX_DATA            ((uint32_t)1024)  /* WRITE and READ data */
+#define RPC_MAX_PAYLOAD         (RPC_HEADER_SIZE + 4 + RPC_MAX_DATA + RPC_CRC_SIZE)
+#define RPC_MAX_FRAME           (RPC_MAX_PAYLOAD + RPC_MAX_PAYLOAD / 254 + 2)
+#define RPC_REPLY               ((uint8_t)0x80)
+
+/* Commands, arguments -> results (LE). Addresses are inside the slots listed
+ * by RPC_CMD_GETINFO: application, calibration and resource. */
+#define RPC_CMD_GETINFO         ((uint8_t)0x01) /* -> version, slot count, RPC_MAX_DATA (16-bit), page size,
+                                                      RX_RING_SIZE, {type, 3 reserved, address, size} per slot */
+#define RPC_CMD_ERASE           ((uint8_t)0x02) /* start (page aligned), length -> */
+#define RPC_CMD_WRITE           ((uint8_t)0x03) /* address (8 aligned), data (multiple of 8) -> */
+#define RPC_CMD_READ            ((uint8_t)0x04) /* address, length -> data */
+#define RPC_CMD_DIGEST          ((uint8_t)0x05) /* start, length, algorithm, 3 reserved -> digest, see digest.h */
+#define RPC_CMD_JUMP            ((uint8_t)0x06) /* -> ; then restart, the application starts if it checks */
+
+/* Status */
+#define RPC_STATUS_OK           ((uint8_t)0)
+#define RPC_STATUS_COMMAND      ((uint8_t)1)     /* Unknown command */
+#define RPC_STATUS_LENGTH       ((uint8_t)2)     /* Arguments too short or too long */
+#define RPC_STATUS_RANGE        ((uint8_t)3)     /* Outside the slots, or not aligned */
+#define RPC_STATUS_FLASH        ((uint8_t)4)     /* Erase or program failed, or not erased */
+
+/* Exported types ------------------------------------------------------------*/
+/* Exported functions ------------------------------------------------------- */
+void Rpc_Serve(void);
+
+#endif  /* __RPC_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,31 @@
+/**
+  ******************************************************************************
+  * @file    serial_rx.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the interrupt driven
+  *          serial receive functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SERIAL_RX_H
+#define __SERIAL_RX_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define RX_RING_SIZE            ((uint32_t)2048) /* Power of 2, above one 1K packet */
+
+/* Exported functions ------------------------------------------------------- */
+void Serial_RxStart(void);
+void Serial_RxIRQHandler(void);
+HAL_StatusTypeDef Serial_Receive(uint8_t *p_data, uint32_t size, uint32_t timeout);
+void Serial_RxFlush(void);
+uint32_t Serial_RxSleepTime(void);
+
+#endif  /* __SERIAL_RX_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,44 @@
+/**
+  ******************************************************************************
+  * @file    sha256.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the SHA-256 functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SHA256_H
+#define __SHA256_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SHA256_BLOCK_SIZE       ((uint32_t)64)
+#define SHA256_DIGEST_SIZE      ((uint32_t)32)
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Hash in progress
+  */
+typedef struct
+{
+  uint32_t state[8];
+  uint32_t length;                       /* Bytes hashed, messages below 4GB */
+  uint8_t  buffer[SHA256_BLOCK_SIZE];    /* Partial block */
+} Sha256_CtxTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+void Sha256_Init(Sha256_CtxTypeDef *p_ctx);
+void Sha256_Update(Sha256_CtxTypeDef *p_ctx, const uint8_t *p_data, uint32_t length);
+void Sha256_Final(Sha256_CtxTypeDef *p_ctx, uint8_t *p_digest);
+void Sha256(const uint8_t *p_data, uint32_t length, uint8_t *p_digest);
+#ifdef IAP_PROFILE
+uint32_t Sha256_SelfTest(void);
+#endif /* IAP_PROFILE */
+
+#endif  /* __SHA256_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,40 @@
+/**
+  ******************************************************************************
+  * @file    sha512.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the SHA-512 functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __SHA512_H
+#define __SHA512_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+#define SHA512_BLOCK_SIZE       ((uint32_t)128)
+#define SHA512_DIGEST_SIZE      ((uint32_t)64)
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Hash in progress
+  */
+typedef struct
+{
+  uint64_t state[8];
+  uint32_t length;                       /* Bytes hashed, messages below 4GB */
+  uint8_t  buffer[SHA512_BLOCK_SIZE];    /* Partial block */
+} Sha512_CtxTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+void Sha512_Init(Sha512_CtxTypeDef *p_ctx);
+void Sha512_Update(Sha512_CtxTypeDef *p_ctx, const uint8_t *p_data, uint32_t length);
+void Sha512_Final(Sha512_CtxTypeDef *p_ctx, uint8_t *p_digest);
+
+#endif  /* __SHA512_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,43 @@
+/**
+  ******************************************************************************
+  * @file    stage.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the staged update install
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __STAGE_H
+#define __STAGE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* The first page of the staging slot holds the header, the image starts on
+ * the next page. Shared with APPCore/Inc/update_agent.h. */
+#define STAGE_MAGIC             ((uint32_t)0x55504149) /* "IAPU" */
+#define STAGE_IMAGE_OFFSET      FLASH_PAGE_SIZE
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Written by the application once the staged image is checked: the
+  *         magic is in the last doubleword, programmed last
+  */
+typedef struct
+{
+  uint32_t length;      /* Image bytes */
+  uint32_t crc;         /* CRC-32 (zlib) of the image */
+  uint32_t reserved;
+  uint32_t magic;       /* STAGE_MAGIC */
+} Stage_HeaderTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+uint32_t Stage_Install(void);
+
+#endif  /* __STAGE_H */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,87 @@
+/**
+  ******************************************************************************
+  * @file    trace.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the binary event trace
+  *          functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __TRACE_H
+#define __TRACE_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Uncomment to record the event trace, the trace points compile out otherwise */
+/* #define IAP_TRACE */
+
+#define TRACE_DEPTH             ((uint32_t)256)  /* Events kept, must be a power of 2 */
+#define TRACE_MAGIC             ((uint32_t)0x54504149) /* "IAPT" */
+#define TRACE_VERSION           ((uint8_t)1)
+#define TRACE_EXPORT_KEY        ((uint8_t)'T')   /* Host request for the trace blob */
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Trace event codes, part of the export format: append only
+  */
+typedef enum
+{
+  TRACE_SESSION_BEGIN = 0x01, /* arg16: none */
+  TRACE_SESSION_END   = 0x02, /* arg8: COM_StatusTypeDef */
+  TRACE_PKT_START     = 0x10, /* arg8: start byte */
+  TRACE_HDR_OK        = 0x11, /* arg8: packet number, arg16: packet size */
+  TRACE_SEQ_FAIL      = 0x12, /* arg8: packet number */
+  TRACE_CRC_OK        = 0x13, /* arg8: packet number */
+  TRACE_CRC_FAIL      = 0x14, /* arg8: packet number */
+  TRACE_TIMEOUT       = 0x15, /* arg16: timeout in ms */
+  TRACE_ERASE_BEGIN   = 0x20,
+  TRACE_ERASE_END     = 0x21, /* arg8: FLASHIF status */
+  TRACE_PROG_BEGIN    = 0x22, /* arg8: packet number, arg16: length */
+  TRACE_PROG_END      = 0x23, /* arg8: FLASHIF status */
+  TRACE_TX_CTRL       = 0x30  /* arg8: control byte sent (ACK, NAK, 'C', CA, EOT) */
+} Trace_EventTypeDef;
+
+/**
+  * @brief  One trace record, 8 bytes, little endian in the export
+  */
+typedef struct
+{
+  uint32_t stamp;       /* Core cycles, see Prof_Now() */
+  uint8_t  event;       /* Trace_EventTypeDef */
+  uint8_t  arg8;
+  uint16_t arg16;
+} Trace_RecordTypeDef;
+
+/**
+  * @brief  Export header sent ahead of the records
+  */
+typedef struct
+{
+  uint32_t magic;       /* TRACE_MAGIC */
+  uint8_t  version;     /* TRACE_VERSION */
+  uint8_t  record_size; /* sizeof(Trace_RecordTypeDef) */
+  uint16_t count;       /* Records that follow, oldest first */
+  uint32_t clock_hz;    /* Stamp frequency */
+  uint32_t dropped;     /* Records overwritten since the session began */
+} Trace_HeaderTypeDef;
+
+/* Exported macro ------------------------------------------------------------*/
+#ifdef IAP_TRACE
+#define TRACE_EVENT(event, arg8, arg16)  Trace_Record((event), (uint8_t)(arg8), (uint16_t)(arg16))
+#else
+#define TRACE_EVENT(event, arg8, arg16)  ((void)(arg8), (void)(arg16))
+#endif /* IAP_TRACE */
+
+/* Exported functions ------------------------------------------------------- */
+void Trace_Reset(void);
+void Trace_Record(Trace_EventTypeDef event, uint8_t arg8, uint16_t arg16);
+void Trace_Export(void);
+
+#endif  /* __TRACE_H */
+
+/*******************************END OF FILE************************************/
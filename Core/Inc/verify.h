@@ -0,0 +1,47 @@
+/**
+  ******************************************************************************
+  * @file    verify.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides all the headers of the signed image functions.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __VERIFY_H
+#define __VERIFY_H
+
+/* Includes ------------------------------------------------------------------*/
+#include "stm32g0xx_hal.h"
+#include "ed25519.h"
+
+/* Exported constants --------------------------------------------------------*/
+/* Comment out to accept and start unsigned applications. Needs the key
+ * header made by Tools/sign_image.py keygen, see verify.c. */
+#define IAP_SIGNED_IMAGES
+
+#define VERIFY_TRAILER_MAGIC    ((uint32_t)0x47504149) /* "IAPG" */
+#define VERIFY_TRAILER_SIZE     ((uint32_t)72)
+
+/* Exported types ------------------------------------------------------------*/
+/**
+  * @brief  Appended to a signed application by Tools/sign_image.py, after
+  *         padding the image to a doubleword: little endian, the last
+  *         doubleword of the image is never erased Flash
+  */
+typedef struct
+{
+  uint8_t  signature[ED25519_SIGNATURE_SIZE];  /* Ed25519 of the SHA-256 of the image */
+  uint32_t length;                             /* Image bytes before the trailer */
+  uint32_t magic;                              /* VERIFY_TRAILER_MAGIC */
+} Verify_TrailerTypeDef;
+
+/* Exported functions ------------------------------------------------------- */
+uint32_t Verify_Signature(const uint8_t *p_signature, const uint8_t *p_message, uint32_t length);
+uint32_t Verify_Image(uint32_t start, uint32_t size, const uint8_t *p_digest);
+uint32_t Verify_Boot(void);
+
+#endif  /* __VERIFY_H */
+
+/*******************************END OF FILE************************************/
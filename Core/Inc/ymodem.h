@@ -28,6 +28,8 @@
 #define __YMODEM_H_
 
 /* Includes ------------------------------------------------------------------*/
+#include "ymodem_packet.h"
+
 /* Exported types ------------------------------------------------------------*/
 
 /**
@@ -35,47 +37,40 @@
   */
 typedef enum
 {
-  COM_OK       = 0x00,
-  COM_ERROR    = 0x01,
-  COM_ABORT    = 0x02,
-  COM_TIMEOUT  = 0x03,
-  COM_DATA     = 0x04,
-  COM_LIMIT    = 0x05
+  COM_OK        = 0x00,
+  COM_ERROR     = 0x01,
+  COM_ABORT     = 0x02,
+  COM_TIMEOUT   = 0x03,
+  COM_DATA      = 0x04,
+  COM_LIMIT     = 0x05,
+  COM_SIGNATURE = 0x06
 } COM_StatusTypeDef;
 /**
   * @}
   */
 
+/**
+  * @brief  Download session statistics, filled by Ymodem_Receive
+  * @note   Part of the STATS_QUERY_KEY export format: append only
+  */
+typedef struct
+{
+  uint32_t total_time;        /* ms, header packet to end of session */
+  uint32_t first_block_time;  /* ms, header packet to first data packet */
+  uint32_t blocks;            /* data blocks programmed */
+  uint32_t retransmits;       /* resend requests sent plus duplicate blocks received */
+  uint32_t crc_errors;        /* frames failing the sequence or CRC check */
+  uint32_t timeouts;          /* waits that expired once the session began */
+  uint32_t bytes_programmed;
+  uint32_t erase_time;        /* ms spent in FLASH_If_Erase */
+  uint32_t program_time;      /* ms spent in FLASH_If_Write */
+  uint32_t throughput;        /* bytes programmed per second of total_time */
+  uint32_t sleep_time;        /* ms asleep waiting for bytes during total_time */
+  uint32_t sleep_ratio;       /* per mille of total_time asleep, the current proxy */
+} COM_StatsTypeDef;
+
 /* Exported constants --------------------------------------------------------*/
-/* Packet structure defines */
-#define PACKET_HEADER_SIZE      ((uint32_t)3)
-#define PACKET_DATA_INDEX       ((uint32_t)4)
-#define PACKET_START_INDEX      ((uint32_t)1)
-#define PACKET_NUMBER_INDEX     ((uint32_t)2)
-#define PACKET_CNUMBER_INDEX    ((uint32_t)3)
-#define PACKET_TRAILER_SIZE     ((uint32_t)2)
-#define PACKET_OVERHEAD_SIZE    (PACKET_HEADER_SIZE + PACKET_TRAILER_SIZE - 1)
-#define PACKET_SIZE             ((uint32_t)128)
-#define PACKET_1K_SIZE          ((uint32_t)1024)
-
-/* /-------- Packet in IAP memory ------------------------------------------\
- * | 0      |  1    |  2     |  3   |  4      | ... | n+4     | n+5  | n+6  | 
- * |------------------------------------------------------------------------|
- * | unused | start | number | !num | data[0] | ... | data[n] | crc0 | crc1 |
- * \------------------------------------------------------------------------/
- * the first byte is left unused for memory alignment reasons                 */
-
-#define FILE_NAME_LENGTH        ((uint32_t)64)
-#define FILE_SIZE_LENGTH        ((uint32_t)16)
-
-#define SOH                     ((uint8_t)0x01)  /* start of 128-byte data packet */
-#define STX                     ((uint8_t)0x02)  /* start of 1024-byte data packet */
-#define EOT                     ((uint8_t)0x04)  /* end of transmission */
-#define ACK                     ((uint8_t)0x06)  /* acknowledge */
-#define NAK                     ((uint8_t)0x15)  /* negative acknowledge */
-#define CA                      ((uint32_t)0x18) /* two of these in succession aborts transfer */
-#define CRC16                   ((uint8_t)0x43)  /* 'C' == 0x43, request 16-bit CRC */
-#define NEGATIVE_BYTE           ((uint8_t)0xFF)
+/* Packet layout and control bytes: Shared/Inc/ymodem_packet.h */
 
 #define ABORT1                  ((uint8_t)0x41)  /* 'A' == 0x41, abort by user */
 #define ABORT2                  ((uint8_t)0x61)  /* 'a' == 0x61, abort by user */
@@ -83,10 +78,61 @@ typedef enum
 #define NAK_TIMEOUT             ((uint32_t)0x100000)
 #define DOWNLOAD_TIMEOUT        ((uint32_t)1000) /* One second retry delay */
 #define MAX_ERRORS              ((uint32_t)5)
+#define RTO_MIN_TIMEOUT         ((uint32_t)100)   /* Lower bound of the adaptive retry timeout */
+#define RTO_MAX_TIMEOUT         ((uint32_t)10000) /* Upper bound, also used while the peer erases */
+#define RESYNC_IDLE_CHARS       ((uint32_t)16)   /* Idle gap closing a corrupted frame, in characters */
+#define UART_CHAR_BITS          ((uint32_t)10)   /* start + 8 data + stop bits */
+
+/* Binary statistics export: magic, version, size, COM_StatsTypeDef, CRC16 */
+#define STATS_QUERY_KEY         ((uint8_t)'S')
+#define STATS_MAGIC             ((uint32_t)0x53504149) /* "IAPS" */
+#define STATS_VERSION           ((uint8_t)1)
+
+/* Sparse upload file: magic, base address, image length (all LE 32-bit), then
+ * records of offset, length (LE 32-bit) and data for each run of pages that
+ * are not erased. Bytes not covered by a record read as 0xFF. */
+#define SPARSE_MAGIC            ((uint32_t)0x5A504149) /* "IAPZ" */
+#define SPARSE_HEADER_SIZE      ((uint32_t)12)
+#define SPARSE_RECORD_SIZE      ((uint32_t)8)
+
+/* Resumed download: after the header ACK the receiver sends RESUME_HINT and
+ * the LE 32-bit offset already programmed. Off by default, standard senders
+ * start over from block 1 and the blocks already programmed are compared. */
+/* #define YMODEM_RESUME_HINT */
+#define RESUME_HINT             ((uint8_t)0x12)
+
+/* Encrypted download: each file starts with a header block of magic, version,
+ * 3 reserved bytes, the 12-byte ChaCha20 nonce and 0xFF padding, then holds
+ * the image encrypted with the key of ymodem.c (Tools/encrypt_image.py). A
+ * whole 1K header keeps the image on the block grid. Off by default; the
+ * resume hint is not sent, the sender must not skip the header. */
+/* #define YMODEM_ENCRYPTED */
+#define ENCRYPT_MAGIC           ((uint32_t)0x45504149) /* "IAPE" */
+#define ENCRYPT_VERSION         ((uint8_t)1)
+#define ENCRYPT_HEADER_SIZE     PACKET_1K_SIZE
+
+/* Page manifest: each file starts with a signed hash tree of its Flash pages
+ * (see manifest.h, Tools/manifest_image.py), encrypted with the image when
+ * YMODEM_ENCRYPTED is set. A page is checked before its last block is
+ * programmed and that block is asked again when it does not match. Off by
+ * default; the resume hint is not sent, the sender must not skip it. */
+/* #define YMODEM_MANIFEST */
+
+/* XMODEM-CRC and XMODEM-1K senders give no header: a session starting with
+ * block 1 goes to the application slot. The image ends where the padding of
+ * the last block starts, 0x1A bytes are held back until more data follows
+ * them; the trailer of a signed image never ends with one. Not with
+ * YMODEM_ENCRYPTED or YMODEM_MANIFEST, both need the file size. */
+#if !defined(YMODEM_ENCRYPTED) && !defined(YMODEM_MANIFEST)
+#define YMODEM_XMODEM
+#endif
+#define XMODEM_PAD              ((uint8_t)0x1A)  /* CP/M end of file */
 
 /* Exported functions ------------------------------------------------------- */
-COM_StatusTypeDef Ymodem_Receive(uint64_t *p_size);
+COM_StatusTypeDef Ymodem_Receive(uint64_t *p_size, COM_StatsTypeDef *p_stats);
 COM_StatusTypeDef Ymodem_Transmit(uint8_t *p_buf, const uint8_t *p_file_name, uint64_t file_size);
+COM_StatusTypeDef Ymodem_TransmitSparse(uint8_t *p_buf, const uint8_t *p_file_name, uint32_t image_size);
+uint16_t UpdateCRC16(uint16_t crc_in, uint8_t byte);
 
 #endif  /* __YMODEM_H_ */
 
@@ -0,0 +1,81 @@
+/**
+  ******************************************************************************
+  * @file    boot_select.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the boot decision: main samples the boot
+  *          request, the Key push-button and the application slot, these
+  *          functions turn them into BOOT_INPUT_* flags. The application is
+  *          started when none is set.
+  *
+  *          No register is read here, so the decision is checked on the host
+  *          (Tools/host_tests/test_boot_select.c).
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_select.h"
+#include "boot_time.h"
+#include "main.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Inputs sampled before the clock is raised
+  * @note   A request from the application is taken before the key, which is
+  *         then not reported. Any other value of the backup register is
+  *         no request.
+  * @param  request: boot request left by the application
+  * @param  key: level of the Key push-button, GPIO_PIN_RESET when pressed
+  * @retval BOOT_INPUT_REQUEST, BOOT_INPUT_KEY or 0
+  */
+uint32_t BootSelect_Early(uint32_t request, GPIO_PinState key)
+{
+  if ((request == BOOT_REQUEST_MENU) || (request == BOOT_REQUEST_DOWNLOAD))
+  {
+    return BOOT_INPUT_REQUEST;
+  }
+  if (key == GPIO_PIN_RESET)
+  {
+    return BOOT_INPUT_KEY;
+  }
+  return 0;
+}
+
+/**
+  * @brief  Inputs of the application slot, once a staged update is installed
+  * @note   The signature is checked only when the first word of the slot is
+  *         a stack pointer in the RAM.
+  * @param  stack_pointer: first word of the application slot
+  * @param  p_verify: signature check, 1 if the image checks
+  * @retval BOOT_INPUT_NO_IMAGE, BOOT_INPUT_UNVERIFIED or 0
+  */
+uint32_t BootSelect_Image(uint32_t stack_pointer, uint32_t (*p_verify)(void))
+{
+  if ((stack_pointer & 0x2FFE0000) != 0x20000000)
+  {
+    return BOOT_INPUT_NO_IMAGE;
+  }
+  if (!p_verify())
+  {
+    return BOOT_INPUT_UNVERIFIED;
+  }
+  return 0;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
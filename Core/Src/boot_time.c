@@ -0,0 +1,193 @@
+/**
+  ******************************************************************************
+  * @file    boot_time.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the timing of the boot phases: BOOT_TIME_TIMER
+  *          is started from SystemInit, each phase stamps its end in us in
+  *          the BOOT_TIME record, which the application reads and reports.
+  *
+  *          BootTime_Start runs before the C library start-up: it only uses
+  *          the timer and the record, no variable.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "boot_time.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define BOOT_TIME_PERIOD        ((uint32_t)0x10000)  /* us per timer update */
+#define BOOT_TIME_PRIORITY      ((uint32_t)3)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t BootTime_Now(uint32_t *p_count);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Time since reset
+  * @note   An update not taken yet, interrupts masked or the interrupt not
+  *         enabled, is counted here: one period may go by unseen.
+  * @param  p_count: timer count of the result, or NULL
+  * @retval us since reset
+  */
+static uint32_t BootTime_Now(uint32_t *p_count)
+{
+  uint32_t primask = __get_PRIMASK(), base, count;
+
+  __disable_irq();
+  base = BOOT_TIME->base;
+  count = BOOT_TIME_TIMER->CNT;
+  if (BOOT_TIME_TIMER->SR & TIM_SR_UIF)
+  {
+    base += BOOT_TIME_PERIOD;
+    count = BOOT_TIME_TIMER->CNT;
+  }
+  __set_PRIMASK(primask);
+  if (p_count != NULL)
+  {
+    *p_count = count;
+  }
+  return base + count;
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Clear the record and start the timer, from SystemInit
+  * @note   The core runs on HSI16 out of reset, APB prescaler 1.
+  * @param  None
+  * @retval None
+  */
+void BootTime_Start(void)
+{
+  uint32_t i;
+
+  BOOT_TIME->magic = 0;
+  for (i = 0; i < BOOT_PHASE_NB; i++)
+  {
+    BOOT_TIME->stamp[i] = 0;
+  }
+  BOOT_TIME->inputs = 0;
+  BOOT_TIME->base = 0;
+  BOOT_TIME->jump_count = 0;
+
+  __HAL_RCC_TIM6_CLK_ENABLE();
+  BOOT_TIME_TIMER->PSC = (HSI_VALUE / 1000000U) - 1U;
+  BOOT_TIME_TIMER->ARR = 0xFFFFU;
+  /* Update only on overflow, UG loads PSC without an interrupt */
+  BOOT_TIME_TIMER->CR1 = TIM_CR1_URS;
+  BOOT_TIME_TIMER->EGR = TIM_EGR_UG;
+  BOOT_TIME_TIMER->DIER = TIM_DIER_UIE;
+  BOOT_TIME_TIMER->CR1 = TIM_CR1_URS | TIM_CR1_CEN;
+}
+
+/**
+  * @brief  Timer interrupt: count one more period
+  * @param  None
+  * @retval None
+  */
+void BootTime_IRQHandler(void)
+{
+  if (BOOT_TIME_TIMER->SR & TIM_SR_UIF)
+  {
+    BOOT_TIME_TIMER->SR = ~(uint32_t)TIM_SR_UIF;
+    BOOT_TIME->base += BOOT_TIME_PERIOD;
+  }
+}
+
+/**
+  * @brief  Keep 1 MHz after a change of the core clock
+  * @note   The count is folded into the base and the timer restarted on the
+  *         new prescaler. The few us from the clock switch to this call are
+  *         counted at the new rate.
+  * @param  None
+  * @retval None
+  */
+void BootTime_Clock(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  BOOT_TIME->base = BootTime_Now(NULL);
+  BOOT_TIME_TIMER->PSC = (SystemCoreClock / 1000000U) - 1U;
+  BOOT_TIME_TIMER->EGR = TIM_EGR_UG;
+  BOOT_TIME_TIMER->SR = ~(uint32_t)TIM_SR_UIF;
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Stamp the end of a phase
+  * @note   The end of BOOT_PHASE_RESET also takes the timer interrupt: call
+  *         it once the vector table is in SRAM.
+  * @param  phase: phase that ends
+  * @retval None
+  */
+void BootTime_Mark(BootTime_PhaseTypeDef phase)
+{
+  if (phase == BOOT_PHASE_RESET)
+  {
+    HAL_NVIC_SetPriority(TIM6_IRQn, BOOT_TIME_PRIORITY, 0);
+    HAL_NVIC_EnableIRQ(TIM6_IRQn);
+  }
+  BOOT_TIME->stamp[phase] = BootTime_Now(NULL);
+}
+
+/**
+  * @brief  Note an input of the boot decision
+  * @param  input: BOOT_INPUT_*
+  * @retval None
+  */
+void BootTime_Input(uint32_t input)
+{
+  BOOT_TIME->inputs |= input;
+}
+
+/**
+  * @brief  Hand the timer over to the application, interrupts masked
+  * @note   The timer keeps counting without its interrupt: the application
+  *         stamps BOOT_PHASE_JUMP from base and jump_count, first thing in
+  *         main before its clock changes.
+  * @param  None
+  * @retval None
+  */
+void BootTime_Jump(void)
+{
+  uint32_t count;
+
+  BOOT_TIME->base = BootTime_Now(&count);
+  BOOT_TIME->jump_count = count;
+  BOOT_TIME_TIMER->DIER = 0;
+  BOOT_TIME_TIMER->SR = ~(uint32_t)TIM_SR_UIF;
+  HAL_NVIC_DisableIRQ(TIM6_IRQn);
+  HAL_NVIC_ClearPendingIRQ(TIM6_IRQn);
+  BOOT_TIME->magic = BOOT_TIME_MAGIC;
+}
+
+/**
+  * @brief  Stop the timer, the bootloader stays
+  * @param  None
+  * @retval None
+  */
+void BootTime_Stop(void)
+{
+  HAL_NVIC_DisableIRQ(TIM6_IRQn);
+  __HAL_RCC_TIM6_FORCE_RESET();
+  __HAL_RCC_TIM6_RELEASE_RESET();
+  __HAL_RCC_TIM6_CLK_DISABLE();
+  HAL_NVIC_ClearPendingIRQ(TIM6_IRQn);
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
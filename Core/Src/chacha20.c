@@ -0,0 +1,227 @@
+/**
+  ******************************************************************************
+  * @file    chacha20.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the ChaCha20 stream cipher (RFC 8439) that
+  *          decrypts encrypted downloads. The G070 has no AES unit; ChaCha20
+  *          only adds, rotates and XORs 32-bit words, which the Cortex-M0+
+  *          does in one cycle each.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "chacha20.h"
+#include "prof.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define CHACHA20_COUNTER_INDEX  12
+#ifdef IAP_PROFILE
+#define CHACHA20_SELFTEST_SIZE  ((uint32_t)1024)
+#endif /* IAP_PROFILE */
+
+/* Private macro -------------------------------------------------------------*/
+#define ROTL(x, n)              (((x) << (n)) | ((x) >> (32 - (n))))
+#define QUARTER(a, b, c, d)                 \
+  do                                        \
+  {                                         \
+    a += b; d ^= a; d = ROTL(d, 16);        \
+    c += d; b ^= c; b = ROTL(b, 12);        \
+    a += b; d ^= a; d = ROTL(d, 8);         \
+    c += d; b ^= c; b = ROTL(b, 7);         \
+  } while (0)
+#define LOAD32_LE(p)            ((uint32_t)(p)[0] | ((uint32_t)(p)[1] << 8) | \
+                                 ((uint32_t)(p)[2] << 16) | ((uint32_t)(p)[3] << 24))
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void Chacha20_Block(Chacha20_CtxTypeDef *p_ctx);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Compute the key stream block of the current counter, then step
+  *         the counter
+  * @note   The state is held in locals so that the compiler keeps what fits
+  *         of it in registers across the unrolled double round.
+  * @param  p_ctx: stream in progress
+  * @retval None
+  */
+static void Chacha20_Block(Chacha20_CtxTypeDef *p_ctx)
+{
+  const uint32_t *p_in = p_ctx->input;
+  uint32_t x0 = p_in[0], x1 = p_in[1], x2 = p_in[2], x3 = p_in[3];
+  uint32_t x4 = p_in[4], x5 = p_in[5], x6 = p_in[6], x7 = p_in[7];
+  uint32_t x8 = p_in[8], x9 = p_in[9], x10 = p_in[10], x11 = p_in[11];
+  uint32_t x12 = p_in[12], x13 = p_in[13], x14 = p_in[14], x15 = p_in[15];
+  uint32_t i;
+
+  for (i = 0; i < 10; i++)
+  {
+    /* Columns */
+    QUARTER(x0, x4, x8, x12);
+    QUARTER(x1, x5, x9, x13);
+    QUARTER(x2, x6, x10, x14);
+    QUARTER(x3, x7, x11, x15);
+    /* Diagonals */
+    QUARTER(x0, x5, x10, x15);
+    QUARTER(x1, x6, x11, x12);
+    QUARTER(x2, x7, x8, x13);
+    QUARTER(x3, x4, x9, x14);
+  }
+
+  p_ctx->keystream[0] = x0 + p_in[0];
+  p_ctx->keystream[1] = x1 + p_in[1];
+  p_ctx->keystream[2] = x2 + p_in[2];
+  p_ctx->keystream[3] = x3 + p_in[3];
+  p_ctx->keystream[4] = x4 + p_in[4];
+  p_ctx->keystream[5] = x5 + p_in[5];
+  p_ctx->keystream[6] = x6 + p_in[6];
+  p_ctx->keystream[7] = x7 + p_in[7];
+  p_ctx->keystream[8] = x8 + p_in[8];
+  p_ctx->keystream[9] = x9 + p_in[9];
+  p_ctx->keystream[10] = x10 + p_in[10];
+  p_ctx->keystream[11] = x11 + p_in[11];
+  p_ctx->keystream[12] = x12 + p_in[12];
+  p_ctx->keystream[13] = x13 + p_in[13];
+  p_ctx->keystream[14] = x14 + p_in[14];
+  p_ctx->keystream[15] = x15 + p_in[15];
+  p_ctx->input[CHACHA20_COUNTER_INDEX]++;
+  p_ctx->used = 0;
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Start a stream
+  * @param  p_ctx: stream to start
+  * @param  p_key: CHACHA20_KEY_SIZE bytes
+  * @param  p_nonce: CHACHA20_NONCE_SIZE bytes
+  * @param  counter: block counter of the first byte
+  * @retval None
+  */
+void Chacha20_Init(Chacha20_CtxTypeDef *p_ctx, const uint8_t *p_key, const uint8_t *p_nonce, uint32_t counter)
+{
+  uint32_t i;
+
+  p_ctx->input[0] = 0x61707865; /* "expand 32-byte k" */
+  p_ctx->input[1] = 0x3320646e;
+  p_ctx->input[2] = 0x79622d32;
+  p_ctx->input[3] = 0x6b206574;
+  for (i = 0; i < 8; i++)
+  {
+    p_ctx->input[4 + i] = LOAD32_LE(&p_key[4 * i]);
+  }
+  p_ctx->input[CHACHA20_COUNTER_INDEX] = counter;
+  for (i = 0; i < 3; i++)
+  {
+    p_ctx->input[13 + i] = LOAD32_LE(&p_nonce[4 * i]);
+  }
+  p_ctx->used = CHACHA20_BLOCK_SIZE;
+}
+
+/**
+  * @brief  Encrypt or decrypt in place
+  * @note   Whole key stream blocks over word aligned data are applied a
+  *         word at a time, the rest a byte at a time. Little endian core.
+  * @param  p_ctx: stream in progress
+  * @param  p_data: bytes to process, any alignment
+  * @param  length: number of bytes, any
+  * @retval None
+  */
+void Chacha20_Xor(Chacha20_CtxTypeDef *p_ctx, uint8_t *p_data, uint32_t length)
+{
+  const uint8_t *p_stream = (const uint8_t *)p_ctx->keystream;
+  uint32_t *p_word;
+  uint32_t i;
+
+  while (length != 0)
+  {
+    if (p_ctx->used == CHACHA20_BLOCK_SIZE)
+    {
+      Chacha20_Block(p_ctx);
+    }
+    if ((p_ctx->used == 0) && (length >= CHACHA20_BLOCK_SIZE) && (((uint32_t)p_data & 3) == 0))
+    {
+      p_word = (uint32_t *)p_data;
+      for (i = 0; i < (CHACHA20_BLOCK_SIZE / 4); i++)
+      {
+        p_word[i] ^= p_ctx->keystream[i];
+      }
+      p_ctx->used = CHACHA20_BLOCK_SIZE;
+      p_data += CHACHA20_BLOCK_SIZE;
+      length -= CHACHA20_BLOCK_SIZE;
+    }
+    else
+    {
+      while ((length != 0) && (p_ctx->used < CHACHA20_BLOCK_SIZE))
+      {
+        *p_data++ ^= p_stream[p_ctx->used++];
+        length--;
+      }
+    }
+  }
+}
+
+#ifdef IAP_PROFILE
+/**
+  * @brief  Check the RFC 8439 2.4.2 test vector, then time the cipher
+  * @param  None
+  * @retval Core cycles per byte over CHACHA20_SELFTEST_SIZE aligned bytes,
+  *         0 if the test vector fails
+  */
+uint32_t Chacha20_SelfTest(void)
+{
+  static const char aPlain[] = "Ladies and Gentlemen of the class of '99: If I could offer you "
+                               "only one tip for the future, sunscreen would be it.";
+  static const uint8_t aCipher[114] =
+  {
+    0x6e, 0x2e, 0x35, 0x9a, 0x25, 0x68, 0xf9, 0x80, 0x41, 0xba, 0x07, 0x28, 0xdd, 0x0d, 0x69, 0x81,
+    0xe9, 0x7e, 0x7a, 0xec, 0x1d, 0x43, 0x60, 0xc2, 0x0a, 0x27, 0xaf, 0xcc, 0xfd, 0x9f, 0xae, 0x0b,
+    0xf9, 0x1b, 0x65, 0xc5, 0x52, 0x47, 0x33, 0xab, 0x8f, 0x59, 0x3d, 0xab, 0xcd, 0x62, 0xb3, 0x57,
+    0x16, 0x39, 0xd6, 0x24, 0xe6, 0x51, 0x52, 0xab, 0x8f, 0x53, 0x0c, 0x35, 0x9f, 0x08, 0x61, 0xd8,
+    0x07, 0xca, 0x0d, 0xbf, 0x50, 0x0d, 0x6a, 0x61, 0x56, 0xa3, 0x8e, 0x08, 0x8a, 0x22, 0xb6, 0x5e,
+    0x52, 0xbc, 0x51, 0x4d, 0x16, 0xcc, 0xf8, 0x06, 0x81, 0x8c, 0xe9, 0x1a, 0xb7, 0x79, 0x37, 0x36,
+    0x5a, 0xf9, 0x0b, 0xbf, 0x74, 0xa3, 0x5b, 0xe6, 0xb4, 0x0b, 0x8e, 0xed, 0xf2, 0x78, 0x5e, 0x42,
+    0x87, 0x4d
+  };
+  static const uint8_t aNonce[CHACHA20_NONCE_SIZE] = { 0, 0, 0, 0, 0, 0, 0, 0x4a, 0, 0, 0, 0 };
+  static uint32_t aBuffer[CHACHA20_SELFTEST_SIZE / 4];
+  Chacha20_CtxTypeDef ctx;
+  uint8_t key[CHACHA20_KEY_SIZE];
+  uint32_t i, cycles;
+
+  for (i = 0; i < CHACHA20_KEY_SIZE; i++)
+  {
+    key[i] = (uint8_t)i;
+  }
+  /* In two uneven parts, to go through a partly used block */
+  memcpy(aBuffer, aPlain, sizeof(aCipher));
+  Chacha20_Init(&ctx, key, aNonce, 1);
+  Chacha20_Xor(&ctx, (uint8_t *)aBuffer, 37);
+  Chacha20_Xor(&ctx, (uint8_t *)aBuffer + 37, sizeof(aCipher) - 37);
+  if (memcmp(aBuffer, aCipher, sizeof(aCipher)) != 0)
+  {
+    return 0;
+  }
+
+  Chacha20_Init(&ctx, key, aNonce, 0);
+  cycles = Prof_Now();
+  Chacha20_Xor(&ctx, (uint8_t *)aBuffer, CHACHA20_SELFTEST_SIZE);
+  cycles = Prof_Now() - cycles;
+  return cycles / CHACHA20_SELFTEST_SIZE;
+}
+#endif /* IAP_PROFILE */
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
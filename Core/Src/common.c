@@ -40,12 +40,50 @@
 /* Includes ------------------------------------------------------------------*/
 #include "common.h"
 #include "main.h"
+#include "trace.h"
 
 /* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Data sent by the running DMA transfer
+  */
+typedef enum
+{
+  TX_SRC_NONE = 0,
+  TX_SRC_CTRL,
+  TX_SRC_FRAME,
+  TX_SRC_RING
+} Serial_TxSourceTypeDef;
+
 /* Private define ------------------------------------------------------------*/
+#define TX_CTRL_SIZE        ((uint32_t)8)    /* Priority control bytes, power of 2 */
+
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/* Console text, drained by DMA in the background */
+static uint8_t aTxRing[TX_RING_SIZE];
+static __IO uint32_t TxRingHead;
+static __IO uint32_t TxRingTail;
+/* Protocol control bytes, sent ahead of any queued text */
+static uint8_t aTxCtrl[TX_CTRL_SIZE];
+static __IO uint32_t TxCtrlHead;
+static __IO uint32_t TxCtrlTail;
+/* Frame handed over by Serial_PutFrame() */
+static uint8_t *pTxFrame;
+static uint16_t TxFrameLength;
+static __IO uint8_t TxFramePending;
+/* Running transfer. The DMA channel is driven directly: through the HAL the
+ * gState is reset by a polling receive timeout, and the lock held while a
+ * receive starts would make a transfer started from the interrupt fail. */
+static __IO uint8_t TxSource;
+static uint32_t TxLength;
+static uint32_t TxStart;
+static uint32_t TxTimeout;
+
 /* Private function prototypes -----------------------------------------------*/
+static void Serial_TxKick(void);
+static void Serial_TxCplt(DMA_HandleTypeDef *hdma);
+static void Serial_TxPoll(void);
+
 /* Private functions ---------------------------------------------------------*/
 
 /**
@@ -151,6 +189,159 @@ uint32_t Str2Int(uint8_t *p_inputstr, uint32_t *p_intnum)
   return res;
 }
 
+/**
+  * @brief  Start the next pending transfer if the DMA channel is idle
+  * @note   Control bytes go first, then a frame, then queued text. Called
+  *         with interrupts masked or from the DMA interrupt.
+  * @param  None
+  * @retval None
+  */
+static void Serial_TxKick(void)
+{
+  uint8_t *p_src;
+  uint32_t tail;
+
+  if (TxSource != TX_SRC_NONE)
+  {
+    return;
+  }
+
+  if (TxCtrlHead != TxCtrlTail)
+  {
+    p_src = &aTxCtrl[TxCtrlTail & (TX_CTRL_SIZE - 1)];
+    TxLength = 1;
+    TxSource = TX_SRC_CTRL;
+  }
+  else if (TxFramePending)
+  {
+    p_src = pTxFrame;
+    TxLength = TxFrameLength;
+    TxSource = TX_SRC_FRAME;
+  }
+  else if (TxRingHead != TxRingTail)
+  {
+    /* Up to the end of the ring, the rest goes in the next transfer. A short
+       transfer lets a queued ACK, NAK or 'C' out within a few ms. */
+    tail = TxRingTail & (TX_RING_SIZE - 1);
+    p_src = &aTxRing[tail];
+    TxLength = TxRingHead - TxRingTail;
+    if (TxLength > (TX_RING_SIZE - tail))
+    {
+      TxLength = TX_RING_SIZE - tail;
+    }
+    if (TxLength > TX_RING_CHUNK)
+    {
+      TxLength = TX_RING_CHUNK;
+    }
+    TxSource = TX_SRC_RING;
+  }
+  else
+  {
+    return;
+  }
+
+  /* Wire time of the transfer plus the usual margin */
+  TxTimeout = (TxLength * 10U * 1000U) / UartHandle.Init.BaudRate + TX_TIMEOUT;
+  TxStart = HAL_GetTick();
+  UartHandle.hdmatx->XferCpltCallback = Serial_TxCplt;
+  UartHandle.hdmatx->XferHalfCpltCallback = NULL;
+  UartHandle.hdmatx->XferErrorCallback = Serial_TxCplt;
+  HAL_DMA_Start_IT(UartHandle.hdmatx, (uint32_t)p_src, (uint32_t)&UartHandle.Instance->TDR, TxLength);
+  SET_BIT(UartHandle.Instance->CR3, USART_CR3_DMAT);
+}
+
+/**
+  * @brief  DMA transfer complete or error callback: release the sent data
+  *         and start the next transfer
+  * @param  hdma: DMA handle
+  * @retval None
+  */
+static void Serial_TxCplt(DMA_HandleTypeDef *hdma)
+{
+  CLEAR_BIT(UartHandle.Instance->CR3, USART_CR3_DMAT);
+  switch (TxSource)
+  {
+    case TX_SRC_CTRL:
+      TxCtrlTail++;
+      break;
+    case TX_SRC_FRAME:
+      TxFramePending = 0;
+      break;
+    case TX_SRC_RING:
+      TxRingTail += TxLength;
+      break;
+    default:
+      break;
+  }
+  TxSource = TX_SRC_NONE;
+  Serial_TxKick();
+}
+
+/**
+  * @brief  Abort a transfer that takes longer than its wire time, so a
+  *         waiting caller always makes progress
+  * @param  None
+  * @retval None
+  */
+static void Serial_TxPoll(void)
+{
+  uint32_t primask = __get_PRIMASK();
+
+  __disable_irq();
+  if ((TxSource != TX_SRC_NONE) && ((HAL_GetTick() - TxStart) > TxTimeout))
+  {
+    HAL_DMA_Abort(UartHandle.hdmatx);
+    Serial_TxCplt(UartHandle.hdmatx);
+  }
+  __set_PRIMASK(primask);
+}
+
+/**
+  * @brief  Queue data for the HyperTerminal without waiting
+  * @param  p_data: The data to be sent
+  * @param  length: Number of bytes to send
+  * @retval Number of bytes queued, less than length when the ring is full
+  */
+uint32_t Serial_Enqueue(const uint8_t *p_data, uint32_t length)
+{
+  uint32_t count = 0, primask;
+
+  while ((count < length) && ((TxRingHead - TxRingTail) < TX_RING_SIZE))
+  {
+    aTxRing[TxRingHead & (TX_RING_SIZE - 1)] = p_data[count++];
+    TxRingHead++;
+  }
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  Serial_TxKick();
+  __set_PRIMASK(primask);
+  return count;
+}
+
+/**
+  * @brief  Queue data for the HyperTerminal, waiting for room in the ring
+  *         only when it is full
+  * @param  p_data: The data to be sent
+  * @param  length: Number of bytes to send
+  * @retval None
+  */
+void Serial_PutData(const uint8_t *p_data, uint32_t length)
+{
+  uint32_t count;
+
+  while (length != 0)
+  {
+    count = Serial_Enqueue(p_data, length);
+    p_data += count;
+    length -= count;
+    if (length != 0)
+    {
+      Serial_TxPoll();
+    }
+  }
+}
+
 /**
   * @brief  Print a string on the HyperTerminal
   * @param  p_string: The string to be printed
@@ -164,23 +355,94 @@ void Serial_PutString(uint8_t *p_string)
   {
     length++;
   }
-  HAL_UART_Transmit(&UartHandle, p_string, length, TX_TIMEOUT);
+  Serial_PutData(p_string, length);
 }
 
 /**
-  * @brief  Transmit a byte to the HyperTerminal
+  * @brief  Transmit a protocol control byte to the HyperTerminal
+  * @note   The byte is sent ahead of any queued text.
   * @param  param The byte to be sent
   * @retval HAL_StatusTypeDef HAL_OK if OK
   */
 HAL_StatusTypeDef Serial_PutByte( uint8_t param )
 {
-  /* May be timeouted... */
-  if ( UartHandle.gState == HAL_UART_STATE_TIMEOUT )
+  uint32_t primask;
+
+  TRACE_EVENT(TRACE_TX_CTRL, param, 0);
+  while ((TxCtrlHead - TxCtrlTail) >= TX_CTRL_SIZE)
+  {
+    Serial_TxPoll();
+  }
+  aTxCtrl[TxCtrlHead & (TX_CTRL_SIZE - 1)] = param;
+  TxCtrlHead++;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  Serial_TxKick();
+  __set_PRIMASK(primask);
+  return HAL_OK;
+}
+
+/**
+  * @brief  Start sending a frame by DMA and return without waiting
+  * @note   The buffer must stay untouched until Serial_WaitTxDone() returns.
+  *         A frame still pending is waited for first.
+  * @param  p_frame: The frame to be sent
+  * @param  length: Number of bytes to send
+  * @retval HAL_StatusTypeDef HAL_OK if the frame is queued
+  */
+HAL_StatusTypeDef Serial_PutFrame(uint8_t *p_frame, uint16_t length)
+{
+  uint32_t primask;
+
+  Serial_WaitTxDone();
+  pTxFrame = p_frame;
+  TxFrameLength = length;
+  TxFramePending = 1;
+
+  primask = __get_PRIMASK();
+  __disable_irq();
+  Serial_TxKick();
+  __set_PRIMASK(primask);
+  return HAL_OK;
+}
+
+/**
+  * @brief  Wait until the frame queued by Serial_PutFrame() is sent
+  * @note   A transfer that does not complete in time is aborted.
+  * @param  None
+  * @retval None
+  */
+void Serial_WaitTxDone(void)
+{
+  while (TxFramePending)
+  {
+    Serial_TxPoll();
+  }
+}
+
+/**
+  * @brief  Wait until all queued output has left the UART
+  * @note   Call before a reset or a jump to the application.
+  * @param  None
+  * @retval None
+  */
+void Serial_Flush(void)
+{
+  uint32_t tickstart;
+
+  while ((TxSource != TX_SRC_NONE) || (TxCtrlHead != TxCtrlTail) || (TxRingHead != TxRingTail))
+  {
+    Serial_TxPoll();
+  }
+
+  /* Last byte out of the shift register */
+  tickstart = HAL_GetTick();
+  while ((__HAL_UART_GET_FLAG(&UartHandle, UART_FLAG_TC) == RESET) && ((HAL_GetTick() - tickstart) <= TX_TIMEOUT))
   {
-    UartHandle.gState = HAL_UART_STATE_READY;
   }
-  return HAL_UART_Transmit(&UartHandle, &param, 1, TX_TIMEOUT);
 }
+
 /**
   * @}
   */
@@ -0,0 +1,110 @@
+/**
+  ******************************************************************************
+  * @file    digest.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the digests of flash areas, computed on the
+  *          device so that a host checks a programmed unit without reading
+  *          the Flash back (see Tools/flash_digest.py).
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "digest.h"
+#include "sha256.h"
+#include "crc.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define CRC32_POLYNOMIAL        ((uint32_t)0x04C11DB7)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Size of the digest of an algorithm
+  * @param  algorithm: DIGEST_ALGO_xxx
+  * @retval Size in bytes, 0 if the algorithm is not supported
+  */
+uint32_t Digest_Size(uint8_t algorithm)
+{
+  switch (algorithm)
+  {
+    case DIGEST_ALGO_CRC32:
+      return 4;
+    case DIGEST_ALGO_SHA256:
+      return SHA256_DIGEST_SIZE;
+    default:
+      return 0;
+  }
+}
+
+/**
+  * @brief  Digest of a flash area
+  * @param  algorithm: DIGEST_ALGO_xxx, supported by Digest_Size()
+  * @param  start: start address of the area, any alignment
+  * @param  length: length of the area in bytes
+  * @param  p_digest: receives Digest_Size(algorithm) bytes
+  * @retval None
+  */
+void Digest_Compute(uint8_t algorithm, uint32_t start, uint32_t length, uint8_t *p_digest)
+{
+  uint32_t crc;
+
+  switch (algorithm)
+  {
+    case DIGEST_ALGO_CRC32:
+      crc = Digest_Crc32(start, length);
+      memcpy(p_digest, &crc, 4);
+      break;
+    case DIGEST_ALGO_SHA256:
+      Sha256((const uint8_t *)start, length, p_digest);
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  CRC-32 of a flash area, computed by the CRC unit
+  * @note   The unit is set for the reflected CRC-32 of zlib for the time of
+  *         the computation, then back to the CRC16-XMODEM of the YMODEM
+  *         packets.
+  * @param  start: start address of the area, any alignment
+  * @param  length: length of the area in bytes, not 0
+  * @retval CRC value
+  */
+uint32_t Digest_Crc32(uint32_t start, uint32_t length)
+{
+  uint32_t crc;
+
+  hcrc.Init.DefaultPolynomialUse = DEFAULT_POLYNOMIAL_DISABLE;
+  hcrc.Init.DefaultInitValueUse = DEFAULT_INIT_VALUE_DISABLE;
+  hcrc.Init.GeneratingPolynomial = CRC32_POLYNOMIAL;
+  hcrc.Init.CRCLength = CRC_POLYLENGTH_32B;
+  hcrc.Init.InitValue = 0xFFFFFFFFU;
+  hcrc.Init.InputDataInversionMode = CRC_INPUTDATA_INVERSION_BYTE;
+  hcrc.Init.OutputDataInversionMode = CRC_OUTPUTDATA_INVERSION_ENABLE;
+  hcrc.InputDataFormat = CRC_INPUTDATA_FORMAT_BYTES;
+  HAL_CRC_Init(&hcrc);
+
+  crc = HAL_CRC_Calculate(&hcrc, (uint32_t *)start, length) ^ 0xFFFFFFFFU;
+
+  MX_CRC_Init();
+  return crc;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,643 @@
+/**
+  ******************************************************************************
+  * @file    ed25519.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the Ed25519 signature verification (RFC 8032)
+  *          of signed images.
+  *          Field elements are 16 limbs of 16 bits kept below 2^16, so that
+  *          every limb product is one 32-bit MULS of the Cortex-M0+ and only
+  *          the column sums need 64 bits. Verification is not secret, so it
+  *          runs in variable time.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "ed25519.h"
+#include "sha512.h"
+#include "prof.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+typedef uint32_t Fe[16];        /* Little endian 16-bit limbs, value below 2^256 */
+typedef Fe Ge[4];               /* Extended coordinates X, Y, Z, T with x = X/Z, y = Y/Z, xy = T/Z */
+
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+#define GE_X                    0
+#define GE_Y                    1
+#define GE_Z                    2
+#define GE_T                    3
+
+/* Private variables ---------------------------------------------------------*/
+static const Fe FeZero = { 0 };
+static const Fe FeOne = { 1 };
+
+/* d = -121665/121666 */
+static const Fe FeD =
+{
+  0x78a3, 0x1359, 0x4dca, 0x75eb, 0xd8ab, 0x4141, 0x0a4d, 0x0070,
+  0xe898, 0x7779, 0x4079, 0x8cc7, 0xfe73, 0x2b6f, 0x6cee, 0x5203
+};
+
+/* 2d */
+static const Fe FeD2 =
+{
+  0xf159, 0x26b2, 0x9b94, 0xebd6, 0xb156, 0x8283, 0x149a, 0x00e0,
+  0xd130, 0xeef3, 0x80f2, 0x198e, 0xfce7, 0x56df, 0xd9dc, 0x2406
+};
+
+/* sqrt(-1) */
+static const Fe FeSqrtM1 =
+{
+  0xa0b0, 0x4a0e, 0x1b27, 0xc4ee, 0xe478, 0xad2f, 0x1806, 0x2f43,
+  0xd7a7, 0x3dfb, 0x0099, 0x2b4d, 0xdf0b, 0x4fc1, 0x2480, 0x2b83
+};
+
+/* 4p, with every limb above 0xFFFF so that a subtraction never goes negative */
+static const Fe Fe4P =
+{
+  0x1ffb4, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe,
+  0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe, 0x1fffe
+};
+
+/* Base point */
+static const Fe FeBaseX =
+{
+  0xd51a, 0x8f25, 0x2d60, 0xc956, 0xa7b2, 0x9525, 0xc760, 0x692c,
+  0xdc5c, 0xfdd6, 0xe231, 0xc0a4, 0x53fe, 0xcd6e, 0x36d3, 0x2169
+};
+static const Fe FeBaseY =
+{
+  0x6658, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666,
+  0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666, 0x6666
+};
+
+/* Group order L, little endian bytes */
+static const uint8_t aOrder[32] =
+{
+  0xed, 0xd3, 0xf5, 0x5c, 0x1a, 0x63, 0x12, 0x58, 0xd6, 0x9c, 0xf7, 0xa2, 0xde, 0xf9, 0xde, 0x14,
+  0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x10
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Fe_Carry(Fe o, uint32_t *p_t);
+static void Fe_Add(Fe o, const Fe a, const Fe b);
+static void Fe_Sub(Fe o, const Fe a, const Fe b);
+static void Fe_Mul(Fe o, const Fe a, const Fe b);
+static void Fe_Sq(Fe o, const Fe a);
+static void Fe_Pack(uint8_t *p_out, const Fe a);
+static void Fe_Unpack(Fe o, const uint8_t *p_in);
+static uint32_t Fe_Differ(const Fe a, const Fe b);
+static void Fe_Pow2523(Fe o, const Fe a);
+static void Fe_Invert(Fe o, const Fe a);
+static void Ge_Add(Ge p, const Ge q);
+static void Ge_Double(Ge p);
+static uint32_t Ge_UnpackNeg(Ge p, const uint8_t *p_in);
+static void Ge_Pack(uint8_t *p_out, const Ge p);
+static void Sc_Reduce(uint8_t *p_out, int64_t *p_x);
+static uint32_t Sc_IsCanonical(const uint8_t *p_s);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Bring limbs below 2^32 back below 2^16, 2^256 folding as 38
+  * @param  o: result
+  * @param  p_t: 16 limbs, each below 2^31, overwritten
+  * @retval None
+  */
+static void Fe_Carry(Fe o, uint32_t *p_t)
+{
+  uint32_t i, pass;
+
+  for (pass = 0; pass < 2; pass++)
+  {
+    for (i = 0; i < 15; i++)
+    {
+      p_t[i + 1] += p_t[i] >> 16;
+      p_t[i] &= 0xFFFF;
+    }
+    p_t[0] += 38 * (p_t[15] >> 16);
+    p_t[15] &= 0xFFFF;
+  }
+  /* A second fold only happens after the carry ran through, limb 1 is small */
+  p_t[1] += p_t[0] >> 16;
+  p_t[0] &= 0xFFFF;
+  memcpy(o, p_t, sizeof(Fe));
+}
+
+/**
+  * @brief  o = a + b
+  */
+static void Fe_Add(Fe o, const Fe a, const Fe b)
+{
+  uint32_t t[16], i;
+
+  for (i = 0; i < 16; i++)
+  {
+    t[i] = a[i] + b[i];
+  }
+  Fe_Carry(o, t);
+}
+
+/**
+  * @brief  o = a - b, computed as a + 4p - b
+  */
+static void Fe_Sub(Fe o, const Fe a, const Fe b)
+{
+  uint32_t t[16], i;
+
+  for (i = 0; i < 16; i++)
+  {
+    t[i] = a[i] + Fe4P[i] - b[i];
+  }
+  Fe_Carry(o, t);
+}
+
+/**
+  * @brief  Fold the 31 column sums of a product into a field element
+  * @param  o: result
+  * @param  p_col: column sums, each below 2^37
+  * @retval None
+  */
+static void Fe_Fold(Fe o, uint64_t *p_col)
+{
+  uint32_t t[16], i;
+  uint64_t carry = 0;
+
+  for (i = 0; i < 15; i++)
+  {
+    p_col[i] += 38 * p_col[i + 16];
+  }
+  for (i = 0; i < 16; i++)
+  {
+    carry += p_col[i];
+    t[i] = (uint32_t)carry & 0xFFFF;
+    carry >>= 16;
+  }
+  t[0] += 38 * (uint32_t)carry;
+  Fe_Carry(o, t);
+}
+
+/**
+  * @brief  o = a * b, by columns: one 16x16 MULS per limb pair
+  */
+static void Fe_Mul(Fe o, const Fe a, const Fe b)
+{
+  uint64_t col[31], sum;
+  uint32_t i, k, lo, hi;
+
+  for (k = 0; k < 31; k++)
+  {
+    lo = (k < 16) ? 0 : (k - 15);
+    hi = (k < 16) ? k : 15;
+    sum = 0;
+    for (i = lo; i <= hi; i++)
+    {
+      sum += a[i] * b[k - i];
+    }
+    col[k] = sum;
+  }
+  Fe_Fold(o, col);
+}
+
+/**
+  * @brief  o = a * a, each cross product computed once
+  */
+static void Fe_Sq(Fe o, const Fe a)
+{
+  uint64_t col[31], sum;
+  uint32_t i, k;
+
+  for (k = 0; k < 31; k++)
+  {
+    sum = 0;
+    for (i = (k < 16) ? 0 : (k - 15); i < (k - i); i++)
+    {
+      sum += a[i] * a[k - i];
+    }
+    sum <<= 1;
+    if ((k & 1) == 0)
+    {
+      sum += a[k / 2] * a[k / 2];
+    }
+    col[k] = sum;
+  }
+  Fe_Fold(o, col);
+}
+
+/**
+  * @brief  Canonical little endian encoding, below p
+  */
+static void Fe_Pack(uint8_t *p_out, const Fe a)
+{
+  int32_t m[16], t[16], borrow;
+  uint32_t i, pass;
+
+  for (i = 0; i < 16; i++)
+  {
+    t[i] = (int32_t)a[i];
+  }
+  /* The value is below 2^256 < 3p: at most two subtractions of p */
+  for (pass = 0; pass < 2; pass++)
+  {
+    borrow = 0;
+    for (i = 0; i < 16; i++)
+    {
+      m[i] = t[i] - ((i == 0) ? 0xffed : ((i == 15) ? 0x7fff : 0xffff)) - borrow;
+      borrow = (m[i] >> 16) & 1;
+      m[i] &= 0xFFFF;
+    }
+    if (!borrow)
+    {
+      memcpy(t, m, sizeof(t));
+    }
+  }
+  for (i = 0; i < 16; i++)
+  {
+    p_out[2 * i] = (uint8_t)t[i];
+    p_out[2 * i + 1] = (uint8_t)(t[i] >> 8);
+  }
+}
+
+/**
+  * @brief  Decode 32 little endian bytes, the top bit is ignored
+  */
+static void Fe_Unpack(Fe o, const uint8_t *p_in)
+{
+  uint32_t i;
+
+  for (i = 0; i < 16; i++)
+  {
+    o[i] = p_in[2 * i] | ((uint32_t)p_in[2 * i + 1] << 8);
+  }
+  o[15] &= 0x7FFF;
+}
+
+/**
+  * @brief  Compare two elements modulo p
+  * @retval 1 if they differ, 0 otherwise
+  */
+static uint32_t Fe_Differ(const Fe a, const Fe b)
+{
+  uint8_t pa[32], pb[32];
+
+  Fe_Pack(pa, a);
+  Fe_Pack(pb, b);
+  return memcmp(pa, pb, 32) != 0;
+}
+
+/**
+  * @brief  o = a^((p-5)/8), for the square root
+  */
+static void Fe_Pow2523(Fe o, const Fe a)
+{
+  Fe c;
+  int32_t i;
+
+  memcpy(c, a, sizeof(Fe));
+  for (i = 250; i >= 0; i--)
+  {
+    Fe_Sq(c, c);
+    if (i != 1)
+    {
+      Fe_Mul(c, c, a);
+    }
+  }
+  memcpy(o, c, sizeof(Fe));
+}
+
+/**
+  * @brief  o = 1/a = a^(p-2)
+  */
+static void Fe_Invert(Fe o, const Fe a)
+{
+  Fe c;
+  int32_t i;
+
+  memcpy(c, a, sizeof(Fe));
+  for (i = 253; i >= 0; i--)
+  {
+    Fe_Sq(c, c);
+    if ((i != 2) && (i != 4))
+    {
+      Fe_Mul(c, c, a);
+    }
+  }
+  memcpy(o, c, sizeof(Fe));
+}
+
+/**
+  * @brief  p = p + q, unified addition (also valid for p == q)
+  */
+static void Ge_Add(Ge p, const Ge q)
+{
+  Fe a, b, c, d, t, e, f, g, h;
+
+  Fe_Sub(a, p[GE_Y], p[GE_X]);
+  Fe_Sub(t, q[GE_Y], q[GE_X]);
+  Fe_Mul(a, a, t);
+  Fe_Add(b, p[GE_X], p[GE_Y]);
+  Fe_Add(t, q[GE_X], q[GE_Y]);
+  Fe_Mul(b, b, t);
+  Fe_Mul(c, p[GE_T], q[GE_T]);
+  Fe_Mul(c, c, FeD2);
+  Fe_Mul(d, p[GE_Z], q[GE_Z]);
+  Fe_Add(d, d, d);
+  Fe_Sub(e, b, a);
+  Fe_Sub(f, d, c);
+  Fe_Add(g, d, c);
+  Fe_Add(h, b, a);
+
+  Fe_Mul(p[GE_X], e, f);
+  Fe_Mul(p[GE_Y], h, g);
+  Fe_Mul(p[GE_Z], g, f);
+  Fe_Mul(p[GE_T], e, h);
+}
+
+/**
+  * @brief  p = 2p, four squarings and four products
+  */
+static void Ge_Double(Ge p)
+{
+  Fe xx, yy, zz2, e, sum, diff;
+
+  Fe_Sq(xx, p[GE_X]);
+  Fe_Sq(yy, p[GE_Y]);
+  Fe_Sq(zz2, p[GE_Z]);
+  Fe_Add(zz2, zz2, zz2);
+  Fe_Add(e, p[GE_X], p[GE_Y]);
+  Fe_Sq(e, e);
+  Fe_Add(sum, yy, xx);
+  Fe_Sub(diff, yy, xx);
+  Fe_Sub(e, e, sum);
+  Fe_Sub(zz2, zz2, diff);
+
+  Fe_Mul(p[GE_X], e, zz2);
+  Fe_Mul(p[GE_Y], sum, diff);
+  Fe_Mul(p[GE_Z], diff, zz2);
+  Fe_Mul(p[GE_T], e, sum);
+}
+
+/**
+  * @brief  Decode a point and negate it
+  * @param  p: receives -P
+  * @param  p_in: 32-byte encoding of P
+  * @retval 1 if the encoding is a valid point, 0 otherwise
+  */
+static uint32_t Ge_UnpackNeg(Ge p, const uint8_t *p_in)
+{
+  Fe num, den, den2, den4, den6, t, chk;
+  uint8_t canonical[32];
+
+  memcpy(p[GE_Z], FeOne, sizeof(Fe));
+  Fe_Unpack(p[GE_Y], p_in);
+
+  /* y must be below p */
+  Fe_Pack(canonical, p[GE_Y]);
+  canonical[31] |= p_in[31] & 0x80;
+  if (memcmp(canonical, p_in, 32) != 0)
+  {
+    return 0;
+  }
+
+  /* x^2 = (y^2 - 1) / (d y^2 + 1) */
+  Fe_Sq(num, p[GE_Y]);
+  Fe_Mul(den, num, FeD);
+  Fe_Sub(num, num, p[GE_Z]);
+  Fe_Add(den, p[GE_Z], den);
+
+  Fe_Sq(den2, den);
+  Fe_Sq(den4, den2);
+  Fe_Mul(den6, den4, den2);
+  Fe_Mul(t, den6, num);
+  Fe_Mul(t, t, den);
+
+  Fe_Pow2523(t, t);
+  Fe_Mul(t, t, num);
+  Fe_Mul(t, t, den);
+  Fe_Mul(t, t, den);
+  Fe_Mul(p[GE_X], t, den);
+
+  Fe_Sq(chk, p[GE_X]);
+  Fe_Mul(chk, chk, den);
+  if (Fe_Differ(chk, num))
+  {
+    Fe_Mul(p[GE_X], p[GE_X], FeSqrtM1);
+  }
+  Fe_Sq(chk, p[GE_X]);
+  Fe_Mul(chk, chk, den);
+  if (Fe_Differ(chk, num))
+  {
+    return 0;
+  }
+
+  /* Pick the root of the opposite sign, for -P */
+  Fe_Pack(canonical, p[GE_X]);
+  if ((canonical[0] & 1) == (p_in[31] >> 7))
+  {
+    Fe_Sub(p[GE_X], FeZero, p[GE_X]);
+  }
+  Fe_Mul(p[GE_T], p[GE_X], p[GE_Y]);
+  return 1;
+}
+
+/**
+  * @brief  Encode a point: y, with the sign of x in the top bit
+  */
+static void Ge_Pack(uint8_t *p_out, const Ge p)
+{
+  Fe zi, x, y;
+  uint8_t sign[32];
+
+  Fe_Invert(zi, p[GE_Z]);
+  Fe_Mul(x, p[GE_X], zi);
+  Fe_Mul(y, p[GE_Y], zi);
+  Fe_Pack(p_out, y);
+  Fe_Pack(sign, x);
+  p_out[31] ^= (uint8_t)((sign[0] & 1) << 7);
+}
+
+/**
+  * @brief  Reduce a 512-bit little endian number modulo L
+  * @param  p_out: 32 bytes
+  * @param  p_x: 64 signed bytes, destroyed
+  * @retval None
+  */
+static void Sc_Reduce(uint8_t *p_out, int64_t *p_x)
+{
+  int64_t carry;
+  int32_t i, j;
+
+  for (i = 63; i >= 32; i--)
+  {
+    carry = 0;
+    for (j = i - 32; j < (i - 12); j++)
+    {
+      p_x[j] += carry - 16 * p_x[i] * aOrder[j - (i - 32)];
+      carry = (p_x[j] + 128) >> 8;
+      p_x[j] -= carry * 256;
+    }
+    p_x[j] += carry;
+    p_x[i] = 0;
+  }
+  carry = 0;
+  for (j = 0; j < 32; j++)
+  {
+    p_x[j] += carry - (p_x[31] >> 4) * aOrder[j];
+    carry = p_x[j] >> 8;
+    p_x[j] &= 255;
+  }
+  for (j = 0; j < 32; j++)
+  {
+    p_x[j] -= carry * aOrder[j];
+  }
+  for (i = 0; i < 32; i++)
+  {
+    p_x[i + 1] += p_x[i] >> 8;
+    p_out[i] = (uint8_t)(p_x[i] & 255);
+  }
+}
+
+/**
+  * @brief  Check that a scalar is below L, as RFC 8032 requires for S
+  * @retval 1 if s < L, 0 otherwise
+  */
+static uint32_t Sc_IsCanonical(const uint8_t *p_s)
+{
+  int32_t i;
+
+  for (i = 31; i >= 0; i--)
+  {
+    if (p_s[i] != aOrder[i])
+    {
+      return p_s[i] < aOrder[i];
+    }
+  }
+  return 0;
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Verify an Ed25519 signature
+  * @note   Checks [S]B = R + [k]A with k = SHA-512(R || A || M) mod L. The
+  *         two products are computed together, sharing the doublings
+  *         (Straus): about 253 doublings and 190 additions.
+  * @param  p_signature: R then S, ED25519_SIGNATURE_SIZE bytes
+  * @param  p_public_key: A, ED25519_PUBLIC_KEY_SIZE bytes
+  * @param  p_message: signed message
+  * @param  length: length of the message in bytes
+  * @retval 1 if the signature is valid, 0 otherwise
+  */
+uint32_t Ed25519_Verify(const uint8_t *p_signature, const uint8_t *p_public_key,
+                        const uint8_t *p_message, uint32_t length)
+{
+  /* Kept off the stack, which also has to hold Ge_Add() and Fe_Mul() */
+  static Sha512_CtxTypeDef sha;
+  static int64_t x[64];
+  static Ge table[3], r;
+  uint8_t h[SHA512_DIGEST_SIZE], k[32], check[32];
+  uint32_t i, bits;
+  int32_t bit;
+
+  if (!Sc_IsCanonical(&p_signature[32]) || !Ge_UnpackNeg(table[1], p_public_key))
+  {
+    return 0;
+  }
+
+  Sha512_Init(&sha);
+  Sha512_Update(&sha, p_signature, 32);
+  Sha512_Update(&sha, p_public_key, ED25519_PUBLIC_KEY_SIZE);
+  Sha512_Update(&sha, p_message, length);
+  Sha512_Final(&sha, h);
+  for (i = 0; i < 64; i++)
+  {
+    x[i] = h[i];
+  }
+  Sc_Reduce(k, x);
+
+  /* table: B, -A, B - A */
+  memcpy(table[0][GE_X], FeBaseX, sizeof(Fe));
+  memcpy(table[0][GE_Y], FeBaseY, sizeof(Fe));
+  memcpy(table[0][GE_Z], FeOne, sizeof(Fe));
+  Fe_Mul(table[0][GE_T], FeBaseX, FeBaseY);
+  memcpy(table[2], table[0], sizeof(Ge));
+  Ge_Add(table[2], table[1]);
+
+  /* r = [S]B + [k](-A), both scalars below 2^253 */
+  memset(r, 0, sizeof(Ge));
+  r[GE_Y][0] = 1;
+  r[GE_Z][0] = 1;
+  for (bit = 252; bit >= 0; bit--)
+  {
+    Ge_Double(r);
+    bits = ((p_signature[32 + (bit >> 3)] >> (bit & 7)) & 1) | (((k[bit >> 3] >> (bit & 7)) & 1) << 1);
+    if (bits != 0)
+    {
+      Ge_Add(r, table[bits - 1]);
+    }
+  }
+
+  Ge_Pack(check, r);
+  return memcmp(check, p_signature, 32) == 0;
+}
+
+#ifdef IAP_PROFILE
+/**
+  * @brief  Check the RFC 8032 test vectors 1 and 2, then time a verification
+  * @param  None
+  * @retval Core cycles of one verification, 0 if a test vector fails
+  */
+uint32_t Ed25519_SelfTest(void)
+{
+  static const uint8_t aKeys[2][ED25519_PUBLIC_KEY_SIZE] =
+  {
+    { 0xd7, 0x5a, 0x98, 0x01, 0x82, 0xb1, 0x0a, 0xb7, 0xd5, 0x4b, 0xfe, 0xd3, 0xc9, 0x64, 0x07, 0x3a,
+      0x0e, 0xe1, 0x72, 0xf3, 0xda, 0xa6, 0x23, 0x25, 0xaf, 0x02, 0x1a, 0x68, 0xf7, 0x07, 0x51, 0x1a },
+    { 0x3d, 0x40, 0x17, 0xc3, 0xe8, 0x43, 0x89, 0x5a, 0x92, 0xb7, 0x0a, 0xa7, 0x4d, 0x1b, 0x7e, 0xbc,
+      0x9c, 0x98, 0x2c, 0xcf, 0x2e, 0xc4, 0x96, 0x8c, 0xc0, 0xcd, 0x55, 0xf1, 0x2a, 0xf4, 0x66, 0x0c }
+  };
+  static const uint8_t aSignatures[2][ED25519_SIGNATURE_SIZE] =
+  {
+    { 0xe5, 0x56, 0x43, 0x00, 0xc3, 0x60, 0xac, 0x72, 0x90, 0x86, 0xe2, 0xcc, 0x80, 0x6e, 0x82, 0x8a,
+      0x84, 0x87, 0x7f, 0x1e, 0xb8, 0xe5, 0xd9, 0x74, 0xd8, 0x73, 0xe0, 0x65, 0x22, 0x49, 0x01, 0x55,
+      0x5f, 0xb8, 0x82, 0x15, 0x90, 0xa3, 0x3b, 0xac, 0xc6, 0x1e, 0x39, 0x70, 0x1c, 0xf9, 0xb4, 0x6b,
+      0xd2, 0x5b, 0xf5, 0xf0, 0x59, 0x5b, 0xbe, 0x24, 0x65, 0x51, 0x41, 0x43, 0x8e, 0x7a, 0x10, 0x0b },
+    { 0x92, 0xa0, 0x09, 0xa9, 0xf0, 0xd4, 0xca, 0xb8, 0x72, 0x0e, 0x82, 0x0b, 0x5f, 0x64, 0x25, 0x40,
+      0xa2, 0xb2, 0x7b, 0x54, 0x16, 0x50, 0x3f, 0x8f, 0xb3, 0x76, 0x22, 0x23, 0xeb, 0xdb, 0x69, 0xda,
+      0x08, 0x5a, 0xc1, 0xe4, 0x3e, 0x15, 0x99, 0x6e, 0x45, 0x8f, 0x36, 0x13, 0xd0, 0xf1, 0x1d, 0x8c,
+      0x38, 0x7b, 0x2e, 0xae, 0xb4, 0x30, 0x2a, 0xee, 0xb0, 0x0d, 0x29, 0x16, 0x12, 0xbb, 0x0c, 0x00 }
+  };
+  static const uint8_t aMessage2[1] = { 0x72 };
+  uint32_t cycles;
+
+  if (!Ed25519_Verify(aSignatures[0], aKeys[0], aMessage2, 0))
+  {
+    return 0;
+  }
+  cycles = Prof_Now();
+  if (!Ed25519_Verify(aSignatures[1], aKeys[1], aMessage2, 1))
+  {
+    return 0;
+  }
+  cycles = Prof_Now() - cycles;
+  /* Another message must be rejected */
+  if (Ed25519_Verify(aSignatures[1], aKeys[1], aKeys[1], 1))
+  {
+    return 0;
+  }
+  return cycles;
+}
+#endif /* IAP_PROFILE */
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
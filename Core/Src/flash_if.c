@@ -43,11 +43,21 @@
 #include "flash_if.h"
 #include "stdio.h"
 #include "main.h"
+#include "partition.h"
+#include "string.h"
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
+/* Write combining stream: one row of the Flash assembled in RAM */
+static uint32_t aStreamRow[FLASH_ROW_SIZE / 4];
+static uint32_t StreamRow;     /* Flash address of the row in aStreamRow */
+static uint32_t StreamFill;    /* Bytes of the row buffered, from the row start */
+static uint32_t StreamDone;    /* Bytes of the row already programmed */
+static uint32_t StreamStatus;  /* First error met since FLASH_If_StreamOpen */
+
 /* Private function prototypes -----------------------------------------------*/
+static uint32_t FLASH_If_StreamProgram(uint32_t end);
 
 /* Private functions ---------------------------------------------------------*/
 
@@ -86,36 +96,53 @@ static uint32_t GetPage(uint32_t Addr)
   *         FLASHIF_ERASEKO : error occurred
   */
 uint32_t FLASH_If_Erase(uint32_t start)
+{
+  uint32_t end = Part_Address(PART_TYPE_APP) + Part_Size(PART_TYPE_APP);
+
+  /* From start to the end of the application slot */
+  if (start >= end)
+  {
+    return FLASHIF_ERASEKO;
+  }
+  return FLASH_If_EraseRange(start, end - start);
+}	
+
+/**
+  * @brief  This function erases the pages covering a flash area
+  * @param  start: start of the area, page aligned
+  * @param  length: length of the area in bytes
+  * @retval FLASHIF_OK : area successfully erased
+  *         FLASHIF_ERASEKO : error occurred or area overlaps the IAP code
+  */
+uint32_t FLASH_If_EraseRange(uint32_t start, uint32_t length)
 {
   FLASH_EraseInitTypeDef EraseInitStruct = {0};
-  uint32_t FirstPage = 0;
+  uint32_t PageError = 0;
   uint32_t result = FLASHIF_OK;
 
-  HAL_FLASH_Unlock();
-  
-  FirstPage = GetPage(start);
-  /* Get the number of pages to erase from 1st page */
+  /* Never touch the IAP code nor the other read only slots */
+  if (!Part_IsWritable(start, length))
+  {
+    return FLASHIF_ERASEKO;
+  }
+  if (length == 0)
+  {
+    return FLASHIF_OK;
+  }
 
-  /* Fill EraseInit structure*/
   EraseInitStruct.TypeErase   = FLASH_TYPEERASE_PAGES;
-  EraseInitStruct.Page        = FirstPage;
-  EraseInitStruct.NbPages = GetPage(USER_FLASH_END_ADDRESS) - FirstPage;
-
+  EraseInitStruct.Page        = GetPage(start);
+  EraseInitStruct.NbPages     = GetPage(start + length - 1) - EraseInitStruct.Page + 1;
 
-/* NOTE: Following implementation expects the IAP code address to be < Application address */  
-
-  if (EraseInitStruct.Page > 7 )
+  HAL_FLASH_Unlock();
+  if (HAL_FLASHEx_Erase(&EraseInitStruct, &PageError) != HAL_OK)
   {
-    if (HAL_FLASHEx_Erase(&EraseInitStruct, &result) != HAL_OK)
-    {
-      result = FLASHIF_ERASEKO;
-    }
+    result = FLASHIF_ERASEKO;
   }
-  
   HAL_FLASH_Lock();
 
   return result;
-}	
+}
 
 /* Public functions ---------------------------------------------------------*/
 /**
@@ -133,6 +160,11 @@ uint32_t FLASH_If_Write(uint32_t destination, uint32_t *p_source, uint32_t lengt
   uint32_t status = FLASHIF_OK;
   uint32_t *p_actual = p_source; /* Temporary pointer to data that will be written in a half-page space */
   uint64_t dw_write_buff=0;
+
+  if (!Part_IsWritable(destination, length * 4))
+  {
+    return FLASHIF_PROTECTION_ERRROR;
+  }
   HAL_FLASH_Unlock();
     
   /* Write the buffer to the memory */
@@ -167,6 +199,178 @@ uint32_t FLASH_If_Write(uint32_t destination, uint32_t *p_source, uint32_t lengt
   return status;
 }	
 
+/**
+  * @brief  Checks whether a flash area is in the erased state.
+  * @param  start: start address, 32-bit aligned
+  * @param  length: length of the area in bytes, multiple of 4
+  * @retval 1 if every byte reads 0xFF, 0 otherwise
+  */
+uint32_t FLASH_If_IsErased(uint32_t start, uint32_t length)
+{
+  const uint32_t *p_word = (const uint32_t *)start;
+  const uint32_t *p_end = (const uint32_t *)(start + length);
+
+  while (p_word < p_end)
+  {
+    if (*p_word++ != 0xFFFFFFFFU)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+  * @brief  Returns the extent of the programmed data in a flash area.
+  * @note   Whole erased pages are skipped from the end of the area first, so
+  *         an image in the first pages is found without reading the rest. The
+  *         result is rounded up to the doubleword programming granularity.
+  * @param  start: start address of the area, page aligned
+  * @param  size: size of the area in bytes, multiple of FLASH_PAGE_SIZE
+  * @retval Number of bytes up to and including the last programmed doubleword
+  */
+uint32_t FLASH_If_GetImageSize(uint32_t start, uint32_t size)
+{
+  const uint64_t *p_dword;
+
+  /* Last page holding data */
+  while ((size != 0) && FLASH_If_IsErased(start + size - FLASH_PAGE_SIZE, FLASH_PAGE_SIZE))
+  {
+    size -= FLASH_PAGE_SIZE;
+  }
+
+  /* Last doubleword holding data in that page */
+  p_dword = (const uint64_t *)(start + size);
+  while ((size != 0) && (*--p_dword == 0xFFFFFFFFFFFFFFFFULL))
+  {
+    size -= 8;
+  }
+  return size;
+}
+
+/**
+  * @brief  Program the buffered row up to an offset
+  * @note   A whole row over erased Flash goes with one fast programming
+  *         operation, anything else doubleword by doubleword.
+  *         Fast programming must not fetch from the Flash: the HAL Flash
+  *         driver is placed in IRAM1 by its file options in the project.
+  * @param  end: offset in the row, multiple of 8
+  * @retval FLASHIF_OK or the first error met
+  */
+static uint32_t FLASH_If_StreamProgram(uint32_t end)
+{
+  uint32_t status = FLASHIF_OK;
+
+  if (end <= StreamDone)
+  {
+    return StreamStatus;
+  }
+  if ((StreamDone == 0) && (end == FLASH_ROW_SIZE) && FLASH_If_IsErased(StreamRow, FLASH_ROW_SIZE))
+  {
+    if (!Part_IsWritable(StreamRow, FLASH_ROW_SIZE))
+    {
+      status = FLASHIF_PROTECTION_ERRROR;
+    }
+    else
+    {
+      HAL_FLASH_Unlock();
+      if (HAL_FLASH_Program(FLASH_TYPEPROGRAM_FAST, StreamRow, (uint32_t)aStreamRow) != HAL_OK)
+      {
+        status = FLASHIF_WRITING_ERROR;
+      }
+      HAL_FLASH_Lock();
+      if ((status == FLASHIF_OK) && (memcmp((const void *)StreamRow, aStreamRow, FLASH_ROW_SIZE) != 0))
+      {
+        /* flash content doesn't match memBuffer */
+        status = FLASHIF_WRITINGCTRL_ERROR;
+      }
+    }
+  }
+  else
+  {
+    status = FLASH_If_Write(StreamRow + StreamDone, &aStreamRow[StreamDone / 4], (end - StreamDone) / 4);
+  }
+  StreamDone = end;
+
+  if (StreamStatus == FLASHIF_OK)
+  {
+    StreamStatus = status;
+  }
+  return StreamStatus;
+}
+
+/**
+  * @brief  Start streaming bytes to erased Flash
+  * @note   The destination needs no alignment. The doubleword it falls in
+  *         must be erased: the bytes before it are programmed as 0xFF.
+  * @param  destination: Flash address of the first byte
+  * @retval None
+  */
+void FLASH_If_StreamOpen(uint32_t destination)
+{
+  StreamRow = destination & ~(FLASH_ROW_SIZE - 1);
+  StreamFill = destination - StreamRow;
+  StreamDone = StreamFill & ~7U;
+  StreamStatus = FLASHIF_OK;
+  memset(aStreamRow, 0xFF, sizeof(aStreamRow));
+}
+
+/**
+  * @brief  Stream bytes to Flash, each row is programmed once it is full
+  * @param  p_data: bytes to write, any alignment
+  * @param  length: number of bytes
+  * @retval FLASHIF_OK or the first error met since FLASH_If_StreamOpen
+  */
+uint32_t FLASH_If_StreamWrite(const uint8_t *p_data, uint32_t length)
+{
+  uint32_t chunk;
+
+  while (length != 0)
+  {
+    chunk = FLASH_ROW_SIZE - StreamFill;
+    if (chunk > length)
+    {
+      chunk = length;
+    }
+    memcpy((uint8_t *)aStreamRow + StreamFill, p_data, chunk);
+    StreamFill += chunk;
+    p_data += chunk;
+    length -= chunk;
+
+    if (StreamFill == FLASH_ROW_SIZE)
+    {
+      FLASH_If_StreamProgram(FLASH_ROW_SIZE);
+      StreamRow += FLASH_ROW_SIZE;
+      StreamFill = 0;
+      StreamDone = 0;
+      memset(aStreamRow, 0xFF, sizeof(aStreamRow));
+    }
+  }
+  return StreamStatus;
+}
+
+/**
+  * @brief  Program every complete doubleword buffered so far
+  * @note   The last bytes of an incomplete doubleword stay buffered: a
+  *         doubleword can only be programmed once.
+  * @param  None
+  * @retval FLASHIF_OK or the first error met since FLASH_If_StreamOpen
+  */
+uint32_t FLASH_If_StreamFlush(void)
+{
+  return FLASH_If_StreamProgram(StreamFill & ~7U);
+}
+
+/**
+  * @brief  End the stream, the last doubleword is completed with 0xFF
+  * @param  None
+  * @retval FLASHIF_OK or the first error met since FLASH_If_StreamOpen
+  */
+uint32_t FLASH_If_StreamClose(void)
+{
+  return FLASH_If_StreamProgram((StreamFill + 7U) & ~7U);
+}
+
 ///**
 //  * @brief  Returns the write protection status of application flash area.
 //  * @param  None
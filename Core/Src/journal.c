@@ -0,0 +1,278 @@
+/**
+  ******************************************************************************
+  * @file    journal.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the download progress journal: an append only
+  *          log of doubleword records in the journal slot, so that a download
+  *          cut short resumes at the last programmed page instead of starting
+  *          over. The page is only erased when it is full or invalid.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "journal.h"
+#include "partition.h"
+#include "flash_if.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define JOURNAL_RECORD_SIZE     ((uint32_t)8)
+
+/* Private macro -------------------------------------------------------------*/
+#define JOURNAL_TAG(w1)         ((w1) >> 24)
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t JournalNext;      /* Address of the next free record */
+static uint32_t JournalIdentity;  /* Second word of the open image record, 0 if none */
+static uint32_t JournalSize;      /* First word of the open image record */
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Journal_Append(uint32_t w0, uint32_t w1);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Append one record, starting a fresh page with the image record
+  *         when the page is full
+  * @param  w0: first word
+  * @param  w1: second word, tag in the top byte
+  * @retval FLASHIF_OK if the record is written
+  */
+static uint32_t Journal_Append(uint32_t w0, uint32_t w1)
+{
+  uint32_t start = Part_Address(PART_TYPE_JOURNAL);
+  uint32_t end = start + Part_Size(PART_TYPE_JOURNAL);
+  uint32_t record[2];
+
+  if (start == 0)
+  {
+    return FLASHIF_ERASEKO;
+  }
+  if ((JournalNext < start) || ((JournalNext + JOURNAL_RECORD_SIZE) > end))
+  {
+    if (FLASH_If_EraseRange(start, end - start) != FLASHIF_OK)
+    {
+      return FLASHIF_ERASEKO;
+    }
+    JournalNext = start;
+    if ((JOURNAL_TAG(w1) != JOURNAL_TAG_IMAGE) && (JournalIdentity != 0))
+    {
+      Journal_Append(JournalSize, JournalIdentity);
+    }
+  }
+
+  record[0] = w0;
+  record[1] = w1;
+  JournalNext += JOURNAL_RECORD_SIZE;
+  return FLASH_If_Write(JournalNext - JOURNAL_RECORD_SIZE, record, 2);
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Start journaling the download of an image
+  * @note   The journal is scanned up to the first erased record. When its
+  *         last image record matches and the image was not completed, the
+  *         progress recorded since is returned and journaling goes on.
+  *         Otherwise a new image record is appended.
+  * @param  type: partition slot the image is written to
+  * @param  size: image size from the YMODEM header
+  * @param  header_crc: CRC16 of the YMODEM header packet
+  * @retval Bytes already programmed and verified, 0 to start over
+  */
+uint32_t Journal_Open(uint8_t type, uint32_t size, uint16_t header_crc)
+{
+  uint32_t start = Part_Address(PART_TYPE_JOURNAL);
+  uint32_t end = start + Part_Size(PART_TYPE_JOURNAL);
+  uint32_t address, w0, w1, identity, matched = 0, resume = 0;
+
+  JournalNext = 0;
+  if (start == 0)
+  {
+    return 0;
+  }
+
+  identity = (JOURNAL_TAG_IMAGE << 24) | ((uint32_t)type << 16) | header_crc;
+  for (address = start; address < end; address += JOURNAL_RECORD_SIZE)
+  {
+    w0 = *(__IO uint32_t *)address;
+    w1 = *(__IO uint32_t *)(address + 4);
+    if ((w0 == 0xFFFFFFFFU) && (w1 == 0xFFFFFFFFU))
+    {
+      break;
+    }
+    switch (JOURNAL_TAG(w1))
+    {
+      case JOURNAL_TAG_IMAGE:
+        matched = (w1 == identity) && (w0 == size);
+        resume = 0;
+        break;
+      case JOURNAL_TAG_PROGRESS:
+        if (matched && (w0 > resume))
+        {
+          resume = w0;
+        }
+        break;
+      case JOURNAL_TAG_VERIFIED:
+        /* Written at boot, says nothing about a download */
+        break;
+      default:
+        matched = 0;
+        resume = 0;
+        break;
+    }
+  }
+  JournalNext = address;
+  JournalIdentity = identity;
+  JournalSize = size;
+
+  /* A record not ending with an erased doubleword can not be trusted */
+  if ((address < end) && !FLASH_If_IsErased(address, end - address))
+  {
+    JournalNext = end;
+    matched = 0;
+  }
+
+  if (!matched)
+  {
+    resume = 0;
+    Journal_Append(size, identity);
+  }
+  return resume;
+}
+
+/**
+  * @brief  Record that the image is programmed and verified up to an offset
+  * @param  offset: bytes from the start of the slot, page aligned
+  * @retval None
+  */
+void Journal_Progress(uint32_t offset)
+{
+  Journal_Append(offset, JOURNAL_TAG_PROGRESS << 24);
+}
+
+/**
+  * @brief  Take back the progress recorded beyond an offset
+  * @note   The image record is written again: Journal_Open() keeps the
+  *         highest progress after the last one.
+  * @param  offset: bytes still valid from the start of the slot, page aligned
+  * @retval None
+  */
+void Journal_Rewind(uint32_t offset)
+{
+  if (JournalIdentity != 0)
+  {
+    Journal_Append(JournalSize, JournalIdentity);
+    if (offset > 0)
+    {
+      Journal_Progress(offset);
+    }
+  }
+}
+
+/**
+  * @brief  Record that the image is complete, the next download starts over
+  * @param  None
+  * @retval None
+  */
+void Journal_Close(void)
+{
+  Journal_Append(0, JOURNAL_TAG_DONE << 24);
+}
+
+/**
+  * @brief  Forget any progress, the next download starts over
+  * @param  None
+  * @retval None
+  */
+void Journal_Invalidate(void)
+{
+  uint32_t start = Part_Address(PART_TYPE_JOURNAL);
+
+  if (start != 0)
+  {
+    FLASH_If_EraseRange(start, Part_Size(PART_TYPE_JOURNAL));
+  }
+  JournalNext = start;
+}
+
+/**
+  * @brief  Record that the application passed its signature check
+  * @note   Called at boot as well, when no download is journaled: the end of
+  *         the journal is looked up first.
+  * @param  size: bytes checked from the start of the application slot
+  * @param  crc: CRC-32 of these bytes, see Digest_Crc32()
+  * @retval None
+  */
+void Journal_Verified(uint32_t size, uint32_t crc)
+{
+  uint32_t start = Part_Address(PART_TYPE_JOURNAL);
+  uint32_t end = start + Part_Size(PART_TYPE_JOURNAL);
+
+  if ((JournalNext == 0) && (start != 0))
+  {
+    JournalNext = start;
+    while ((JournalNext < end) && !FLASH_If_IsErased(JournalNext, JOURNAL_RECORD_SIZE))
+    {
+      JournalNext += JOURNAL_RECORD_SIZE;
+    }
+    if (!FLASH_If_IsErased(JournalNext, end - JournalNext))
+    {
+      JournalNext = end;
+    }
+  }
+  Journal_Append(crc, (JOURNAL_TAG_VERIFIED << 24) | (size & 0x00FFFFFFU));
+}
+
+/**
+  * @brief  Look up the last signature check of the application
+  * @note   A download to the application slot since then, even an
+  *         interrupted one, voids the record: the CRC-32 alone could be
+  *         matched on purpose.
+  * @param  p_size: receives the bytes checked
+  * @param  p_crc: receives their CRC-32
+  * @retval 1 if a valid record is found, 0 otherwise
+  */
+uint32_t Journal_GetVerified(uint32_t *p_size, uint32_t *p_crc)
+{
+  uint32_t start = Part_Address(PART_TYPE_JOURNAL);
+  uint32_t end = start + Part_Size(PART_TYPE_JOURNAL);
+  uint32_t address, w0, w1, found = 0;
+
+  if (start == 0)
+  {
+    return 0;
+  }
+  for (address = start; address < end; address += JOURNAL_RECORD_SIZE)
+  {
+    w0 = *(__IO uint32_t *)address;
+    w1 = *(__IO uint32_t *)(address + 4);
+    if ((w0 == 0xFFFFFFFFU) && (w1 == 0xFFFFFFFFU))
+    {
+      break;
+    }
+    if ((JOURNAL_TAG(w1) == JOURNAL_TAG_IMAGE) && (((w1 >> 16) & 0xFF) == PART_TYPE_APP))
+    {
+      found = 0;
+    }
+    else if (JOURNAL_TAG(w1) == JOURNAL_TAG_VERIFIED)
+    {
+      *p_size = w1 & 0x00FFFFFFU;
+      *p_crc = w0;
+      found = 1;
+    }
+  }
+  return found;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
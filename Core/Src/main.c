@@ -27,6 +27,14 @@
 #include "usart.h"
 #include "crc.h"
 #include "gpio.h"
+#include "dma.h"
+#include "partition.h"
+#include "verify.h"
+#include "stage.h"
+#include "serial_rx.h"
+#include "boot_time.h"
+#include "boot_select.h"
+#include "string.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -36,12 +44,16 @@
 
 /* Private define ------------------------------------------------------------*/
 /* USER CODE BEGIN PD */
-
+#define BOOT_VECTORS            48U   /* Room for the most a Cortex-M0+ has: 16 system, 32 peripheral */
 /* USER CODE END PD */
 
 /* Private macro -------------------------------------------------------------*/
 /* USER CODE BEGIN PM */
-
+#if defined(__CC_ARM)
+#define BOOT_AT_SRAM            __attribute__((at(0x20000000), zero_init))
+#else
+#define BOOT_AT_SRAM            __attribute__((section(".bss.ARM.__at_0x20000000")))
+#endif
 /* USER CODE END PM */
 
 /* Private variables ---------------------------------------------------------*/
@@ -49,17 +61,44 @@
 /* USER CODE BEGIN PV */
 extern pFunction JumpToApplication;
 extern uint32_t JumpAddress;
+extern const uint32_t __Vectors[];
+extern const uint32_t __Vectors_End[];
+/* Vector table in use once main has copied it: the interrupts are still taken
+   while the Flash is busy */
+static uint32_t aRamVectors[BOOT_VECTORS] BOOT_AT_SRAM;
 /* USER CODE END PV */
 
 /* Private function prototypes -----------------------------------------------*/
 void SystemClock_Config(void);
 /* USER CODE BEGIN PFP */
-
+static uint32_t Boot_TakeRequest(void);
 /* USER CODE END PFP */
 
 /* Private user code ---------------------------------------------------------*/
 /* USER CODE BEGIN 0 */
 
+/**
+  * @brief  Read and clear the boot request left by the application
+  * @param  None
+  * @retval BOOT_REQUEST_MENU, BOOT_REQUEST_DOWNLOAD or anything else for none
+  */
+static uint32_t Boot_TakeRequest(void)
+{
+  uint32_t request;
+
+  __HAL_RCC_PWR_CLK_ENABLE();
+  __HAL_RCC_RTCAPB_CLK_ENABLE();
+  request = TAMP->BKP0R;
+  if (request != 0)
+  {
+    HAL_PWR_EnableBkUpAccess();
+    TAMP->BKP0R = 0;
+    HAL_PWR_DisableBkUpAccess();
+  }
+  __HAL_RCC_RTCAPB_CLK_DISABLE();
+  return request;
+}
+
 /* USER CODE END 0 */
 
 /**
@@ -69,7 +108,14 @@ void SystemClock_Config(void);
 int main(void)
 {
   /* USER CODE BEGIN 1 */
+  uint32_t request;
 
+  /* The table of the startup file, after the scatter-loading that cleared
+     aRamVectors: SystemInit leaves VTOR on the Flash */
+  memcpy(aRamVectors, __Vectors, (uint32_t)__Vectors_End - (uint32_t)__Vectors);
+  SCB->VTOR = (uint32_t)aRamVectors;
+  __DSB();
+  BootTime_Mark(BOOT_PHASE_RESET);
   /* USER CODE END 1 */
 
   /* MCU Configuration--------------------------------------------------------*/
@@ -78,6 +124,7 @@ int main(void)
   HAL_Init();
 
   /* USER CODE BEGIN Init */
+  BootTime_Mark(BOOT_PHASE_HAL);
   /* USER CODE END Init */
 
   /* Configure the system clock */
@@ -89,35 +136,58 @@ int main(void)
   /* USER CODE BEGIN 2 */
   MX_GPIO_Init();
   HAL_GPIO_WritePin(LED_GREEN_GPIO_Port, LED_GREEN_Pin, GPIO_PIN_RESET);
-  /* update if Key push-button on NUCLEO-G070RB is pressed */
-  if (HAL_GPIO_ReadPin(KEY_GPIO_Port, KEY_Pin) == GPIO_PIN_RESET)
+  BootTime_Mark(BOOT_PHASE_GPIO);
+  /* Flash layout, read once */
+  Part_Init();
+  /* Start the application unless it asked for the IAP, the Key push-button
+     on NUCLEO-G070RB is pressed, it is missing or its signature does not
+     check */
+  request = Boot_TakeRequest();
+  BootTime_Input(BootSelect_Early(request, HAL_GPIO_ReadPin(KEY_GPIO_Port, KEY_Pin)));
+  BootTime_Mark(BOOT_PHASE_KEY);
+  if (BOOT_TIME->inputs == 0)
   {
-    /* Initialise Flash */
+    SystemClock_Config();
+    BootTime_Clock();
+    BootTime_Mark(BOOT_PHASE_CLOCK);
     FLASH_If_Init();
-    /* Execute the IAP driver in order to reprogram the Flash */
-    MX_USART2_UART_Init();  
     MX_CRC_Init();
-    /* Display main menu */
-    Main_Menu ();
-    
-  }
-  else
-  {
-      SystemClock_Config();
+    /* An update staged by the application replaces it first */
+    Stage_Install();
 
-      __disable_irq();
-      /* Test if user code is programmed starting from address "APPLICATION_ADDRESS" */
-    if (((*(__IO uint32_t*)APPLICATION_ADDRESS) & 0x2FFE0000 ) == 0x20000000)
+    /* Test if user code is programmed starting from the application slot */
+    BootTime_Input(BootSelect_Image(*(__IO uint32_t*)Part_Address(PART_TYPE_APP), Verify_Boot));
+    BootTime_Mark(BOOT_PHASE_CHECK);
+    if (BOOT_TIME->inputs == 0)
     {
+      __disable_irq();
+      BootTime_Jump();
       /* Jump to user application */
-      JumpAddress = *(__IO uint32_t*) (APPLICATION_ADDRESS + 4);
+      JumpAddress = *(__IO uint32_t*) (Part_Address(PART_TYPE_APP) + 4);
       JumpToApplication = (pFunction) JumpAddress;
       /* Initialize user application's Stack Pointer */
-      __set_MSP(*(__IO uint32_t*) APPLICATION_ADDRESS);
+      __set_MSP(*(__IO uint32_t*) Part_Address(PART_TYPE_APP));
       JumpToApplication();
     }
   }
-  
+
+  BootTime_Stop();
+  /* Initialise Flash */
+  FLASH_If_Init();
+  /* Execute the IAP driver in order to reprogram the Flash */
+  MX_DMA_Init();
+  /* Baud rate kept while the core clock is lowered, see Main_IdleClock */
+  __HAL_RCC_USART2_CONFIG(RCC_USART2CLKSOURCE_HSI);
+  MX_USART2_UART_Init();  
+  Serial_RxStart();
+  MX_CRC_Init();
+  /* Remote update: no menu, the sender is already waiting */
+  if (request == BOOT_REQUEST_DOWNLOAD)
+  {
+    Main_Download();
+  }
+  /* Display main menu */
+  Main_Menu ();
   
   /* USER CODE END 2 */
 
@@ -0,0 +1,293 @@
+/**
+  ******************************************************************************
+  * @file    manifest.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the page manifest of a download: a hash tree
+  *          whose leaves are the Flash pages of the image, signed at the
+  *          root. The leaves are received before the image, so that each
+  *          page is checked as its last block arrives, before it is
+  *          programmed, and the pages kept by a resumed download are
+  *          checked in Flash instead of being trusted blindly.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "manifest.h"
+#include "sha256.h"
+#include "verify.h"
+#include "flash_if.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define MANIFEST_MAX_LEAVES     ((USER_FLASH_END_ADDRESS - APPLICATION_ADDRESS) / FLASH_PAGE_SIZE)
+#define MANIFEST_SIGNED_SIZE    ((uint32_t)16)   /* Header bytes covered by the signature */
+#define MANIFEST_LEAF_PREFIX    ((uint8_t)0x00)
+#define MANIFEST_NODE_PREFIX    ((uint8_t)0x01)
+
+/* Private macro -------------------------------------------------------------*/
+#define MANIFEST_HEADER         ((const Manifest_HeaderTypeDef *)aManifest)
+#define MANIFEST_LEAF(index)    (&aManifest[MANIFEST_HEADER_SIZE + (index) * SHA256_DIGEST_SIZE])
+
+/* Private variables ---------------------------------------------------------*/
+/* @note Word aligned: the header is read in place */
+static uint32_t aManifestWords[(MANIFEST_HEADER_SIZE + MANIFEST_MAX_LEAVES * SHA256_DIGEST_SIZE) / 4];
+static uint8_t * const aManifest = (uint8_t *)aManifestWords;
+static uint8_t aNodes[(MANIFEST_MAX_LEAVES + 1) / 2][SHA256_DIGEST_SIZE];
+static uint32_t ManifestFill;     /* Bytes received, padding included */
+static uint32_t ManifestSize;     /* Bytes of the manifest, padding included, 0 until known */
+static Sha256_CtxTypeDef PageHash; /* Of the page being received */
+static uint32_t VerifiedEnd;      /* Image bytes checked against their leaves */
+
+/* Private function prototypes -----------------------------------------------*/
+static void Manifest_Node(uint8_t *p_out, const uint8_t *p_left, const uint8_t *p_right);
+static void Manifest_Root(uint8_t *p_root);
+static void Manifest_Leaf(uint8_t *p_leaf, const uint8_t *p_page, uint32_t length);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Hash two nodes into their parent
+  * @param  p_out: receives the parent, may be one of the children
+  * @param  p_left: left child
+  * @param  p_right: right child
+  * @retval None
+  */
+static void Manifest_Node(uint8_t *p_out, const uint8_t *p_left, const uint8_t *p_right)
+{
+  static const uint8_t prefix = MANIFEST_NODE_PREFIX;
+  Sha256_CtxTypeDef ctx;
+
+  Sha256_Init(&ctx);
+  Sha256_Update(&ctx, &prefix, 1);
+  Sha256_Update(&ctx, p_left, SHA256_DIGEST_SIZE);
+  Sha256_Update(&ctx, p_right, SHA256_DIGEST_SIZE);
+  Sha256_Final(&ctx, p_out);
+}
+
+/**
+  * @brief  Root of the tree of the received leaves, built level by level in
+  *         aNodes
+  * @param  p_root: receives the root
+  * @retval None
+  */
+static void Manifest_Root(uint8_t *p_root)
+{
+  const uint8_t *p_level = MANIFEST_LEAF(0);
+  uint32_t count = MANIFEST_HEADER->leaves;
+  uint32_t i, next;
+
+  while (count > 1)
+  {
+    next = 0;
+    for (i = 0; (i + 1) < count; i += 2)
+    {
+      Manifest_Node(aNodes[next++], &p_level[i * SHA256_DIGEST_SIZE], &p_level[(i + 1) * SHA256_DIGEST_SIZE]);
+    }
+    if (count & 1)
+    {
+      memmove(aNodes[next++], &p_level[(count - 1) * SHA256_DIGEST_SIZE], SHA256_DIGEST_SIZE);
+    }
+    p_level = aNodes[0];
+    count = next;
+  }
+  memcpy(p_root, p_level, SHA256_DIGEST_SIZE);
+}
+
+/**
+  * @brief  Leaf of a page
+  * @param  p_leaf: receives the leaf
+  * @param  p_page: page data
+  * @param  length: bytes of the image in the page, FLASH_PAGE_SIZE but for
+  *         the last page
+  * @retval None
+  */
+static void Manifest_Leaf(uint8_t *p_leaf, const uint8_t *p_page, uint32_t length)
+{
+  static const uint8_t prefix = MANIFEST_LEAF_PREFIX;
+  Sha256_CtxTypeDef ctx;
+
+  Sha256_Init(&ctx);
+  Sha256_Update(&ctx, &prefix, 1);
+  Sha256_Update(&ctx, p_page, length);
+  Sha256_Final(&ctx, p_leaf);
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Wait for the manifest of a new file
+  * @param  None
+  * @retval None
+  */
+void Manifest_Start(void)
+{
+  ManifestFill = 0;
+  ManifestSize = 0;
+  VerifiedEnd = 0;
+}
+
+/**
+  * @brief  Take the next block of the manifest
+  * @note   The signature is checked when the last block arrives.
+  * @param  p_data: block data, 32-bit aligned
+  * @param  length: block length, a multiple of 128 bytes
+  * @retval Manifest_StatusTypeDef
+  */
+Manifest_StatusTypeDef Manifest_Receive(const uint8_t *p_data, uint32_t length)
+{
+  const Manifest_HeaderTypeDef *p_header = (const Manifest_HeaderTypeDef *)p_data;
+  uint8_t signed_part[MANIFEST_SIGNED_SIZE + SHA256_DIGEST_SIZE];
+  uint32_t used, chunk;
+
+  if (ManifestFill == 0)
+  {
+    if ((length < MANIFEST_HEADER_SIZE) || (p_header->magic != MANIFEST_MAGIC) ||
+        (p_header->version != MANIFEST_VERSION) || (p_header->leaves == 0) ||
+        (p_header->leaves > MANIFEST_MAX_LEAVES) ||
+        (p_header->leaves != ((p_header->length + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE)))
+    {
+      return MANIFEST_FORMAT;
+    }
+    used = MANIFEST_HEADER_SIZE + p_header->leaves * SHA256_DIGEST_SIZE;
+    ManifestSize = (used + MANIFEST_ALIGN - 1) & ~(MANIFEST_ALIGN - 1);
+  }
+
+  /* The padding is only counted */
+  used = MANIFEST_HEADER_SIZE + ((ManifestFill == 0) ? p_header->leaves : MANIFEST_HEADER->leaves) * SHA256_DIGEST_SIZE;
+  if (ManifestFill < used)
+  {
+    chunk = ((used - ManifestFill) < length) ? (used - ManifestFill) : length;
+    memcpy(&aManifest[ManifestFill], p_data, chunk);
+  }
+  ManifestFill += length;
+  if (ManifestFill < ManifestSize)
+  {
+    return MANIFEST_MORE;
+  }
+  if (ManifestFill != ManifestSize)
+  {
+    return MANIFEST_FORMAT;
+  }
+
+  memcpy(signed_part, aManifest, MANIFEST_SIGNED_SIZE);
+  Manifest_Root(&signed_part[MANIFEST_SIGNED_SIZE]);
+  if (!Verify_Signature(MANIFEST_HEADER->signature, signed_part, sizeof(signed_part)))
+  {
+    return MANIFEST_SIGNATURE;
+  }
+  return MANIFEST_DONE;
+}
+
+/**
+  * @brief  Bytes of the file taken by the manifest
+  * @param  None
+  * @retval Size, padding included, 0 before its first block
+  */
+uint32_t Manifest_Size(void)
+{
+  return ManifestSize;
+}
+
+/**
+  * @brief  Length of the image the manifest describes
+  * @param  None
+  * @retval Image bytes
+  */
+uint32_t Manifest_ImageLength(void)
+{
+  return MANIFEST_HEADER->length;
+}
+
+/**
+  * @brief  Check the pages a resumed download kept in Flash
+  * @param  start: address of the image
+  * @param  length: bytes kept, page aligned
+  * @retval Bytes from start whose pages match their leaves, page aligned
+  */
+uint32_t Manifest_CheckFlash(uint32_t start, uint32_t length)
+{
+  uint8_t leaf[SHA256_DIGEST_SIZE];
+  uint32_t offset, page_length;
+
+  for (offset = 0; (offset < length) && (offset < MANIFEST_HEADER->length); offset += FLASH_PAGE_SIZE)
+  {
+    page_length = MANIFEST_HEADER->length - offset;
+    if (page_length > FLASH_PAGE_SIZE)
+    {
+      page_length = FLASH_PAGE_SIZE;
+    }
+    Manifest_Leaf(leaf, (const uint8_t *)(start + offset), page_length);
+    if (memcmp(leaf, MANIFEST_LEAF(offset / FLASH_PAGE_SIZE), SHA256_DIGEST_SIZE) != 0)
+    {
+      break;
+    }
+  }
+  VerifiedEnd = (offset < length) ? offset : length;
+  return VerifiedEnd;
+}
+
+/**
+  * @brief  Take the next block of the image
+  * @note   Blocks come in order from a page boundary. A block completing a
+  *         page is taken only if the page matches its leaf: otherwise the
+  *         page hash is left as before the block, for the block to be
+  *         received again.
+  * @param  offset: offset of the block in the image
+  * @param  p_data: block data
+  * @param  length: image bytes in the block
+  * @retval 1 if the block is taken, 0 if it completes a page that does not
+  *         match
+  */
+uint32_t Manifest_CheckBlock(uint32_t offset, const uint8_t *p_data, uint32_t length)
+{
+  static const uint8_t prefix = MANIFEST_LEAF_PREFIX;
+  Sha256_CtxTypeDef page;
+  uint8_t leaf[SHA256_DIGEST_SIZE];
+  uint32_t end = offset + length;
+
+  if (length == 0)
+  {
+    return 1;
+  }
+  if ((offset % FLASH_PAGE_SIZE) == 0)
+  {
+    Sha256_Init(&PageHash);
+    Sha256_Update(&PageHash, &prefix, 1);
+  }
+  page = PageHash;
+  Sha256_Update(&page, p_data, length);
+  if (((end % FLASH_PAGE_SIZE) == 0) || (end >= MANIFEST_HEADER->length))
+  {
+    Sha256_Final(&page, leaf);
+    if (memcmp(leaf, MANIFEST_LEAF(offset / FLASH_PAGE_SIZE), SHA256_DIGEST_SIZE) != 0)
+    {
+      return 0;
+    }
+    VerifiedEnd = end;
+  }
+  PageHash = page;
+  return 1;
+}
+
+/**
+  * @brief  Extent of the image checked against the manifest
+  * @param  None
+  * @retval Bytes from the start of the image
+  */
+uint32_t Manifest_Verified(void)
+{
+  return VerifiedEnd;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
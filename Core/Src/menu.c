@@ -24,6 +24,15 @@
 #include "flash_if.h"
 #include "menu.h"
 #include "ymodem.h"
+#include "prof.h"
+#include "trace.h"
+#include "partition.h"
+#include "digest.h"
+#include "verify.h"
+#include "chacha20.h"
+#include "serial_rx.h"
+#include "rpc.h"
+#include "string.h"
 
 /* Private typedef -----------------------------------------------------------*/
 /* Private define ------------------------------------------------------------*/
@@ -33,15 +42,209 @@ pFunction JumpToApplication;
 uint32_t JumpAddress;
 uint32_t FlashProtection = 0;
 uint8_t aFileName[FILE_NAME_LENGTH];
+uint8_t aFileDigest[SHA256_DIGEST_SIZE];
+static COM_StatsTypeDef DownloadStats;
 
 /* Private function prototypes -----------------------------------------------*/
 void SerialDownload(void);
 void SerialUpload(void);
+static void SerialSessionQuery(void);
+static void SerialPutStat(const char *p_label, uint32_t value, const char *p_unit);
+static void SerialPutHex(const uint8_t *p_data, uint32_t size);
+static void SerialSendStats(void);
+static void SerialDigest(void);
+static uint16_t SerialPutChecked(const uint8_t *p_data, uint32_t size, uint16_t crc);
 
 
 //#define Serial_PutString(...) (void)0
 /* Private functions ---------------------------------------------------------*/
 
+/**
+  * @brief  Print one statistics line on the HyperTerminal
+  * @param  p_label: text ahead of the value
+  * @param  value: value to print
+  * @param  p_unit: text after the value
+  * @retval None
+  */
+static void SerialPutStat(const char *p_label, uint32_t value, const char *p_unit)
+{
+  uint8_t number[11] = {0};
+
+  Int2Str(number, value);
+  Serial_PutString((uint8_t *)p_label);
+  Serial_PutString(number);
+  Serial_PutString((uint8_t *)p_unit);
+}
+
+/**
+  * @brief  Print bytes in hexadecimal on the HyperTerminal
+  * @param  p_data: bytes to print
+  * @param  size: number of bytes
+  * @retval None
+  */
+static void SerialPutHex(const uint8_t *p_data, uint32_t size)
+{
+  static const char aHex[] = "0123456789abcdef";
+  uint8_t text[2];
+
+  while (size--)
+  {
+    text[0] = aHex[*p_data >> 4];
+    text[1] = aHex[*p_data++ & 0x0F];
+    Serial_PutData(text, 2);
+  }
+}
+
+/**
+  * @brief  Send the statistics of the last download in binary form
+  * @note   Frame: STATS_MAGIC (LE), STATS_VERSION, sizeof(COM_StatsTypeDef),
+  *         two reserved bytes, the COM_StatsTypeDef (LE) and the CRC16 of all
+  *         previous bytes (MSB first, as in a YMODEM packet).
+  * @param  None
+  * @retval None
+  */
+static void SerialSendStats(void)
+{
+  uint8_t frame[8 + sizeof(COM_StatsTypeDef) + 2];
+  uint32_t magic = STATS_MAGIC, crc;
+
+  memcpy(frame, &magic, 4);
+  frame[4] = STATS_VERSION;
+  frame[5] = sizeof(COM_StatsTypeDef);
+  frame[6] = 0;
+  frame[7] = 0;
+  memcpy(&frame[8], &DownloadStats, sizeof(COM_StatsTypeDef));
+  crc = HAL_CRC_Calculate(&CrcHandle, (uint32_t *)frame, 8 + sizeof(COM_StatsTypeDef));
+  frame[8 + sizeof(COM_StatsTypeDef)] = (uint8_t)(crc >> 8);
+  frame[9 + sizeof(COM_StatsTypeDef)] = (uint8_t)(crc & 0xFF);
+  Serial_PutData(frame, sizeof(frame));
+}
+
+/**
+  * @brief  Send bytes and fold them in a running CRC16-XMODEM
+  * @param  p_data: bytes to send
+  * @param  size: number of bytes
+  * @param  crc: CRC of the bytes sent before
+  * @retval CRC of all the bytes sent, before augmentation
+  */
+static uint16_t SerialPutChecked(const uint8_t *p_data, uint32_t size, uint16_t crc)
+{
+  uint32_t i;
+
+  for (i = 0; i < size; i++)
+  {
+    crc = UpdateCRC16(crc, p_data[i]);
+  }
+  Serial_PutData(p_data, size);
+  return crc;
+}
+
+/**
+  * @brief  Answer a flash digest request
+  * @note   Frame: DIGEST_MAGIC (LE), DIGEST_VERSION, algorithm, status, digest
+  *         size, start, length (LE 32-bit), page count, reserved (LE 16-bit),
+  *         the digest of the range, the digest of each page of the range with
+  *         DIGEST_FLAG_PAGES, and the CRC16 of all previous bytes (MSB first).
+  *         Pages are the Flash pages the range covers, cut to the range.
+  * @param  None
+  * @retval None
+  */
+static void SerialDigest(void)
+{
+  uint8_t request[DIGEST_REQUEST_SIZE], header[20], digest[DIGEST_MAX_SIZE];
+  uint32_t magic = DIGEST_MAGIC, start, length, size, page, end;
+  uint16_t crc = 0, pages = 0;
+
+  /* The host sends the request right after the key: back to the menu if it does not */
+  if (Serial_Receive(request, DIGEST_REQUEST_SIZE, DOWNLOAD_TIMEOUT) != HAL_OK)
+  {
+    return;
+  }
+  memcpy(&start, &request[4], 4);
+  memcpy(&length, &request[8], 4);
+  size = Digest_Size(request[0]);
+
+  header[6] = DIGEST_STATUS_OK;
+  if ((start < FLASH_BASE) || (start >= USER_FLASH_END_ADDRESS) || (length == 0) ||
+      (length > (USER_FLASH_END_ADDRESS - start)))
+  {
+    header[6] = DIGEST_STATUS_RANGE;
+  }
+  else if (size == 0)
+  {
+    header[6] = DIGEST_STATUS_ALGO;
+  }
+  else if (request[1] & DIGEST_FLAG_PAGES)
+  {
+    pages = (uint16_t)((start + length - 1) / FLASH_PAGE_SIZE - start / FLASH_PAGE_SIZE + 1);
+  }
+  if (header[6] != DIGEST_STATUS_OK)
+  {
+    size = 0;
+  }
+
+  memcpy(header, &magic, 4);
+  header[4] = DIGEST_VERSION;
+  header[5] = request[0];
+  header[7] = (uint8_t)size;
+  memcpy(&header[8], &start, 4);
+  memcpy(&header[12], &length, 4);
+  memcpy(&header[16], &pages, 2);
+  header[18] = 0;
+  header[19] = 0;
+  crc = SerialPutChecked(header, sizeof(header), crc);
+
+  if (size != 0)
+  {
+    Digest_Compute(request[0], start, length, digest);
+    crc = SerialPutChecked(digest, size, crc);
+  }
+  for (page = start; pages != 0; pages--, page = end)
+  {
+    end = (page & ~(FLASH_PAGE_SIZE - 1)) + FLASH_PAGE_SIZE;
+    if (end > (start + length))
+    {
+      end = start + length;
+    }
+    Digest_Compute(request[0], page, end - page, digest);
+    crc = SerialPutChecked(digest, size, crc);
+  }
+
+  crc = UpdateCRC16(UpdateCRC16(crc, 0), 0);
+  digest[0] = (uint8_t)(crc >> 8);
+  digest[1] = (uint8_t)(crc & 0xFF);
+  Serial_PutData(digest, 2);
+}
+
+/**
+  * @brief  Serve host queries about the session that just ended
+  * @note   Requests are single bytes, the window closes once no request
+  *         came in for SESSION_QUERY_TIMEOUT.
+  * @param  None
+  * @retval None
+  */
+static void SerialSessionQuery(void)
+{
+  uint8_t key = 0;
+
+  while (Serial_Receive(&key, 1, SESSION_QUERY_TIMEOUT) == HAL_OK)
+  {
+    switch (key)
+    {
+    case STATS_QUERY_KEY :
+      SerialSendStats();
+      break;
+#ifdef IAP_TRACE
+    case TRACE_EXPORT_KEY :
+      Trace_Export();
+      break;
+#endif /* IAP_TRACE */
+    default:
+      break;
+    }
+  }
+}
+
 /**
   * @brief  Download a file via serial port
   * @param  None
@@ -54,7 +257,7 @@ void SerialDownload(void)
   COM_StatusTypeDef result;
 
   Serial_PutString("Waiting for the file to be sent ... (press 'a' to abort)\n\r");
-  result = Ymodem_Receive( &size );
+  result = Ymodem_Receive( &size, &DownloadStats );
   HAL_GPIO_TogglePin(LED_GREEN_GPIO_Port, LED_GREEN_Pin);
   if (result == COM_OK)
   {
@@ -63,8 +266,12 @@ void SerialDownload(void)
     Int2Str(number, size);
     Serial_PutString("\n\r Size: ");
     Serial_PutString(number);
-    Serial_PutString(" Bytes\r\n");
-    Serial_PutString("-------------------\n");
+    Serial_PutString(" Bytes\r\n SHA-256: ");
+    SerialPutHex(aFileDigest, SHA256_DIGEST_SIZE);
+    Serial_PutString("\r\n-------------------\n");
+#ifdef IAP_PROFILE
+    Prof_Dump();
+#endif /* IAP_PROFILE */
   }
   else if (result == COM_LIMIT)
   {
@@ -74,6 +281,10 @@ void SerialDownload(void)
   {
     Serial_PutString("\n\n\rVerification failed!\n\r");
   }
+  else if (result == COM_SIGNATURE)
+  {
+    Serial_PutString("\n\n\rSignature check failed!\n\r");
+  }
   else if (result == COM_ABORT)
   {
     Serial_PutString("\r\n\nAborted by user.\n\r");
@@ -82,6 +293,21 @@ void SerialDownload(void)
   {
     Serial_PutString("\n\rFailed to receive the file!\n\r");
   }
+
+  SerialPutStat("\r\n Time: ", DownloadStats.total_time, " ms");
+  SerialPutStat(" (first block after ", DownloadStats.first_block_time, " ms)\r\n");
+  SerialPutStat(" Blocks: ", DownloadStats.blocks, "");
+  SerialPutStat(", retransmits: ", DownloadStats.retransmits, "");
+  SerialPutStat(", CRC errors: ", DownloadStats.crc_errors, "");
+  SerialPutStat(", timeouts: ", DownloadStats.timeouts, "\r\n");
+  SerialPutStat(" Programmed: ", DownloadStats.bytes_programmed, " Bytes");
+  SerialPutStat(" (erase ", DownloadStats.erase_time, " ms");
+  SerialPutStat(", program ", DownloadStats.program_time, " ms)\r\n");
+  SerialPutStat(" Throughput: ", DownloadStats.throughput, " Bytes/s\r\n");
+  SerialPutStat(" Asleep: ", DownloadStats.sleep_time, " ms");
+  SerialPutStat(" (", DownloadStats.sleep_ratio / 10, " % of the time)\r\n");
+
+  SerialSessionQuery();
 }
 
 /**
@@ -91,15 +317,32 @@ void SerialDownload(void)
   */
 void SerialUpload(void)
 {
-  uint8_t status = 0;
+  uint8_t status = 0, sparse = 0;
+  uint32_t image_size;
 
   Serial_PutString("\n\n\rSelect Receive File\n\r");
 
-  HAL_UART_Receive(&UartHandle, &status, 1, RX_TIMEOUT);
+  Serial_Receive(&status, 1, RX_TIMEOUT);
+  if ((status == SPARSE_REQUEST_KEY) || (status == (SPARSE_REQUEST_KEY | 0x20)))
+  {
+    /* Sparse form requested ahead of the receiver start */
+    sparse = 1;
+    Serial_Receive(&status, 1, RX_TIMEOUT);
+  }
   if ( status == CRC16)
   {
+    /* Only the programmed part of the area is sent */
+    image_size = FLASH_If_GetImageSize(Part_Address(PART_TYPE_APP), Part_Size(PART_TYPE_APP));
+
     /* Transmit the flash image through ymodem protocol */
-    status = Ymodem_Transmit((uint8_t*)APPLICATION_ADDRESS, (const uint8_t*)"UploadedFlashImage.bin", USER_FLASH_SIZE);
+    if (sparse)
+    {
+      status = Ymodem_TransmitSparse((uint8_t*)Part_Address(PART_TYPE_APP), (const uint8_t*)"UploadedFlashImage.sparse", image_size);
+    }
+    else
+    {
+      status = Ymodem_Transmit((uint8_t*)Part_Address(PART_TYPE_APP), (const uint8_t*)"UploadedFlashImage.bin", image_size);
+    }
 
     if (status != 0)
     {
@@ -112,6 +355,40 @@ void SerialUpload(void)
   }
 }
 
+/**
+  * @brief  Lower the core clock while waiting for the host, or restore it
+  * @note   The USART runs on HSI16 (main.c) and keeps its baud rate, the
+  *         SysTick is set up again by HAL_RCC_ClockConfig.
+  * @param  idle: 1 for IDLE_AHB_DIVIDER, 0 for the full clock
+  * @retval None
+  */
+void Main_IdleClock(uint32_t idle)
+{
+  RCC_ClkInitTypeDef clock;
+  uint32_t latency, divider = idle ? IDLE_AHB_DIVIDER : RCC_SYSCLK_DIV1;
+
+  HAL_RCC_GetClockConfig(&clock, &latency);
+  if (clock.AHBCLKDivider != divider)
+  {
+    clock.ClockType = RCC_CLOCKTYPE_HCLK;
+    clock.AHBCLKDivider = divider;
+    HAL_RCC_ClockConfig(&clock, latency);
+  }
+}
+
+/**
+  * @brief  Download an image then restart
+  * @param  None
+  * @retval None
+  */
+void Main_Download(void)
+{
+  /* Download user application in the Flash */
+  SerialDownload();
+  Serial_Flush();
+  NVIC_SystemReset();
+}
+
 /**
   * @brief  Display the Main Menu on HyperTerminal
   * @param  None
@@ -137,9 +414,14 @@ void Main_Menu(void)
   {
 
     Serial_PutString("\r\n=================== Main Menu ============================\r\n\n");
-    Serial_PutString("  Download image to the internal Flash  \r\n\n");
-//    Serial_PutString("  Upload image from the internal Flash ----------------- 2\r\n\n");
-//    Serial_PutString("  Execute the loaded application ----------------------- 3\r\n\n");
+    Serial_PutString("  Download image to the internal Flash (default) ------- 1\r\n\n");
+    Serial_PutString("  Upload image from the internal Flash ----------------- 2\r\n\n");
+    Serial_PutString("  Execute the loaded application ----------------------- 3\r\n\n");
+    Serial_PutString("  Digest a Flash range (host tool) --------------------- D\r\n\n");
+    Serial_PutString("  Binary command protocol (host tool) ------------------ R\r\n\n");
+#ifdef IAP_PROFILE
+    Serial_PutString("  Dump the profiling counters -------------------------- P\r\n\n");
+#endif /* IAP_PROFILE */
 
 
 //    if(FlashProtection != FLASHIF_PROTECTION_NONE)
@@ -153,30 +435,53 @@ void Main_Menu(void)
     Serial_PutString("==========================================================\r\n\n");
 
     /* Clean the input path */
-    __HAL_UART_FLUSH_DRREGISTER(&UartHandle);
-    __HAL_UART_CLEAR_IT(&UartHandle, UART_CLEAR_OREF);
+    Serial_RxFlush();
 	
-    /* Receive key */
-//    HAL_UART_Receive(&UartHandle, &key, 1, RX_TIMEOUT);
-key = '1';
+    /* Receive key, fall back to the download when none comes in time */
+    Main_IdleClock(1);
+    if (Serial_Receive(&key, 1, MENU_KEY_TIMEOUT) != HAL_OK)
+    {
+      key = '1';
+    }
+    Main_IdleClock(0);
     switch (key)
     {
     case '1' :
-      /* Download user application in the Flash */
-      SerialDownload();
+      Main_Download();
       break;
     case '2' :
       /* Upload user application from the Flash */
       SerialUpload();
       break;
+#ifdef IAP_PROFILE
+    case 'P' :
+    case 'p' :
+      Prof_Dump();
+      SerialPutStat("\r\n SHA-256 self test: ", Sha256_SelfTest(), " cycles/byte (0: vectors failed)\r\n");
+      SerialPutStat(" Ed25519 self test: ", Ed25519_SelfTest(), " cycles/verify (0: vectors failed)\r\n");
+      SerialPutStat(" ChaCha20 self test: ", Chacha20_SelfTest(), " cycles/byte (0: vector failed)\r\n");
+      break;
+#endif /* IAP_PROFILE */
+    case DIGEST_REQUEST_KEY :
+      SerialDigest();
+      break;
+    case RPC_REQUEST_KEY :
+      Rpc_Serve();
+      break;
     case '3' :
+      if (!Verify_Boot())
+      {
+        Serial_PutString("Signature check failed!\r\n\n");
+        break;
+      }
       Serial_PutString("Start program execution......\r\n\n");
+      Serial_Flush();
       /* execute the new program */
-      JumpAddress = *(__IO uint32_t*) (APPLICATION_ADDRESS + 4);
+      JumpAddress = *(__IO uint32_t*) (Part_Address(PART_TYPE_APP) + 4);
       /* Jump to user application */
       JumpToApplication = (pFunction) JumpAddress;
       /* Initialize user application's Stack Pointer */
-      __set_MSP(*(__IO uint32_t*) APPLICATION_ADDRESS);
+      __set_MSP(*(__IO uint32_t*) Part_Address(PART_TYPE_APP));
       JumpToApplication();
       break;
     case '4' :
@@ -214,7 +519,6 @@ key = '1';
 	Serial_PutString("Invalid Number ! ==> The number should be either 1, 2, 3 or 4\r");
 	break;
     }
-    NVIC_SystemReset();
   }
 }
 
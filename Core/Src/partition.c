@@ -0,0 +1,249 @@
+/**
+  ******************************************************************************
+  * @file    partition.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the flash partition table: the slot layout is
+  *          read once from the last Flash page into RAM, the built-in layout
+  *          of flash_if.h is used when the page holds no valid table.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "partition.h"
+#include "flash_if.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define PART_FLASH_SIZE         (USER_FLASH_END_ADDRESS - FLASH_BASE)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static Part_SlotTypeDef aPartSlots[PART_MAX_SLOTS];
+static uint32_t PartNbSlots;
+static uint32_t PartDefault;
+
+/* Layout used when no valid table is stored */
+static const Part_SlotTypeDef aPartDefault[] =
+{
+  { 0,                                  APPLICATION_ADDRESS - FLASH_BASE, PART_TYPE_BOOT,        PART_FLAG_READONLY, 0 },
+  { APPLICATION_ADDRESS - FLASH_BASE,   USER_FLASH_SIZE,                  PART_TYPE_APP,         0,                  0 },
+  { CALIBRATION_ADDRESS - FLASH_BASE,   CALIBRATION_SIZE,                 PART_TYPE_CALIBRATION, 0,                  0 },
+  { RESOURCE_ADDRESS - FLASH_BASE,      RESOURCE_SIZE,                    PART_TYPE_RESOURCE,    0,                  0 },
+  { JOURNAL_ADDRESS - FLASH_BASE,       FLASH_PAGE_SIZE,                  PART_TYPE_JOURNAL,     0,                  0 },
+  { PART_TABLE_ADDRESS - FLASH_BASE,    FLASH_PAGE_SIZE,                  PART_TYPE_TABLE,       PART_FLAG_READONLY, 0 }
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint16_t Part_Crc16(const uint8_t *p_data, uint32_t size);
+static uint32_t Part_Check(const Part_TableTypeDef *p_table);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  CRC16-XMODEM, as computed by Tools/part_table.py
+  * @note   Bitwise: the table is checked before the CRC unit is configured.
+  * @param  p_data: data to check
+  * @param  size: number of bytes
+  * @retval CRC value
+  */
+static uint16_t Part_Crc16(const uint8_t *p_data, uint32_t size)
+{
+  uint32_t crc = 0, bit;
+
+  while (size--)
+  {
+    crc ^= (uint32_t)(*p_data++) << 8;
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000U) ? ((crc << 1) ^ 0x1021U) : (crc << 1);
+    }
+  }
+  return (uint16_t)crc;
+}
+
+/**
+  * @brief  Check a stored table before it is trusted
+  * @note   Slots must be page aligned, inside the Flash and disjoint. The
+  *         boot slot must start the Flash and cover this bootloader, the
+  *         table slot must hold the table page, both are forced read only.
+  * @param  p_table: table to check
+  * @retval 1 if the table can be used, 0 otherwise
+  */
+static uint32_t Part_Check(const Part_TableTypeDef *p_table)
+{
+  uint32_t i, j, boot = 0, app = 0, table = 0;
+  const Part_SlotTypeDef *p_slot, *p_other;
+
+  if ((p_table->magic != PART_MAGIC) || (p_table->version != PART_VERSION) ||
+      (p_table->count == 0) || (p_table->count > PART_MAX_SLOTS))
+  {
+    return 0;
+  }
+  if (Part_Crc16((const uint8_t *)p_table->slot, p_table->count * sizeof(Part_SlotTypeDef)) != p_table->crc)
+  {
+    return 0;
+  }
+
+  for (i = 0; i < p_table->count; i++)
+  {
+    p_slot = &p_table->slot[i];
+    if (((p_slot->offset % FLASH_PAGE_SIZE) != 0) || ((p_slot->size % FLASH_PAGE_SIZE) != 0) ||
+        (p_slot->size == 0) || (p_slot->offset >= PART_FLASH_SIZE) ||
+        (p_slot->size > (PART_FLASH_SIZE - p_slot->offset)))
+    {
+      return 0;
+    }
+    for (j = 0; j < i; j++)
+    {
+      p_other = &p_table->slot[j];
+      if ((p_slot->offset < (p_other->offset + p_other->size)) && (p_other->offset < (p_slot->offset + p_slot->size)))
+      {
+        return 0;
+      }
+    }
+    switch (p_slot->type)
+    {
+      case PART_TYPE_BOOT:
+        /* This bootloader is linked for the built-in boot slot */
+        boot = (p_slot->offset == 0) && (p_slot->size >= (APPLICATION_ADDRESS - FLASH_BASE));
+        break;
+      case PART_TYPE_APP:
+        app = 1;
+        break;
+      case PART_TYPE_TABLE:
+        table = (p_slot->offset == (PART_TABLE_ADDRESS - FLASH_BASE));
+        break;
+      default:
+        break;
+    }
+  }
+  return boot && app && table;
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Load the partition table in RAM, once at startup
+  * @param  None
+  * @retval None
+  */
+void Part_Init(void)
+{
+  const Part_TableTypeDef *p_table = (const Part_TableTypeDef *)PART_TABLE_ADDRESS;
+  uint32_t i;
+
+  if (Part_Check(p_table))
+  {
+    PartNbSlots = p_table->count;
+    memcpy(aPartSlots, p_table->slot, PartNbSlots * sizeof(Part_SlotTypeDef));
+    PartDefault = 0;
+  }
+  else
+  {
+    PartNbSlots = sizeof(aPartDefault) / sizeof(aPartDefault[0]);
+    memcpy(aPartSlots, aPartDefault, sizeof(aPartDefault));
+    PartDefault = 1;
+  }
+
+  for (i = 0; i < PartNbSlots; i++)
+  {
+    if ((aPartSlots[i].type == PART_TYPE_BOOT) || (aPartSlots[i].type == PART_TYPE_TABLE))
+    {
+      aPartSlots[i].flags |= PART_FLAG_READONLY;
+    }
+  }
+}
+
+/**
+  * @brief  Tell whether the built-in layout is in use
+  * @param  None
+  * @retval 1 if no valid table was found in Flash, 0 otherwise
+  */
+uint32_t Part_IsDefault(void)
+{
+  return PartDefault;
+}
+
+/**
+  * @brief  Find the first slot of a type
+  * @param  type: slot type
+  * @retval Slot, NULL if the layout has none
+  */
+const Part_SlotTypeDef *Part_Find(Part_TypeTypeDef type)
+{
+  uint32_t i;
+
+  for (i = 0; i < PartNbSlots; i++)
+  {
+    if (aPartSlots[i].type == (uint8_t)type)
+    {
+      return &aPartSlots[i];
+    }
+  }
+  return NULL;
+}
+
+/**
+  * @brief  Address of the first slot of a type
+  * @param  type: slot type
+  * @retval Start address, 0 if the layout has no such slot
+  */
+uint32_t Part_Address(Part_TypeTypeDef type)
+{
+  const Part_SlotTypeDef *p_slot = Part_Find(type);
+
+  return (p_slot != NULL) ? (FLASH_BASE + p_slot->offset) : 0;
+}
+
+/**
+  * @brief  Size of the first slot of a type
+  * @param  type: slot type
+  * @retval Size in bytes, 0 if the layout has no such slot
+  */
+uint32_t Part_Size(Part_TypeTypeDef type)
+{
+  const Part_SlotTypeDef *p_slot = Part_Find(type);
+
+  return (p_slot != NULL) ? p_slot->size : 0;
+}
+
+/**
+  * @brief  Check that a flash area may be erased or programmed
+  * @param  start: start address of the area
+  * @param  length: length of the area in bytes
+  * @retval 1 if the area is inside the Flash and clear of read only slots
+  */
+uint32_t Part_IsWritable(uint32_t start, uint32_t length)
+{
+  uint32_t i, offset;
+
+  if ((start < FLASH_BASE) || ((start - FLASH_BASE) > PART_FLASH_SIZE) ||
+      (length > (PART_FLASH_SIZE - (start - FLASH_BASE))))
+  {
+    return 0;
+  }
+
+  offset = start - FLASH_BASE;
+  for (i = 0; i < PartNbSlots; i++)
+  {
+    if ((aPartSlots[i].flags & PART_FLAG_READONLY) &&
+        (offset < (aPartSlots[i].offset + aPartSlots[i].size)) && (aPartSlots[i].offset < (offset + length)))
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,152 @@
+/**
+  ******************************************************************************
+  * @file    prof.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the hot-path profiling counters: per phase
+  *          min/max/sum and a coarse histogram of the elapsed core cycles,
+  *          kept in a fixed RAM table and dumped over the IAP serial port.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "prof.h"
+#include "common.h"
+#include "string.h"
+
+#ifdef IAP_PROFILE
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+uint32_t Prof_StartStamp[PROF_NB];
+static Prof_EntryTypeDef aProfTable[PROF_NB];
+static const char * const aProfNames[PROF_NB] =
+{
+  "rx wait ",
+  "rx xfer ",
+  "crc     ",
+  "erase   ",
+  "write   ",
+  "ack     ",
+  "tx      ",
+  "hash    ",
+  "decrypt "
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Prof_PutNumber(uint32_t value);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Print an unsigned number followed by a space
+  * @param  value: number to print
+  * @retval None
+  */
+static void Prof_PutNumber(uint32_t value)
+{
+  uint8_t number[11] = {0};
+
+  Int2Str(number, value);
+  Serial_PutString(number);
+  Serial_PutString((uint8_t *)" ");
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Clear all profiling counters
+  * @param  None
+  * @retval None
+  */
+void Prof_Reset(void)
+{
+  uint32_t i;
+
+  memset(aProfTable, 0, sizeof(aProfTable));
+  for (i = 0; i < PROF_NB; i++)
+  {
+    aProfTable[i].min = 0xFFFFFFFFU;
+  }
+}
+
+/**
+  * @brief  Account one measurement of a phase
+  * @param  id: profiled phase
+  * @param  cycles: elapsed core cycles
+  * @retval None
+  */
+void Prof_Record(Prof_IdTypeDef id, uint32_t cycles)
+{
+  Prof_EntryTypeDef *p_entry = &aProfTable[id];
+  uint32_t bucket = 0, bound = PROF_HIST_BASE;
+
+  p_entry->count++;
+  p_entry->sum += cycles;
+  if (cycles < p_entry->min)
+  {
+    p_entry->min = cycles;
+  }
+  if (cycles > p_entry->max)
+  {
+    p_entry->max = cycles;
+  }
+
+  while ((cycles >= bound) && (bucket < (PROF_HIST_BUCKETS - 1)))
+  {
+    bound <<= PROF_HIST_SHIFT;
+    bucket++;
+  }
+  p_entry->hist[bucket]++;
+}
+
+/**
+  * @brief  Print the profiling table on the HyperTerminal
+  * @note   Times are in microseconds, histogram buckets are in core cycles
+  *         starting below PROF_HIST_BASE and growing by 2^PROF_HIST_SHIFT.
+  * @param  None
+  * @retval None
+  */
+void Prof_Dump(void)
+{
+  uint32_t i, j, cycles_per_us;
+  Prof_EntryTypeDef *p_entry;
+
+  cycles_per_us = SystemCoreClock / 1000000U;
+
+  Serial_PutString((uint8_t *)"\r\n phase    count min avg max (us) | histogram\r\n");
+  for (i = 0; i < PROF_NB; i++)
+  {
+    p_entry = &aProfTable[i];
+    Serial_PutString((uint8_t *)" ");
+    Serial_PutString((uint8_t *)aProfNames[i]);
+    Prof_PutNumber(p_entry->count);
+    if (p_entry->count != 0)
+    {
+      Prof_PutNumber(p_entry->min / cycles_per_us);
+      Prof_PutNumber((uint32_t)(p_entry->sum / p_entry->count) / cycles_per_us);
+      Prof_PutNumber(p_entry->max / cycles_per_us);
+    }
+    Serial_PutString((uint8_t *)"| ");
+    for (j = 0; j < PROF_HIST_BUCKETS; j++)
+    {
+      Prof_PutNumber(p_entry->hist[j]);
+    }
+    Serial_PutString((uint8_t *)"\r\n");
+  }
+}
+
+#endif /* IAP_PROFILE */
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
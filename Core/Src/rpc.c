@@ -0,0 +1,381 @@
+/**
+  ******************************************************************************
+  * @file    rpc.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the binary command protocol of the IAP, next
+  *          to YMODEM: the host erases, writes, reads and digests the slots
+  *          in any order, see rpc.h for the frames.
+  *
+  *          A request is decoded in place in its receive buffer, the answer
+  *          is framed in a buffer of its own and sent by DMA while the next
+  *          request is served. Any erase or write voids the download journal,
+  *          the next boot checks the signature of the application again.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "rpc.h"
+#include "common.h"
+#include "flash_if.h"
+#include "partition.h"
+#include "digest.h"
+#include "journal.h"
+#include "serial_rx.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define RPC_FRAME_WORDS         ((RPC_MAX_FRAME + 3) / 4)
+#define RPC_PAYLOAD_WORDS       ((RPC_MAX_PAYLOAD + 3) / 4)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint32_t aRpcRequest[RPC_FRAME_WORDS];   /* Encoded, then decoded in place */
+static uint32_t aRpcReply[RPC_PAYLOAD_WORDS];
+static uint8_t aRpcTx[RPC_MAX_FRAME];           /* Untouched until its DMA is done */
+static uint32_t RpcModified;                    /* Journal voided in this session */
+/* Slots open to the host, as the YMODEM regions */
+static const Part_TypeTypeDef aRpcSlots[] =
+{
+  PART_TYPE_APP, PART_TYPE_CALIBRATION, PART_TYPE_RESOURCE
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static uint32_t Rpc_CobsDecode(uint8_t *p_data, uint32_t length);
+static uint32_t Rpc_CobsEncode(const uint8_t *p_data, uint32_t length, uint8_t *p_frame);
+static uint32_t Rpc_InSlots(uint32_t start, uint32_t length);
+static void Rpc_Modify(void);
+static uint32_t Rpc_Execute(const uint8_t *p_request, uint32_t length, uint8_t *p_reply, uint32_t *p_restart);
+static void Rpc_Send(uint8_t *p_reply, uint32_t length);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Decode a COBS frame in place
+  * @param  p_data: frame without its 0x00 delimiter
+  * @param  length: bytes in the frame
+  * @retval Bytes decoded, 0 if the frame is malformed
+  */
+static uint32_t Rpc_CobsDecode(uint8_t *p_data, uint32_t length)
+{
+  uint32_t in = 0, out = 0, code, i;
+
+  while (in < length)
+  {
+    code = p_data[in++];
+    if ((code == 0) || ((code - 1) > (length - in)))
+    {
+      return 0;
+    }
+    /* The output never passes the input */
+    for (i = 1; i < code; i++)
+    {
+      p_data[out++] = p_data[in++];
+    }
+    if ((code < 0xFF) && (in < length))
+    {
+      p_data[out++] = 0;
+    }
+  }
+  return out;
+}
+
+/**
+  * @brief  Encode a payload as a COBS frame, delimiter included
+  * @param  p_data: payload
+  * @param  length: bytes in the payload
+  * @param  p_frame: receives up to length + length / 254 + 2 bytes
+  * @retval Bytes in the frame
+  */
+static uint32_t Rpc_CobsEncode(const uint8_t *p_data, uint32_t length, uint8_t *p_frame)
+{
+  uint32_t in, out = 1, code_index = 0;
+  uint8_t code = 1;
+
+  for (in = 0; in < length; in++)
+  {
+    if (p_data[in] != 0)
+    {
+      p_frame[out++] = p_data[in];
+      code++;
+    }
+    if ((p_data[in] == 0) || (code == 0xFF))
+    {
+      p_frame[code_index] = code;
+      code_index = out++;
+      code = 1;
+    }
+  }
+  p_frame[code_index] = code;
+  p_frame[out++] = 0;
+  return out;
+}
+
+/**
+  * @brief  Check that a range lies inside one of the slots open to the host
+  * @param  start: first address
+  * @param  length: bytes in the range
+  * @retval 1 if inside, 0 otherwise
+  */
+static uint32_t Rpc_InSlots(uint32_t start, uint32_t length)
+{
+  uint32_t i, address, size;
+
+  for (i = 0; i < (sizeof(aRpcSlots) / sizeof(aRpcSlots[0])); i++)
+  {
+    address = Part_Address(aRpcSlots[i]);
+    size = Part_Size(aRpcSlots[i]);
+    if ((size != 0) && (start >= address) && (length <= size) && ((start - address) <= (size - length)))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  Void the journal before the first change of the session
+  * @note   A resumed download or a journaled signature check must not trust
+  *         pages the host changed.
+  * @param  None
+  * @retval None
+  */
+static void Rpc_Modify(void)
+{
+  if (!RpcModified)
+  {
+    Journal_Invalidate();
+    RpcModified = 1;
+  }
+}
+
+/**
+  * @brief  Serve one request
+  * @param  p_request: decoded request without its CRC, 32-bit aligned
+  * @param  length: bytes in the request, RPC_HEADER_SIZE at least
+  * @param  p_reply: receives the answer without its CRC
+  * @param  p_restart: set to 1 when the IAP must restart once answered
+  * @retval Bytes in the answer
+  */
+static uint32_t Rpc_Execute(const uint8_t *p_request, uint32_t length, uint8_t *p_reply, uint32_t *p_restart)
+{
+  uint32_t address = 0, size = 0, count = RPC_HEADER_SIZE, value, i;
+  uint8_t status = RPC_STATUS_OK;
+
+  if (length >= (RPC_HEADER_SIZE + 4))
+  {
+    memcpy(&address, &p_request[4], 4);
+  }
+  if (length >= (RPC_HEADER_SIZE + 8))
+  {
+    memcpy(&size, &p_request[8], 4);
+  }
+
+  switch (p_request[0])
+  {
+    case RPC_CMD_GETINFO:
+      p_reply[4] = RPC_VERSION;
+      p_reply[5] = 0;
+      value = RPC_MAX_DATA;
+      memcpy(&p_reply[6], &value, 2);
+      value = FLASH_PAGE_SIZE;
+      memcpy(&p_reply[8], &value, 4);
+      value = RX_RING_SIZE;
+      memcpy(&p_reply[12], &value, 4);
+      count = 16;
+      for (i = 0; i < (sizeof(aRpcSlots) / sizeof(aRpcSlots[0])); i++)
+      {
+        value = Part_Size(aRpcSlots[i]);
+        if (value != 0)
+        {
+          memset(&p_reply[count], 0, 4);
+          p_reply[count] = (uint8_t)aRpcSlots[i];
+          memcpy(&p_reply[count + 8], &value, 4);
+          value = Part_Address(aRpcSlots[i]);
+          memcpy(&p_reply[count + 4], &value, 4);
+          count += 12;
+          p_reply[5]++;
+        }
+      }
+      break;
+    case RPC_CMD_ERASE:
+      if (length != (RPC_HEADER_SIZE + 8))
+      {
+        status = RPC_STATUS_LENGTH;
+      }
+      else if (((address % FLASH_PAGE_SIZE) != 0) || (size == 0) || !Rpc_InSlots(address, size))
+      {
+        status = RPC_STATUS_RANGE;
+      }
+      else
+      {
+        Rpc_Modify();
+        if (FLASH_If_EraseRange(address, size) != FLASHIF_OK)
+        {
+          status = RPC_STATUS_FLASH;
+        }
+      }
+      break;
+    case RPC_CMD_WRITE:
+      size = length - (RPC_HEADER_SIZE + 4);
+      if ((length < (RPC_HEADER_SIZE + 4 + 8)) || (size > RPC_MAX_DATA) || ((size % 8) != 0))
+      {
+        status = RPC_STATUS_LENGTH;
+      }
+      else if (((address % 8) != 0) || !Rpc_InSlots(address, size))
+      {
+        status = RPC_STATUS_RANGE;
+      }
+      else if (memcmp((const void *)address, &p_request[8], size) == 0)
+      {
+        /* Already there: the answer to a first try was lost */
+      }
+      else if (!FLASH_If_IsErased(address, size))
+      {
+        status = RPC_STATUS_FLASH;
+      }
+      else
+      {
+        Rpc_Modify();
+        if (FLASH_If_Write(address, (uint32_t *)&p_request[8], size / 4) != FLASHIF_OK)
+        {
+          status = RPC_STATUS_FLASH;
+        }
+      }
+      break;
+    case RPC_CMD_READ:
+      if ((length != (RPC_HEADER_SIZE + 8)) || (size > RPC_MAX_DATA))
+      {
+        status = RPC_STATUS_LENGTH;
+      }
+      else if (!Rpc_InSlots(address, size))
+      {
+        status = RPC_STATUS_RANGE;
+      }
+      else
+      {
+        memcpy(&p_reply[count], (const void *)address, size);
+        count += size;
+      }
+      break;
+    case RPC_CMD_DIGEST:
+      if (length != (RPC_HEADER_SIZE + 12))
+      {
+        status = RPC_STATUS_LENGTH;
+      }
+      else if (Digest_Size(p_request[12]) == 0)
+      {
+        status = RPC_STATUS_COMMAND;
+      }
+      else if ((size == 0) || !Rpc_InSlots(address, size))
+      {
+        status = RPC_STATUS_RANGE;
+      }
+      else
+      {
+        Digest_Compute(p_request[12], address, size, &p_reply[count]);
+        count += Digest_Size(p_request[12]);
+      }
+      break;
+    case RPC_CMD_JUMP:
+      if (length != RPC_HEADER_SIZE)
+      {
+        status = RPC_STATUS_LENGTH;
+      }
+      else
+      {
+        *p_restart = 1;
+      }
+      break;
+    default:
+      status = RPC_STATUS_COMMAND;
+      break;
+  }
+
+  p_reply[0] = p_request[0] | RPC_REPLY;
+  p_reply[1] = status;
+  p_reply[2] = p_request[2];
+  p_reply[3] = p_request[3];
+  return (status == RPC_STATUS_OK) ? count : RPC_HEADER_SIZE;
+}
+
+/**
+  * @brief  Append the CRC to an answer and send it as a frame
+  * @param  p_reply: answer, room for the CRC after it
+  * @param  length: bytes in the answer
+  * @retval None
+  */
+static void Rpc_Send(uint8_t *p_reply, uint32_t length)
+{
+  uint32_t crc = Digest_Crc32((uint32_t)p_reply, length);
+
+  memcpy(&p_reply[length], &crc, RPC_CRC_SIZE);
+  /* The previous answer may still be on its way */
+  Serial_WaitTxDone();
+  length = Rpc_CobsEncode(p_reply, length + RPC_CRC_SIZE, aRpcTx);
+  Serial_PutFrame(aRpcTx, (uint16_t)length);
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Serve requests until the line stays idle for RPC_IDLE_TIMEOUT
+  * @note   RPC_CMD_JUMP restarts the IAP instead of returning.
+  * @param  None
+  * @retval None
+  */
+void Rpc_Serve(void)
+{
+  uint8_t *p_frame = (uint8_t *)aRpcRequest;
+  uint32_t fill = 0, length, crc, restart = 0;
+  uint8_t byte;
+
+  RpcModified = 0;
+  while (Serial_Receive(&byte, 1, RPC_IDLE_TIMEOUT) == HAL_OK)
+  {
+    if (byte != 0)
+    {
+      /* A frame too long is dropped at its delimiter */
+      if (fill < RPC_MAX_FRAME)
+      {
+        p_frame[fill] = byte;
+      }
+      fill += (fill <= RPC_MAX_FRAME) ? 1 : 0;
+      continue;
+    }
+
+    length = (fill <= RPC_MAX_FRAME) ? Rpc_CobsDecode(p_frame, fill) : 0;
+    fill = 0;
+    if (length < (RPC_HEADER_SIZE + RPC_CRC_SIZE))
+    {
+      continue;
+    }
+    length -= RPC_CRC_SIZE;
+    memcpy(&crc, &p_frame[length], RPC_CRC_SIZE);
+    if (crc != Digest_Crc32((uint32_t)p_frame, length))
+    {
+      continue;
+    }
+
+    Rpc_Send((uint8_t *)aRpcReply, Rpc_Execute(p_frame, length, (uint8_t *)aRpcReply, &restart));
+    if (restart)
+    {
+      Serial_Flush();
+      NVIC_SystemReset();
+    }
+  }
+  Serial_WaitTxDone();
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,172 @@
+/**
+  ******************************************************************************
+  * @file    serial_rx.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the interrupt driven reception of the IAP: the
+  *          USART2 interrupt fills a ring that Serial_Receive reads with the
+  *          timeout of HAL_UART_Receive.
+  *
+  *          A Flash erase or program stalls every fetch from the Flash. This
+  *          module, the Flash driver, the interrupt handlers and the vector
+  *          table run from SRAM (Code/Const in IRAM1 in the file options,
+  *          the vector table copied by main), so bytes keep coming into the
+  *          ring while the Flash is busy.
+  *
+  *          While the ring is empty the core sleeps (WFI) until the next
+  *          interrupt, a received byte or the SysTick of the timeout.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "serial_rx.h"
+#include "prof.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define RX_ERROR_FLAGS          (USART_ISR_ORE | USART_ISR_NE | USART_ISR_FE | USART_ISR_PE)
+
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static uint8_t aRxRing[RX_RING_SIZE];
+static __IO uint32_t RxRingHead;
+static __IO uint32_t RxRingTail;
+static uint32_t RxSleepTime;      /* us asleep in Serial_Receive, wrapping */
+
+/* Private function prototypes -----------------------------------------------*/
+static void Serial_RxSleep(void);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Sleep until the next interrupt unless a byte is already waiting
+  * @note   Interrupts are masked from the check to the WFI, so a byte
+  *         received in between still wakes the core; its handler runs once
+  *         they are unmasked. The time asleep counts the handler too.
+  * @param  None
+  * @retval None
+  */
+static void Serial_RxSleep(void)
+{
+  uint32_t primask = __get_PRIMASK(), start;
+
+  __disable_irq();
+  if (RxRingTail == RxRingHead)
+  {
+    start = Prof_Now();
+    __WFI();
+    __set_PRIMASK(primask);
+    /* In us: the core clock is lowered while waiting for a host */
+    RxSleepTime += ((Prof_Now() - start) * 1000U) / (SysTick->LOAD + 1U);
+  }
+  __set_PRIMASK(primask);
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Start the reception into the ring
+  * @note   The UART must be initialised. Whatever it holds is dropped.
+  * @param  None
+  * @retval None
+  */
+void Serial_RxStart(void)
+{
+  RxRingHead = 0;
+  RxRingTail = 0;
+  RxSleepTime = 0;
+  __HAL_UART_SEND_REQ(&UartHandle, UART_RXDATA_FLUSH_REQUEST);
+  UartHandle.Instance->ICR = USART_ICR_ORECF | USART_ICR_NECF | USART_ICR_FECF | USART_ICR_PECF;
+  __HAL_UART_ENABLE_IT(&UartHandle, UART_IT_RXNE);
+}
+
+/**
+  * @brief  USART2 interrupt: move the received bytes to the ring
+  * @note   Runs from SRAM, calls nothing in Flash.
+  * @param  None
+  * @retval None
+  */
+void Serial_RxIRQHandler(void)
+{
+  USART_TypeDef *p_usart = UartHandle.Instance;
+  uint32_t isr = p_usart->ISR;
+  uint8_t byte;
+
+  /* A byte lost shows as a bad packet, the protocol asks it again */
+  if (isr & RX_ERROR_FLAGS)
+  {
+    p_usart->ICR = USART_ICR_ORECF | USART_ICR_NECF | USART_ICR_FECF | USART_ICR_PECF;
+  }
+  while (p_usart->ISR & USART_ISR_RXNE_RXFNE)
+  {
+    byte = (uint8_t)p_usart->RDR;
+    if ((RxRingHead - RxRingTail) < RX_RING_SIZE)
+    {
+      aRxRing[RxRingHead & (RX_RING_SIZE - 1)] = byte;
+      RxRingHead++;
+    }
+  }
+}
+
+/**
+  * @brief  Receive bytes from the ring
+  * @param  p_data: output buffer
+  * @param  size: number of bytes
+  * @param  timeout: ms for the whole buffer, HAL_MAX_DELAY to wait for ever
+  * @retval HAL_OK if all were received, HAL_TIMEOUT otherwise
+  */
+HAL_StatusTypeDef Serial_Receive(uint8_t *p_data, uint32_t size, uint32_t timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+
+  while (size != 0)
+  {
+    if (RxRingTail != RxRingHead)
+    {
+      *p_data++ = aRxRing[RxRingTail & (RX_RING_SIZE - 1)];
+      RxRingTail++;
+      size--;
+    }
+    else if ((timeout != HAL_MAX_DELAY) && ((HAL_GetTick() - tickstart) > timeout))
+    {
+      return HAL_TIMEOUT;
+    }
+    else
+    {
+      Serial_RxSleep();
+    }
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  Drop the bytes received and not read yet
+  * @param  None
+  * @retval None
+  */
+void Serial_RxFlush(void)
+{
+  RxRingTail = RxRingHead;
+}
+
+/**
+  * @brief  Time asleep waiting for bytes
+  * @param  None
+  * @retval us since Serial_RxStart, wrapping: use differences
+  */
+uint32_t Serial_RxSleepTime(void)
+{
+  return RxSleepTime;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
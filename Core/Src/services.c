@@ -0,0 +1,412 @@
+/**
+  ******************************************************************************
+  * @file    services.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the services of the bootloader exported to the
+  *          application through a table at a fixed address: Flash erase and
+  *          program, CRC16 and CRC-32, YMODEM packet check and framing. The
+  *          application calls them instead of linking its own copies.
+  *
+  *          The application runs with its own RAM, stack and HAL state: the
+  *          services keep nothing in RAM and drive the Flash and CRC
+  *          registers directly.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "services.h"
+#include "partition.h"
+#include "flash_if.h"
+#include "ymodem_packet.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* CRC unit registers of the caller */
+typedef struct
+{
+  uint32_t cr;
+  uint32_t init;
+  uint32_t pol;
+  uint32_t clock;
+} Svc_CrcContextTypeDef;
+
+/* Private define ------------------------------------------------------------*/
+#define SVC_FLASH_ERRORS        (FLASH_SR_OPERR | FLASH_SR_PROGERR | FLASH_SR_WRPERR | FLASH_SR_PGAERR | \
+                                 FLASH_SR_SIZERR | FLASH_SR_PGSERR | FLASH_SR_MISERR | FLASH_SR_FASTERR)
+
+/* Private macro -------------------------------------------------------------*/
+#if defined(__CC_ARM)
+#define SVC_AT                  __attribute__((at(SVC_TABLE_ADDRESS), used))
+#else
+#define SVC_AT                  __attribute__((section(".ARM.__at_0x08000200"), used))
+#endif
+
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+static void Svc_CrcOpen(Svc_CrcContextTypeDef *p_context, uint32_t cr, uint32_t pol, uint32_t init);
+static void Svc_CrcClose(const Svc_CrcContextTypeDef *p_context);
+static uint32_t Svc_Reflect(uint32_t value);
+static uint32_t Svc_IsInside(uint32_t start, uint32_t length, uint32_t offset, uint32_t size);
+static uint32_t Svc_IsWritable(uint32_t start, uint32_t length);
+static uint32_t Svc_FlashUnlock(void);
+static uint32_t Svc_FlashWait(void);
+static uint32_t Svc_FlashErase(uint32_t start, uint32_t length);
+static uint32_t Svc_FlashWrite(uint32_t destination, const uint8_t *p_source, uint32_t length);
+static uint16_t Svc_Crc16(uint16_t crc, const uint8_t *p_data, uint32_t length);
+static uint32_t Svc_Crc32(uint32_t crc, const uint8_t *p_data, uint32_t length);
+static uint32_t Svc_YmodemCheck(const uint8_t *p_packet);
+static uint32_t Svc_YmodemFrame(uint8_t *p_packet, uint8_t number, uint32_t size);
+
+/* Exported variables --------------------------------------------------------*/
+const Svc_TableTypeDef SvcTable SVC_AT =
+{
+  SVC_MAGIC,
+  SVC_VERSION,
+  SVC_COUNT,
+  Svc_FlashErase,
+  Svc_FlashWrite,
+  Svc_Crc16,
+  Svc_Crc32,
+  Svc_YmodemCheck,
+  Svc_YmodemFrame
+};
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Set up the CRC unit, keeping the configuration of the caller
+  * @param  p_context: filled with the registers to restore
+  * @param  cr: control register, without CRC_CR_RESET
+  * @param  pol: polynomial
+  * @param  init: initial value
+  * @retval None
+  */
+static void Svc_CrcOpen(Svc_CrcContextTypeDef *p_context, uint32_t cr, uint32_t pol, uint32_t init)
+{
+  p_context->clock = RCC->AHBENR & RCC_AHBENR_CRCEN;
+  if (p_context->clock == 0)
+  {
+    __HAL_RCC_CRC_CLK_ENABLE();
+  }
+  p_context->cr = CRC->CR & ~CRC_CR_RESET;
+  p_context->init = CRC->INIT;
+  p_context->pol = CRC->POL;
+
+  CRC->POL = pol;
+  CRC->INIT = init;
+  CRC->CR = cr | CRC_CR_RESET;
+}
+
+/**
+  * @brief  Give the CRC unit back to the caller
+  * @param  p_context: registers saved by Svc_CrcOpen
+  * @retval None
+  */
+static void Svc_CrcClose(const Svc_CrcContextTypeDef *p_context)
+{
+  CRC->POL = p_context->pol;
+  CRC->INIT = p_context->init;
+  CRC->CR = p_context->cr;
+  if (p_context->clock == 0)
+  {
+    __HAL_RCC_CRC_CLK_DISABLE();
+  }
+}
+
+/**
+  * @brief  Reverse the bits of a word, the Cortex-M0+ has no RBIT
+  * @param  value: word to reverse
+  * @retval Reversed word
+  */
+static uint32_t Svc_Reflect(uint32_t value)
+{
+  value = ((value >> 1) & 0x55555555U) | ((value & 0x55555555U) << 1);
+  value = ((value >> 2) & 0x33333333U) | ((value & 0x33333333U) << 2);
+  value = ((value >> 4) & 0x0F0F0F0FU) | ((value & 0x0F0F0F0FU) << 4);
+  value = ((value >> 8) & 0x00FF00FFU) | ((value & 0x00FF00FFU) << 8);
+  return (value >> 16) | (value << 16);
+}
+
+/**
+  * @brief  Check that a range lies inside a slot
+  * @param  start: first address
+  * @param  length: number of bytes
+  * @param  offset: slot start, from FLASH_BASE
+  * @param  size: slot size
+  * @retval 1 if inside, 0 otherwise
+  */
+static uint32_t Svc_IsInside(uint32_t start, uint32_t length, uint32_t offset, uint32_t size)
+{
+  if ((start < FLASH_BASE) || ((start - FLASH_BASE) < offset) || (length > size))
+  {
+    return 0;
+  }
+  return ((start - FLASH_BASE - offset) <= (size - length));
+}
+
+/**
+  * @brief  Check that a range may be erased or programmed by the application
+  * @note   Only inside one staging, calibration or resource slot that is not
+  *         read only. The application slot and the journal stay with the
+  *         bootloader: a VERIFIED record written by the application would
+  *         skip the signature check. Without a valid stored table, the
+  *         default calibration and resource slots. Read from Flash: the copy
+  *         of partition.c is not valid while the application runs.
+  * @param  start: first address
+  * @param  length: number of bytes
+  * @retval 1 if allowed, 0 otherwise
+  */
+static uint32_t Svc_IsWritable(uint32_t start, uint32_t length)
+{
+  const Part_TableTypeDef *p_table = (const Part_TableTypeDef *)PART_TABLE_ADDRESS;
+  const Part_SlotTypeDef *p_slot;
+  uint32_t i;
+
+  if ((start < APPLICATION_ADDRESS) || (start >= PART_TABLE_ADDRESS) || (length > (PART_TABLE_ADDRESS - start)))
+  {
+    return 0;
+  }
+  if ((p_table->magic != PART_MAGIC) || (p_table->version != PART_VERSION) ||
+      (p_table->count == 0) || (p_table->count > PART_MAX_SLOTS) ||
+      (Svc_Crc16(0, (const uint8_t *)p_table->slot, p_table->count * sizeof(Part_SlotTypeDef)) != p_table->crc))
+  {
+    return Svc_IsInside(start, length, CALIBRATION_ADDRESS - FLASH_BASE, CALIBRATION_SIZE) ||
+           Svc_IsInside(start, length, RESOURCE_ADDRESS - FLASH_BASE, RESOURCE_SIZE);
+  }
+  for (i = 0; i < p_table->count; i++)
+  {
+    p_slot = &p_table->slot[i];
+    if (((p_slot->type == PART_TYPE_STAGING) || (p_slot->type == PART_TYPE_CALIBRATION) ||
+         (p_slot->type == PART_TYPE_RESOURCE)) &&
+        ((p_slot->flags & PART_FLAG_READONLY) == 0) &&
+        Svc_IsInside(start, length, p_slot->offset, p_slot->size))
+    {
+      return 1;
+    }
+  }
+  return 0;
+}
+
+/**
+  * @brief  Unlock the Flash control register
+  * @param  None
+  * @retval 1 if it was locked, to lock again at the end
+  */
+static uint32_t Svc_FlashUnlock(void)
+{
+  if ((FLASH->CR & FLASH_CR_LOCK) == 0)
+  {
+    return 0;
+  }
+  FLASH->KEYR = FLASH_KEY1;
+  FLASH->KEYR = FLASH_KEY2;
+  return 1;
+}
+
+/**
+  * @brief  Wait for the end of a Flash operation and clear its flags
+  * @param  None
+  * @retval 1 if the operation succeeded, 0 otherwise
+  */
+static uint32_t Svc_FlashWait(void)
+{
+  uint32_t errors;
+
+  while (FLASH->SR & FLASH_SR_BSY1)
+  {
+  }
+  errors = FLASH->SR & SVC_FLASH_ERRORS;
+  FLASH->SR = SVC_FLASH_ERRORS | FLASH_SR_EOP;
+  while (FLASH->SR & FLASH_SR_CFGBSY)
+  {
+  }
+  return (errors == 0);
+}
+
+/**
+  * @brief  Erase the pages of a range
+  * @param  start: first address, in the first page
+  * @param  length: number of bytes, 0 erases nothing
+  * @retval 1 if erased, 0 otherwise
+  */
+static uint32_t Svc_FlashErase(uint32_t start, uint32_t length)
+{
+  uint32_t page, last, locked, result = 1;
+
+  if (!Svc_IsWritable(start, length))
+  {
+    return 0;
+  }
+  if (length == 0)
+  {
+    return 1;
+  }
+
+  locked = Svc_FlashUnlock();
+  Svc_FlashWait();
+  last = (start + length - 1 - FLASH_BASE) / FLASH_PAGE_SIZE;
+  for (page = (start - FLASH_BASE) / FLASH_PAGE_SIZE; (page <= last) && result; page++)
+  {
+    FLASH->CR = (FLASH->CR & ~FLASH_CR_PNB) | (page << FLASH_CR_PNB_Pos) | FLASH_CR_PER | FLASH_CR_STRT;
+    result = Svc_FlashWait();
+  }
+  FLASH->CR &= ~(FLASH_CR_PER | FLASH_CR_PNB);
+
+  /* Flush the instruction cache, as HAL_FLASHEx_Erase */
+  if (FLASH->ACR & FLASH_ACR_ICEN)
+  {
+    FLASH->ACR &= ~FLASH_ACR_ICEN;
+    FLASH->ACR |= FLASH_ACR_ICRST;
+    FLASH->ACR &= ~FLASH_ACR_ICRST;
+    FLASH->ACR |= FLASH_ACR_ICEN;
+  }
+  if (locked)
+  {
+    FLASH->CR |= FLASH_CR_LOCK;
+  }
+  return result;
+}
+
+/**
+  * @brief  Program a buffer by doublewords, then read it back
+  * @param  destination: first address, doubleword aligned and erased
+  * @param  p_source: data, any alignment
+  * @param  length: number of bytes, multiple of 8
+  * @retval 1 if written, 0 otherwise
+  */
+static uint32_t Svc_FlashWrite(uint32_t destination, const uint8_t *p_source, uint32_t length)
+{
+  uint32_t i, locked, result = 1;
+  uint32_t data[2];
+
+  if ((destination & 7U) || (length & 7U) || !Svc_IsWritable(destination, length))
+  {
+    return 0;
+  }
+
+  locked = Svc_FlashUnlock();
+  Svc_FlashWait();
+  FLASH->CR |= FLASH_CR_PG;
+  for (i = 0; (i < length) && result; i += 8)
+  {
+    memcpy(data, &p_source[i], sizeof(data));
+    *(__IO uint32_t *)(destination + i) = data[0];
+    __ISB();
+    *(__IO uint32_t *)(destination + i + 4) = data[1];
+    result = Svc_FlashWait() && (memcmp((const void *)(destination + i), data, sizeof(data)) == 0);
+  }
+  FLASH->CR &= ~FLASH_CR_PG;
+  if (locked)
+  {
+    FLASH->CR |= FLASH_CR_LOCK;
+  }
+  return result;
+}
+
+/**
+  * @brief  Update a CRC16-XMODEM, on the CRC unit
+  * @param  crc: running value, 0 to start
+  * @param  p_data: data to add
+  * @param  length: number of bytes
+  * @retval Running value
+  */
+static uint16_t Svc_Crc16(uint16_t crc, const uint8_t *p_data, uint32_t length)
+{
+  Svc_CrcContextTypeDef context;
+
+  Svc_CrcOpen(&context, CRC_CR_POLYSIZE_0, 0x1021U, crc);
+  while (length-- != 0)
+  {
+    *(__IO uint8_t *)&CRC->DR = *p_data++;
+  }
+  crc = (uint16_t)CRC->DR;
+  Svc_CrcClose(&context);
+  return crc;
+}
+
+/**
+  * @brief  Update a CRC-32 (zlib), on the CRC unit
+  * @note   Bytes in and result reflected: the running value is the reflected
+  *         register, given back in INIT reflected again.
+  * @param  crc: running value, 0xFFFFFFFF to start
+  * @param  p_data: data to add
+  * @param  length: number of bytes
+  * @retval Running value, to invert at the end
+  */
+static uint32_t Svc_Crc32(uint32_t crc, const uint8_t *p_data, uint32_t length)
+{
+  Svc_CrcContextTypeDef context;
+
+  Svc_CrcOpen(&context, CRC_CR_REV_IN_0 | CRC_CR_REV_OUT, 0x04C11DB7U, Svc_Reflect(crc));
+  while (length-- != 0)
+  {
+    *(__IO uint8_t *)&CRC->DR = *p_data++;
+  }
+  crc = CRC->DR;
+  Svc_CrcClose(&context);
+  return crc;
+}
+
+/**
+  * @brief  Check a received YMODEM packet: start byte, number and CRC
+  * @param  p_packet: packet in the layout of ymodem_packet.h, start byte at
+  *         PACKET_START_INDEX
+  * @retval Number of data bytes, 0 if the packet is not valid
+  */
+static uint32_t Svc_YmodemCheck(const uint8_t *p_packet)
+{
+  const uint8_t *p_data = &p_packet[PACKET_DATA_INDEX];
+  uint32_t size;
+  uint16_t crc;
+
+  switch (p_packet[PACKET_START_INDEX])
+  {
+    case SOH:
+      size = PACKET_SIZE;
+      break;
+    case STX:
+      size = PACKET_1K_SIZE;
+      break;
+    default:
+      return 0;
+  }
+  if (p_packet[PACKET_NUMBER_INDEX] != (p_packet[PACKET_CNUMBER_INDEX] ^ NEGATIVE_BYTE))
+  {
+    return 0;
+  }
+  crc = ((uint16_t)p_data[size] << 8) | p_data[size + 1];
+  return (Svc_Crc16(0, p_data, size) == crc) ? size : 0;
+}
+
+/**
+  * @brief  Add the header and the CRC trailer to the data of a YMODEM packet
+  * @param  p_packet: packet in the layout of ymodem_packet.h, data already padded
+  * @param  number: packet number
+  * @param  size: PACKET_SIZE or PACKET_1K_SIZE
+  * @retval Bytes to send from PACKET_START_INDEX
+  */
+static uint32_t Svc_YmodemFrame(uint8_t *p_packet, uint8_t number, uint32_t size)
+{
+  uint16_t crc;
+
+  size = (size > PACKET_SIZE) ? PACKET_1K_SIZE : PACKET_SIZE;
+  p_packet[PACKET_START_INDEX] = (size == PACKET_1K_SIZE) ? STX : SOH;
+  p_packet[PACKET_NUMBER_INDEX] = number;
+  p_packet[PACKET_CNUMBER_INDEX] = number ^ NEGATIVE_BYTE;
+  crc = Svc_Crc16(0, &p_packet[PACKET_DATA_INDEX], size);
+  p_packet[PACKET_DATA_INDEX + size] = (uint8_t)(crc >> 8);
+  p_packet[PACKET_DATA_INDEX + size + 1] = (uint8_t)crc;
+  return PACKET_HEADER_SIZE + size + PACKET_TRAILER_SIZE;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,293 @@
+/**
+  ******************************************************************************
+  * @file    sha256.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides an incremental SHA-256 (FIPS 180-4) written for
+  *          the Cortex-M0+: the image is hashed block by block as it is
+  *          received, so the digest is ready when the transfer ends.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sha256.h"
+#include "prof.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+#define SHA256_SELFTEST_SIZE    ((uint32_t)0x4000) /* Timed over the bootloader image */
+
+/* Private macro -------------------------------------------------------------*/
+#define ROTR(x, n)              (((x) >> (n)) | ((x) << (32 - (n))))
+
+/* The three rotations of each sigma are nested so that only one temporary is
+ * live: Thumb-1 has eight low registers for the eight working variables. */
+#define BSIG0(x)                ROTR((x) ^ ROTR((x) ^ ROTR((x), 9), 11), 2)
+#define BSIG1(x)                ROTR((x) ^ ROTR((x) ^ ROTR((x), 14), 5), 6)
+#define SSIG0(x)                (ROTR((x) ^ ROTR((x), 11), 7) ^ ((x) >> 3))
+#define SSIG1(x)                (ROTR((x) ^ ROTR((x), 2), 17) ^ ((x) >> 10))
+#define CH(x, y, z)             ((z) ^ ((x) & ((y) ^ (z))))
+#define MAJ(x, y, z)            (((x) & (y)) | ((z) & ((x) | (y))))
+
+/* Message word j of the 8 round group starting at round i: loaded for the
+ * first 16 rounds, then expanded in place in the 16 word ring */
+#define SCHEDULE(w, i, j)       (((i) < 16) ? (w)[((i) & 8) + (j)] : \
+                                 ((w)[((i) & 8) + (j)] += SSIG1((w)[((i) + (j) + 14) & 15]) + \
+                                   (w)[((i) + (j) + 9) & 15] + SSIG0((w)[((i) + (j) + 1) & 15])))
+
+/* One round, the caller rotates the variable names instead of moving them */
+#define ROUND(a, b, c, d, e, f, g, h, w, i, j)                                 \
+  do                                                                            \
+  {                                                                             \
+    (h) += BSIG1(e) + CH((e), (f), (g)) + aSha256K[(i) + (j)] + SCHEDULE((w), (i), (j)); \
+    (d) += (h);                                                                 \
+    (h) += BSIG0(a) + MAJ((a), (b), (c));                                       \
+  } while (0)
+
+/* Private variables ---------------------------------------------------------*/
+static const uint32_t aSha256K[64] =
+{
+  0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+  0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+  0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+  0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+  0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+  0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+  0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+  0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2
+};
+
+static const uint32_t aSha256Init[8] =
+{
+  0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a, 0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Sha256_Block(uint32_t *p_state, const uint8_t *p_block);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Compress one 64-byte block into the state
+  * @note   Rounds are unrolled by 8 so that the working variables rotate by
+  *         renaming, and the message schedule is expanded in a 16 word ring
+  *         rather than a 64 word array.
+  * @param  p_state: hash state
+  * @param  p_block: 64 bytes, any alignment
+  * @retval None
+  */
+static void Sha256_Block(uint32_t *p_state, const uint8_t *p_block)
+{
+  uint32_t w[16];
+  uint32_t a, b, c, d, e, f, g, h, i;
+
+  if (((uint32_t)p_block & 3U) == 0)
+  {
+    for (i = 0; i < 16; i++)
+    {
+      w[i] = __REV(((const uint32_t *)p_block)[i]);
+    }
+  }
+  else
+  {
+    for (i = 0; i < 16; i++, p_block += 4)
+    {
+      w[i] = ((uint32_t)p_block[0] << 24) | ((uint32_t)p_block[1] << 16) |
+             ((uint32_t)p_block[2] << 8) | p_block[3];
+    }
+  }
+
+  a = p_state[0];
+  b = p_state[1];
+  c = p_state[2];
+  d = p_state[3];
+  e = p_state[4];
+  f = p_state[5];
+  g = p_state[6];
+  h = p_state[7];
+
+  for (i = 0; i < 64; i += 8)
+  {
+    ROUND(a, b, c, d, e, f, g, h, w, i, 0);
+    ROUND(h, a, b, c, d, e, f, g, w, i, 1);
+    ROUND(g, h, a, b, c, d, e, f, w, i, 2);
+    ROUND(f, g, h, a, b, c, d, e, w, i, 3);
+    ROUND(e, f, g, h, a, b, c, d, w, i, 4);
+    ROUND(d, e, f, g, h, a, b, c, w, i, 5);
+    ROUND(c, d, e, f, g, h, a, b, w, i, 6);
+    ROUND(b, c, d, e, f, g, h, a, w, i, 7);
+  }
+
+  p_state[0] += a;
+  p_state[1] += b;
+  p_state[2] += c;
+  p_state[3] += d;
+  p_state[4] += e;
+  p_state[5] += f;
+  p_state[6] += g;
+  p_state[7] += h;
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Start a hash
+  * @param  p_ctx: hash to start
+  * @retval None
+  */
+void Sha256_Init(Sha256_CtxTypeDef *p_ctx)
+{
+  memcpy(p_ctx->state, aSha256Init, sizeof(aSha256Init));
+  p_ctx->length = 0;
+}
+
+/**
+  * @brief  Hash more bytes
+  * @note   Whole blocks are compressed straight from p_data, only the bytes
+  *         of a partial block are copied.
+  * @param  p_ctx: hash in progress
+  * @param  p_data: bytes to hash, any alignment
+  * @param  length: number of bytes
+  * @retval None
+  */
+void Sha256_Update(Sha256_CtxTypeDef *p_ctx, const uint8_t *p_data, uint32_t length)
+{
+  uint32_t fill = p_ctx->length % SHA256_BLOCK_SIZE;
+  uint32_t chunk;
+
+  p_ctx->length += length;
+  if (fill != 0)
+  {
+    chunk = SHA256_BLOCK_SIZE - fill;
+    if (chunk > length)
+    {
+      chunk = length;
+    }
+    memcpy(&p_ctx->buffer[fill], p_data, chunk);
+    p_data += chunk;
+    length -= chunk;
+    if ((fill + chunk) < SHA256_BLOCK_SIZE)
+    {
+      return;
+    }
+    Sha256_Block(p_ctx->state, p_ctx->buffer);
+  }
+  while (length >= SHA256_BLOCK_SIZE)
+  {
+    Sha256_Block(p_ctx->state, p_data);
+    p_data += SHA256_BLOCK_SIZE;
+    length -= SHA256_BLOCK_SIZE;
+  }
+  memcpy(p_ctx->buffer, p_data, length);
+}
+
+/**
+  * @brief  End a hash
+  * @param  p_ctx: hash in progress, to be started again before reuse
+  * @param  p_digest: receives SHA256_DIGEST_SIZE bytes
+  * @retval None
+  */
+void Sha256_Final(Sha256_CtxTypeDef *p_ctx, uint8_t *p_digest)
+{
+  uint32_t fill = p_ctx->length % SHA256_BLOCK_SIZE;
+  uint32_t i;
+
+  /* Padding: 0x80, zeros, then the bit length big endian */
+  p_ctx->buffer[fill++] = 0x80;
+  if (fill > (SHA256_BLOCK_SIZE - 8))
+  {
+    memset(&p_ctx->buffer[fill], 0, SHA256_BLOCK_SIZE - fill);
+    Sha256_Block(p_ctx->state, p_ctx->buffer);
+    fill = 0;
+  }
+  memset(&p_ctx->buffer[fill], 0, SHA256_BLOCK_SIZE - 8 - fill);
+  p_ctx->buffer[56] = 0;
+  p_ctx->buffer[57] = 0;
+  p_ctx->buffer[58] = 0;
+  p_ctx->buffer[59] = (uint8_t)(p_ctx->length >> 29);
+  p_ctx->buffer[60] = (uint8_t)(p_ctx->length >> 21);
+  p_ctx->buffer[61] = (uint8_t)(p_ctx->length >> 13);
+  p_ctx->buffer[62] = (uint8_t)(p_ctx->length >> 5);
+  p_ctx->buffer[63] = (uint8_t)(p_ctx->length << 3);
+  Sha256_Block(p_ctx->state, p_ctx->buffer);
+
+  for (i = 0; i < 8; i++)
+  {
+    p_digest[4 * i]     = (uint8_t)(p_ctx->state[i] >> 24);
+    p_digest[4 * i + 1] = (uint8_t)(p_ctx->state[i] >> 16);
+    p_digest[4 * i + 2] = (uint8_t)(p_ctx->state[i] >> 8);
+    p_digest[4 * i + 3] = (uint8_t)p_ctx->state[i];
+  }
+}
+
+/**
+  * @brief  Hash a buffer in one call
+  * @param  p_data: bytes to hash, any alignment
+  * @param  length: number of bytes
+  * @param  p_digest: receives SHA256_DIGEST_SIZE bytes
+  * @retval None
+  */
+void Sha256(const uint8_t *p_data, uint32_t length, uint8_t *p_digest)
+{
+  Sha256_CtxTypeDef ctx;
+
+  Sha256_Init(&ctx);
+  Sha256_Update(&ctx, p_data, length);
+  Sha256_Final(&ctx, p_digest);
+}
+
+#ifdef IAP_PROFILE
+/**
+  * @brief  Check the FIPS 180 test vectors, then time the hash
+  * @note   The bootloader image is hashed for the timing, from Flash as in
+  *         the digest command.
+  * @param  None
+  * @retval Core cycles per byte, 0 if a test vector fails
+  */
+uint32_t Sha256_SelfTest(void)
+{
+  static const char * const aMessages[3] =
+  {
+    "",
+    "abc",
+    "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"
+  };
+  static const uint8_t aDigests[3][SHA256_DIGEST_SIZE] =
+  {
+    { 0xe3, 0xb0, 0xc4, 0x42, 0x98, 0xfc, 0x1c, 0x14, 0x9a, 0xfb, 0xf4, 0xc8, 0x99, 0x6f, 0xb9, 0x24,
+      0x27, 0xae, 0x41, 0xe4, 0x64, 0x9b, 0x93, 0x4c, 0xa4, 0x95, 0x99, 0x1b, 0x78, 0x52, 0xb8, 0x55 },
+    { 0xba, 0x78, 0x16, 0xbf, 0x8f, 0x01, 0xcf, 0xea, 0x41, 0x41, 0x40, 0xde, 0x5d, 0xae, 0x22, 0x23,
+      0xb0, 0x03, 0x61, 0xa3, 0x96, 0x17, 0x7a, 0x9c, 0xb4, 0x10, 0xff, 0x61, 0xf2, 0x00, 0x15, 0xad },
+    { 0x24, 0x8d, 0x6a, 0x61, 0xd2, 0x06, 0x38, 0xb8, 0xe5, 0xc0, 0x26, 0x93, 0x0c, 0x3e, 0x60, 0x39,
+      0xa3, 0x3c, 0xe4, 0x59, 0x64, 0xff, 0x21, 0x67, 0xf6, 0xec, 0xed, 0xd4, 0x19, 0xdb, 0x06, 0xc1 }
+  };
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  uint32_t i, cycles;
+
+  for (i = 0; i < 3; i++)
+  {
+    Sha256((const uint8_t *)aMessages[i], strlen(aMessages[i]), digest);
+    if (memcmp(digest, aDigests[i], SHA256_DIGEST_SIZE) != 0)
+    {
+      return 0;
+    }
+  }
+
+  cycles = Prof_Now();
+  Sha256((const uint8_t *)FLASH_BASE, SHA256_SELFTEST_SIZE, digest);
+  cycles = Prof_Now() - cycles;
+  return cycles / SHA256_SELFTEST_SIZE;
+}
+#endif /* IAP_PROFILE */
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
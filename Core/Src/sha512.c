@@ -0,0 +1,188 @@
+/**
+  ******************************************************************************
+  * @file    sha512.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides an incremental SHA-512 (FIPS 180-4). It only
+  *          hashes the short challenge of an Ed25519 verification, so it is
+  *          kept small rather than fast.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "sha512.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+#define ROTR64(x, n)            (((x) >> (n)) | ((x) << (64 - (n))))
+#define BSIG0(x)                (ROTR64((x), 28) ^ ROTR64((x), 34) ^ ROTR64((x), 39))
+#define BSIG1(x)                (ROTR64((x), 14) ^ ROTR64((x), 18) ^ ROTR64((x), 41))
+#define SSIG0(x)                (ROTR64((x), 1) ^ ROTR64((x), 8) ^ ((x) >> 7))
+#define SSIG1(x)                (ROTR64((x), 19) ^ ROTR64((x), 61) ^ ((x) >> 6))
+
+/* Private variables ---------------------------------------------------------*/
+static const uint64_t aSha512K[80] =
+{
+  0x428a2f98d728ae22ULL, 0x7137449123ef65cdULL, 0xb5c0fbcfec4d3b2fULL, 0xe9b5dba58189dbbcULL,
+  0x3956c25bf348b538ULL, 0x59f111f1b605d019ULL, 0x923f82a4af194f9bULL, 0xab1c5ed5da6d8118ULL,
+  0xd807aa98a3030242ULL, 0x12835b0145706fbeULL, 0x243185be4ee4b28cULL, 0x550c7dc3d5ffb4e2ULL,
+  0x72be5d74f27b896fULL, 0x80deb1fe3b1696b1ULL, 0x9bdc06a725c71235ULL, 0xc19bf174cf692694ULL,
+  0xe49b69c19ef14ad2ULL, 0xefbe4786384f25e3ULL, 0x0fc19dc68b8cd5b5ULL, 0x240ca1cc77ac9c65ULL,
+  0x2de92c6f592b0275ULL, 0x4a7484aa6ea6e483ULL, 0x5cb0a9dcbd41fbd4ULL, 0x76f988da831153b5ULL,
+  0x983e5152ee66dfabULL, 0xa831c66d2db43210ULL, 0xb00327c898fb213fULL, 0xbf597fc7beef0ee4ULL,
+  0xc6e00bf33da88fc2ULL, 0xd5a79147930aa725ULL, 0x06ca6351e003826fULL, 0x142929670a0e6e70ULL,
+  0x27b70a8546d22ffcULL, 0x2e1b21385c26c926ULL, 0x4d2c6dfc5ac42aedULL, 0x53380d139d95b3dfULL,
+  0x650a73548baf63deULL, 0x766a0abb3c77b2a8ULL, 0x81c2c92e47edaee6ULL, 0x92722c851482353bULL,
+  0xa2bfe8a14cf10364ULL, 0xa81a664bbc423001ULL, 0xc24b8b70d0f89791ULL, 0xc76c51a30654be30ULL,
+  0xd192e819d6ef5218ULL, 0xd69906245565a910ULL, 0xf40e35855771202aULL, 0x106aa07032bbd1b8ULL,
+  0x19a4c116b8d2d0c8ULL, 0x1e376c085141ab53ULL, 0x2748774cdf8eeb99ULL, 0x34b0bcb5e19b48a8ULL,
+  0x391c0cb3c5c95a63ULL, 0x4ed8aa4ae3418acbULL, 0x5b9cca4f7763e373ULL, 0x682e6ff3d6b2b8a3ULL,
+  0x748f82ee5defb2fcULL, 0x78a5636f43172f60ULL, 0x84c87814a1f0ab72ULL, 0x8cc702081a6439ecULL,
+  0x90befffa23631e28ULL, 0xa4506cebde82bde9ULL, 0xbef9a3f7b2c67915ULL, 0xc67178f2e372532bULL,
+  0xca273eceea26619cULL, 0xd186b8c721c0c207ULL, 0xeada7dd6cde0eb1eULL, 0xf57d4f7fee6ed178ULL,
+  0x06f067aa72176fbaULL, 0x0a637dc5a2c898a6ULL, 0x113f9804bef90daeULL, 0x1b710b35131c471bULL,
+  0x28db77f523047d84ULL, 0x32caab7b40c72493ULL, 0x3c9ebe0a15c9bebcULL, 0x431d67c49c100d4cULL,
+  0x4cc5d4becb3e42b6ULL, 0x597f299cfc657e2aULL, 0x5fcb6fab3ad6faecULL, 0x6c44198c4a475817ULL
+};
+
+static const uint64_t aSha512Init[8] =
+{
+  0x6a09e667f3bcc908ULL, 0xbb67ae8584caa73bULL, 0x3c6ef372fe94f82bULL, 0xa54ff53a5f1d36f1ULL,
+  0x510e527fade682d1ULL, 0x9b05688c2b3e6c1fULL, 0x1f83d9abfb41bd6bULL, 0x5be0cd19137e2179ULL
+};
+
+/* Private function prototypes -----------------------------------------------*/
+static void Sha512_Block(uint64_t *p_state, const uint8_t *p_block);
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Compress one 128-byte block into the state
+  * @param  p_state: hash state
+  * @param  p_block: 128 bytes, any alignment
+  * @retval None
+  */
+static void Sha512_Block(uint64_t *p_state, const uint8_t *p_block)
+{
+  uint64_t w[16], v[8], t1, t2;
+  uint32_t i, j;
+
+  for (i = 0; i < 16; i++)
+  {
+    w[i] = 0;
+    for (j = 0; j < 8; j++)
+    {
+      w[i] = (w[i] << 8) | *p_block++;
+    }
+  }
+  memcpy(v, p_state, sizeof(v));
+
+  for (i = 0; i < 80; i++)
+  {
+    if (i >= 16)
+    {
+      w[i & 15] += SSIG1(w[(i + 14) & 15]) + w[(i + 9) & 15] + SSIG0(w[(i + 1) & 15]);
+    }
+    t1 = v[7] + BSIG1(v[4]) + (v[6] ^ (v[4] & (v[5] ^ v[6]))) + aSha512K[i] + w[i & 15];
+    t2 = BSIG0(v[0]) + ((v[0] & v[1]) | (v[2] & (v[0] | v[1])));
+    memmove(&v[1], &v[0], 7 * sizeof(uint64_t));
+    v[4] += t1;
+    v[0] = t1 + t2;
+  }
+
+  for (i = 0; i < 8; i++)
+  {
+    p_state[i] += v[i];
+  }
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Start a hash
+  * @param  p_ctx: hash to start
+  * @retval None
+  */
+void Sha512_Init(Sha512_CtxTypeDef *p_ctx)
+{
+  memcpy(p_ctx->state, aSha512Init, sizeof(aSha512Init));
+  p_ctx->length = 0;
+}
+
+/**
+  * @brief  Hash more bytes
+  * @param  p_ctx: hash in progress
+  * @param  p_data: bytes to hash, any alignment
+  * @param  length: number of bytes
+  * @retval None
+  */
+void Sha512_Update(Sha512_CtxTypeDef *p_ctx, const uint8_t *p_data, uint32_t length)
+{
+  uint32_t fill = p_ctx->length % SHA512_BLOCK_SIZE;
+  uint32_t chunk;
+
+  p_ctx->length += length;
+  while (length != 0)
+  {
+    chunk = SHA512_BLOCK_SIZE - fill;
+    if (chunk > length)
+    {
+      chunk = length;
+    }
+    memcpy(&p_ctx->buffer[fill], p_data, chunk);
+    p_data += chunk;
+    length -= chunk;
+    fill += chunk;
+    if (fill == SHA512_BLOCK_SIZE)
+    {
+      Sha512_Block(p_ctx->state, p_ctx->buffer);
+      fill = 0;
+    }
+  }
+}
+
+/**
+  * @brief  End a hash
+  * @param  p_ctx: hash in progress, to be started again before reuse
+  * @param  p_digest: receives SHA512_DIGEST_SIZE bytes
+  * @retval None
+  */
+void Sha512_Final(Sha512_CtxTypeDef *p_ctx, uint8_t *p_digest)
+{
+  uint32_t fill = p_ctx->length % SHA512_BLOCK_SIZE;
+  uint32_t i;
+
+  /* Padding: 0x80, zeros, then the 128-bit bit length big endian */
+  p_ctx->buffer[fill++] = 0x80;
+  if (fill > (SHA512_BLOCK_SIZE - 16))
+  {
+    memset(&p_ctx->buffer[fill], 0, SHA512_BLOCK_SIZE - fill);
+    Sha512_Block(p_ctx->state, p_ctx->buffer);
+    fill = 0;
+  }
+  memset(&p_ctx->buffer[fill], 0, SHA512_BLOCK_SIZE - 5 - fill);
+  p_ctx->buffer[123] = (uint8_t)(p_ctx->length >> 29);
+  p_ctx->buffer[124] = (uint8_t)(p_ctx->length >> 21);
+  p_ctx->buffer[125] = (uint8_t)(p_ctx->length >> 13);
+  p_ctx->buffer[126] = (uint8_t)(p_ctx->length >> 5);
+  p_ctx->buffer[127] = (uint8_t)(p_ctx->length << 3);
+  Sha512_Block(p_ctx->state, p_ctx->buffer);
+
+  for (i = 0; i < SHA512_DIGEST_SIZE; i++)
+  {
+    p_digest[i] = (uint8_t)(p_ctx->state[i / 8] >> (56 - 8 * (i % 8)));
+  }
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,107 @@
+/**
+  ******************************************************************************
+  * @file    stage.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the install of an update staged by the running
+  *          application (APPCore/Src/update_agent.c): at boot, a complete
+  *          image in the staging slot is checked then copied over the
+  *          application slot. The header is erased once the copy checks, a
+  *          copy cut short is made again at the next boot.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "stage.h"
+#include "partition.h"
+#include "flash_if.h"
+#include "digest.h"
+#include "sha256.h"
+#include "verify.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Install the staged update, if any
+  * @note   The CRC unit must be initialised. A staged image that does not
+  *         check is dropped and the application slot is left as it is.
+  * @param  None
+  * @retval 1 if an image was installed, 0 otherwise
+  */
+uint32_t Stage_Install(void)
+{
+  const Part_SlotTypeDef *p_slot = Part_Find(PART_TYPE_STAGING);
+  const Stage_HeaderTypeDef *p_header;
+  uint32_t start, image, app = Part_Address(PART_TYPE_APP);
+#ifdef IAP_SIGNED_IMAGES
+  uint8_t digest[SHA256_DIGEST_SIZE];
+#endif /* IAP_SIGNED_IMAGES */
+
+  if (p_slot == NULL)
+  {
+    return 0;
+  }
+  start = FLASH_BASE + p_slot->offset;
+  image = start + STAGE_IMAGE_OFFSET;
+  p_header = (const Stage_HeaderTypeDef *)start;
+  if (p_header->magic != STAGE_MAGIC)
+  {
+    return 0;
+  }
+
+  if ((p_header->length == 0) || (p_header->length > (p_slot->size - STAGE_IMAGE_OFFSET)) ||
+      (p_header->length > Part_Size(PART_TYPE_APP)) ||
+      (Digest_Crc32(image, p_header->length) != p_header->crc))
+  {
+    FLASH_If_EraseRange(start, FLASH_PAGE_SIZE);
+    return 0;
+  }
+#ifdef IAP_SIGNED_IMAGES
+  /* Keep the running application rather than install one that cannot start */
+  if (p_header->length <= VERIFY_TRAILER_SIZE)
+  {
+    FLASH_If_EraseRange(start, FLASH_PAGE_SIZE);
+    return 0;
+  }
+  Sha256((const uint8_t *)image, p_header->length - VERIFY_TRAILER_SIZE, digest);
+  if (!Verify_Image(image, p_header->length, digest))
+  {
+    FLASH_If_EraseRange(start, FLASH_PAGE_SIZE);
+    return 0;
+  }
+#endif /* IAP_SIGNED_IMAGES */
+
+  /* Already copied when the header erase was cut short */
+  if (Digest_Crc32(app, p_header->length) != p_header->crc)
+  {
+    if (FLASH_If_EraseRange(app, Part_Size(PART_TYPE_APP)) != FLASHIF_OK)
+    {
+      return 0;
+    }
+    FLASH_If_StreamOpen(app);
+    FLASH_If_StreamWrite((const uint8_t *)image, p_header->length);
+    if ((FLASH_If_StreamClose() != FLASHIF_OK) || (Digest_Crc32(app, p_header->length) != p_header->crc))
+    {
+      return 0;
+    }
+  }
+  FLASH_If_EraseRange(start, FLASH_PAGE_SIZE);
+  return 1;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
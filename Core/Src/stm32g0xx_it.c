@@ -23,6 +23,8 @@
 #include "stm32g0xx_it.h"
 /* Private includes ----------------------------------------------------------*/
 /* USER CODE BEGIN Includes */
+#include "serial_rx.h"
+#include "boot_time.h"
 /* USER CODE END Includes */
 
 /* Private typedef -----------------------------------------------------------*/
@@ -56,6 +58,7 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_usart2_tx;
 extern UART_HandleTypeDef huart2;
 /* USER CODE BEGIN EV */
 
@@ -142,13 +145,33 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32g0xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles DMA1 channel 1 interrupt.
+  */
+void DMA1_Channel1_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel1_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel1_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+  /* USER CODE BEGIN DMA1_Channel1_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel1_IRQn 1 */
+}
+
 /**
   * @brief This function handles USART2 global interrupt / USART2 wake-up interrupt through EXTI line 26.
   */
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQn 0 */
-
+  Serial_RxIRQHandler();
+  /* Transmission is by DMA without UART interrupts: HAL_UART_IRQHandler is
+     in Flash and would stall while the Flash is busy */
+  if ((huart2.Instance->CR1 & (USART_CR1_TCIE | USART_CR1_TXEIE_TXFNFIE)) == 0)
+  {
+    return;
+  }
   /* USER CODE END USART2_IRQn 0 */
   HAL_UART_IRQHandler(&huart2);
   /* USER CODE BEGIN USART2_IRQn 1 */
@@ -158,5 +181,37 @@ void USART2_IRQHandler(void)
 
 /* USER CODE BEGIN 1 */
 
+/**
+  * @brief  Tick of the HAL, here to run from SRAM with the interrupt
+  *         handlers: the Flash driver waits on it while the Flash is busy
+  * @param  None
+  * @retval None
+  */
+void HAL_IncTick(void)
+{
+  uwTick += uwTickFreq;
+}
+
+/**
+  * @brief  Tick value in ms, see HAL_IncTick
+  * @param  None
+  * @retval Tick value
+  */
+uint32_t HAL_GetTick(void)
+{
+  return uwTick;
+}
+
+/**
+  * @brief  Boot phase timer, only running until the application starts or
+  *         the IAP is entered
+  * @param  None
+  * @retval None
+  */
+void TIM6_IRQHandler(void)
+{
+  BootTime_IRQHandler();
+}
+
 /* USER CODE END 1 */
 /************************ (C) COPYRIGHT STMicroelectronics *****END OF FILE****/
@@ -77,6 +77,7 @@
   */
 
 #include "stm32g0xx.h"
+#include "boot_time.h"
 
 #if !defined  (HSE_VALUE)
 #define HSE_VALUE    (8000000UL)    /*!< Value of the External oscillator in Hz */
@@ -174,6 +175,8 @@ void SystemInit(void)
 #else
   SCB->VTOR = FLASH_BASE | VECT_TAB_OFFSET; /* Vector Table Relocation in Internal FLASH */
 #endif
+  /* Phase timing from reset, see boot_time.c */
+  BootTime_Start();
 }
 
 /**
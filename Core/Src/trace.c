@@ -0,0 +1,102 @@
+/**
+  ******************************************************************************
+  * @file    trace.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the binary event trace: a fixed RAM ring of
+  *          timestamped protocol and flash events that a host tool fetches
+  *          after a session (see Tools/trace_decode.py).
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "trace.h"
+#include "prof.h"
+#include "common.h"
+#include "main.h"
+
+#ifdef IAP_TRACE
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+static Trace_RecordTypeDef aTraceRing[TRACE_DEPTH];
+static uint32_t TraceTotal;   /* Records written since Trace_Reset() */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Empty the trace ring
+  * @param  None
+  * @retval None
+  */
+void Trace_Reset(void)
+{
+  TraceTotal = 0;
+}
+
+/**
+  * @brief  Append an event, overwriting the oldest one when the ring is full
+  * @param  event: event code
+  * @param  arg8: event specific byte
+  * @param  arg16: event specific half word
+  * @retval None
+  */
+void Trace_Record(Trace_EventTypeDef event, uint8_t arg8, uint16_t arg16)
+{
+  Trace_RecordTypeDef *p_rec = &aTraceRing[TraceTotal & (TRACE_DEPTH - 1)];
+
+  p_rec->stamp = Prof_Now();
+  p_rec->event = (uint8_t)event;
+  p_rec->arg8 = arg8;
+  p_rec->arg16 = arg16;
+  TraceTotal++;
+}
+
+/**
+  * @brief  Send the trace as a binary blob: a Trace_HeaderTypeDef followed by
+  *         the records, oldest first
+  * @param  None
+  * @retval None
+  */
+void Trace_Export(void)
+{
+  Trace_HeaderTypeDef header;
+  uint32_t count, first;
+
+  count = (TraceTotal < TRACE_DEPTH) ? TraceTotal : TRACE_DEPTH;
+  first = (TraceTotal - count) & (TRACE_DEPTH - 1);
+
+  header.magic = TRACE_MAGIC;
+  header.version = TRACE_VERSION;
+  header.record_size = sizeof(Trace_RecordTypeDef);
+  header.count = (uint16_t)count;
+  header.clock_hz = SystemCoreClock;
+  header.dropped = TraceTotal - count;
+  Serial_PutData((uint8_t *)&header, sizeof(header));
+
+  /* The oldest record may sit anywhere in the ring: send up to the end, then the start */
+  if ((first + count) > TRACE_DEPTH)
+  {
+    Serial_PutData((uint8_t *)&aTraceRing[first], (TRACE_DEPTH - first) * sizeof(Trace_RecordTypeDef));
+    count -= TRACE_DEPTH - first;
+    first = 0;
+  }
+  Serial_PutData((uint8_t *)&aTraceRing[first], count * sizeof(Trace_RecordTypeDef));
+}
+
+#endif /* IAP_TRACE */
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,131 @@
+/**
+  ******************************************************************************
+  * @file    verify.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the signature check of the application.
+  *          An application is checked once, when downloaded or at the first
+  *          boot after; the result is journaled with the CRC-32 of the image
+  *          so that the next boots only run the CRC unit over it.
+  ******************************************************************************
+  */
+
+/** @addtogroup STM32G0xx_IAP
+  * @{
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "verify.h"
+#include "sha256.h"
+#include "digest.h"
+#include "journal.h"
+#include "partition.h"
+#include "flash_if.h"
+#include "ymodem.h"
+#include "string.h"
+
+/* Private typedef -----------------------------------------------------------*/
+/* Private define ------------------------------------------------------------*/
+/* Private macro -------------------------------------------------------------*/
+/* Private variables ---------------------------------------------------------*/
+/* Key of the images accepted, Core/Inc/verify_key.h made for the product by
+ * Tools/sign_image.py keygen. No key is built in. */
+#if defined(IAP_SIGNED_IMAGES) || defined(YMODEM_MANIFEST)
+#if defined(__has_include)
+#if !__has_include("verify_key.h")
+#error "Signature checks need Core/Inc/verify_key.h: run Tools/sign_image.py keygen"
+#endif
+#endif
+#include "verify_key.h"
+static const uint8_t aPublicKey[ED25519_PUBLIC_KEY_SIZE] = VERIFY_PUBLIC_KEY;
+#endif /* IAP_SIGNED_IMAGES || YMODEM_MANIFEST */
+
+/* Private function prototypes -----------------------------------------------*/
+/* Private functions ---------------------------------------------------------*/
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Check a signature made with the key of the images
+  * @param  p_signature: ED25519_SIGNATURE_SIZE bytes
+  * @param  p_message: signed bytes
+  * @param  length: number of signed bytes
+  * @retval 1 if the signature is valid, 0 otherwise or without a key
+  */
+uint32_t Verify_Signature(const uint8_t *p_signature, const uint8_t *p_message, uint32_t length)
+{
+#if defined(IAP_SIGNED_IMAGES) || defined(YMODEM_MANIFEST)
+  return Ed25519_Verify(p_signature, aPublicKey, p_message, length);
+#else
+  /* Built without a key: nothing is signed */
+  return 0;
+#endif /* IAP_SIGNED_IMAGES || YMODEM_MANIFEST */
+}
+
+/**
+  * @brief  Check the signature trailer of an image
+  * @param  start: address of the image
+  * @param  size: size of the image, trailer included
+  * @param  p_digest: SHA-256 of the size - VERIFY_TRAILER_SIZE bytes before
+  *         the trailer
+  * @retval 1 if the image is signed with aPublicKey, 0 otherwise
+  */
+uint32_t Verify_Image(uint32_t start, uint32_t size, const uint8_t *p_digest)
+{
+  const Verify_TrailerTypeDef *p_trailer;
+
+  if (size <= VERIFY_TRAILER_SIZE)
+  {
+    return 0;
+  }
+  p_trailer = (const Verify_TrailerTypeDef *)(start + size - VERIFY_TRAILER_SIZE);
+  if ((p_trailer->magic != VERIFY_TRAILER_MAGIC) || (p_trailer->length != (size - VERIFY_TRAILER_SIZE)))
+  {
+    return 0;
+  }
+  return Verify_Signature(p_trailer->signature, p_digest, SHA256_DIGEST_SIZE);
+}
+
+/**
+  * @brief  Check the application before starting it
+  * @note   The CRC unit must be initialised. The full check takes the
+  *         SHA-256 of the image and an Ed25519 verification; it is journaled
+  *         when it passes.
+  * @param  None
+  * @retval 1 if the application may be started, 0 otherwise
+  */
+uint32_t Verify_Boot(void)
+{
+#ifdef IAP_SIGNED_IMAGES
+  uint32_t start = Part_Address(PART_TYPE_APP);
+  uint32_t size, crc;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+
+  /* Checked before: the image must not have changed since */
+  if (Journal_GetVerified(&size, &crc) && (size != 0) && (size <= Part_Size(PART_TYPE_APP)) &&
+      (Digest_Crc32(start, size) == crc))
+  {
+    return 1;
+  }
+
+  /* The trailer ends the programmed data */
+  size = FLASH_If_GetImageSize(start, Part_Size(PART_TYPE_APP));
+  if (size <= VERIFY_TRAILER_SIZE)
+  {
+    return 0;
+  }
+  Sha256((const uint8_t *)start, size - VERIFY_TRAILER_SIZE, digest);
+  if (!Verify_Image(start, size, digest))
+  {
+    return 0;
+  }
+  Journal_Verified(size, Digest_Crc32(start, size));
+#endif /* IAP_SIGNED_IMAGES */
+  return 1;
+}
+
+/**
+  * @}
+  */
+
+/*******************************END OF FILE************************************/
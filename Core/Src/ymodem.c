@@ -34,26 +34,337 @@
 #include "string.h"
 #include "main.h"
 #include "menu.h"
+#include "prof.h"
+#include "trace.h"
+#include "partition.h"
+#include "journal.h"
+#include "sha256.h"
+#include "verify.h"
+#include "digest.h"
+#include "chacha20.h"
+#include "manifest.h"
+#include "serial_rx.h"
 
 /* Private typedef -----------------------------------------------------------*/
+/**
+  * @brief  Round-trip time estimator (RFC 6298 style, fixed point)
+  */
+typedef struct
+{
+  uint32_t samples;     /* Number of RTT samples taken */
+  uint32_t srtt;        /* Smoothed RTT in ms, scaled by 8 */
+  uint32_t rttvar;      /* RTT variation in ms, scaled by 4 */
+  uint32_t rto;         /* Current retry timeout in ms */
+} RTT_EstimatorTypeDef;
+
+/**
+  * @brief  Copies a slice of the file being transmitted
+  */
+typedef void (*pReadFunction)(uint8_t *p_dst, uint32_t offset, uint32_t length);
+
+/**
+  * @brief  One run of non-erased pages in a sparse upload
+  */
+typedef struct
+{
+  uint32_t flash_offset;  /* Offset of the run from the upload base */
+  uint32_t length;        /* Bytes in the run */
+  uint32_t stream_offset; /* Offset of the run record in the sparse file */
+} SparseRunTypeDef;
+
+/**
+  * @brief  Flash region a received file is routed to
+  */
+typedef struct
+{
+  const char *p_suffix;   /* File name ending that selects the region, NULL for the default */
+  Part_TypeTypeDef type;  /* Partition slot the file is written to */
+} RegionTypeDef;
+
 /* Private define ------------------------------------------------------------*/
 #define CRC16_F       /* activate the CRC16 integrity */
+#define SPARSE_MAX_RUNS         ((USER_FLASH_END_ADDRESS - FLASH_BASE) / FLASH_PAGE_SIZE / 2 + 1)
 
 /* Private macro -------------------------------------------------------------*/
 /* Private variables ---------------------------------------------------------*/
 /* @note ATTENTION - please keep this variable 32bit alligned */
 uint8_t aPacketData[PACKET_1K_SIZE + PACKET_DATA_INDEX + PACKET_TRAILER_SIZE];
+/* Second transmit buffer: the next block is framed here while aPacketData is sent */
+static uint8_t aTxPacketData[PACKET_1K_SIZE + PACKET_DATA_INDEX + PACKET_TRAILER_SIZE];
+/* Tick at which the start byte of the last packet was received */
+static uint32_t PacketStartTick;
+/* Source of the file being transmitted */
+static const uint8_t *pTxBase;
+static uint32_t TxImageSize;
+static SparseRunTypeDef aSparseRuns[SPARSE_MAX_RUNS];
+static uint32_t SparseNbRuns;
+/* Start of a page programmed again after a resume, see RestartAt() */
+static uint32_t aPageCopy[FLASH_PAGE_SIZE / 4];
+static Sha256_CtxTypeDef ImageHash;    /* Of the file being received */
+#ifdef YMODEM_ENCRYPTED
+static Chacha20_CtxTypeDef ImageCipher;
+/* Key of the encrypted downloads, for development only: replace it with the
+ * output of encrypt_image.py keygen and keep the boot image read protected. */
+static const uint8_t aImageKey[CHACHA20_KEY_SIZE] =
+{
+  0x00, 0x01, 0x02, 0x03, 0x04, 0x05, 0x06, 0x07, 0x08, 0x09, 0x0a, 0x0b, 0x0c, 0x0d, 0x0e, 0x0f,
+  0x10, 0x11, 0x12, 0x13, 0x14, 0x15, 0x16, 0x17, 0x18, 0x19, 0x1a, 0x1b, 0x1c, 0x1d, 0x1e, 0x1f
+};
+#ifdef YMODEM_MANIFEST
+static Chacha20_CtxTypeDef CipherMark; /* Before the last block, to decrypt it again */
+#endif /* YMODEM_MANIFEST */
+#endif /* YMODEM_ENCRYPTED */
+/* Destination of each file of a batch session, the last entry catches all */
+static const RegionTypeDef aRegions[] =
+{
+  { ".cal", PART_TYPE_CALIBRATION },
+  { ".res", PART_TYPE_RESOURCE },
+  { NULL,   PART_TYPE_APP }
+};
 
 /* Private function prototypes -----------------------------------------------*/
 static void PrepareIntialPacket(uint8_t *p_data, const uint8_t *p_file_name, uint32_t length);
-static void PreparePacket(uint8_t *p_source, uint8_t *p_packet, uint8_t pkt_nr, uint32_t size_blk);
+static void PreparePacket(pReadFunction read, uint32_t offset, uint8_t *p_packet, uint8_t pkt_nr, uint32_t size_blk);
+static uint16_t AppendTrailer(uint8_t *p_packet, uint32_t pkt_size);
+static void ReadLinear(uint8_t *p_dst, uint32_t offset, uint32_t length);
+static void ReadSparse(uint8_t *p_dst, uint32_t offset, uint32_t length);
+static COM_StatusTypeDef TransmitFile(const uint8_t *p_file_name, uint32_t file_size, pReadFunction read);
 static HAL_StatusTypeDef ReceivePacket(uint8_t *p_data, uint32_t *p_length, uint32_t timeout);
-uint16_t UpdateCRC16(uint16_t crc_in, uint8_t byte);
+static void FlushLine(void);
+static const RegionTypeDef *SelectRegion(const uint8_t *p_file_name);
+static void Rtt_Init(RTT_EstimatorTypeDef *p_rtt, uint32_t initial);
+static void Rtt_Update(RTT_EstimatorTypeDef *p_rtt, uint32_t sample);
+static void Rtt_Backoff(RTT_EstimatorTypeDef *p_rtt);
+#ifdef YMODEM_RESUME_HINT
+static void SendResumeHint(uint32_t offset);
+#endif /* YMODEM_RESUME_HINT */
+#ifdef YMODEM_ENCRYPTED
+static uint32_t OpenCipher(const uint8_t *p_header);
+#endif /* YMODEM_ENCRYPTED */
+#ifdef YMODEM_XMODEM
+static uint32_t WritePadding(uint32_t length);
+#endif /* YMODEM_XMODEM */
+static uint32_t RestartAt(uint32_t region_start, uint32_t address, uint32_t end);
 uint16_t Cal_CRC16(const uint8_t* p_data, uint32_t size);
 uint8_t CalcChecksum(const uint8_t *p_data, uint32_t size);
 
 /* Private functions ---------------------------------------------------------*/
 
+/**
+  * @brief  Pick the flash region of a received file from its name
+  * @note   The name ending is compared without case, see aRegions.
+  * @param  p_file_name: null terminated file name
+  * @retval Region the file is written to
+  */
+static const RegionTypeDef *SelectRegion(const uint8_t *p_file_name)
+{
+  uint32_t i, j, name_length, suffix_length;
+  const uint8_t *p_end;
+
+  name_length = strlen((const char *)p_file_name);
+  for (i = 0; aRegions[i].p_suffix != NULL; i++)
+  {
+    suffix_length = strlen(aRegions[i].p_suffix);
+    if (name_length >= suffix_length)
+    {
+      p_end = &p_file_name[name_length - suffix_length];
+      for (j = 0; (j < suffix_length) && ((p_end[j] | 0x20) == (uint8_t)aRegions[i].p_suffix[j]); j++)
+      {
+      }
+      if (j == suffix_length)
+      {
+        break;
+      }
+    }
+  }
+  return &aRegions[i];
+}
+
+/**
+  * @brief  Drain the remainder of a corrupted frame
+  * @note   Bytes are discarded until the line stays idle for RESYNC_IDLE_CHARS
+  *         character times, so the sender is NAKed as soon as it stops instead
+  *         of after DOWNLOAD_TIMEOUT. The drain is bounded by DOWNLOAD_TIMEOUT
+  *         in case the line never goes quiet.
+  * @param  None
+  * @retval None
+  */
+static void FlushLine(void)
+{
+  uint32_t idle, tickstart;
+  uint8_t dummy;
+
+  /* Idle gap in ms, rounded up, plus one tick for the HAL_GetTick granularity */
+  idle = (RESYNC_IDLE_CHARS * UART_CHAR_BITS * 1000 + UartHandle.Init.BaudRate - 1) / UartHandle.Init.BaudRate + 1;
+
+  tickstart = HAL_GetTick();
+  while ((Serial_Receive(&dummy, 1, idle) == HAL_OK) &&
+         ((HAL_GetTick() - tickstart) < DOWNLOAD_TIMEOUT))
+  {
+  }
+}
+
+/**
+  * @brief  Reset a round-trip time estimator
+  * @param  p_rtt: estimator to reset
+  * @param  initial: timeout to use until the first sample is taken, in ms
+  * @retval None
+  */
+static void Rtt_Init(RTT_EstimatorTypeDef *p_rtt, uint32_t initial)
+{
+  p_rtt->samples = 0;
+  p_rtt->srtt = 0;
+  p_rtt->rttvar = 0;
+  p_rtt->rto = initial;
+}
+
+/**
+  * @brief  Feed a round-trip time sample and derive the retry timeout
+  * @note   srtt += (sample - srtt) / 8, rttvar += (|sample - srtt| - rttvar) / 4
+  *         and rto = srtt + 4 * rttvar, clamped to [RTO_MIN_TIMEOUT, RTO_MAX_TIMEOUT].
+  *         Samples of retransmitted blocks must not be fed (Karn's rule).
+  * @param  p_rtt: estimator to update
+  * @param  sample: measured round-trip time in ms
+  * @retval None
+  */
+static void Rtt_Update(RTT_EstimatorTypeDef *p_rtt, uint32_t sample)
+{
+  int32_t delta;
+  uint32_t rto;
+
+  if (p_rtt->samples == 0)
+  {
+    p_rtt->srtt = sample << 3;
+    p_rtt->rttvar = sample << 1;
+  }
+  else
+  {
+    delta = (int32_t)sample - (int32_t)(p_rtt->srtt >> 3);
+    p_rtt->srtt += delta;
+    if (delta < 0)
+    {
+      delta = -delta;
+    }
+    p_rtt->rttvar = p_rtt->rttvar - (p_rtt->rttvar >> 2) + (uint32_t)delta;
+  }
+  p_rtt->samples++;
+
+  rto = (p_rtt->srtt >> 3) + p_rtt->rttvar;
+  if (rto < RTO_MIN_TIMEOUT)
+  {
+    rto = RTO_MIN_TIMEOUT;
+  }
+  else if (rto > RTO_MAX_TIMEOUT)
+  {
+    rto = RTO_MAX_TIMEOUT;
+  }
+  p_rtt->rto = rto;
+}
+
+/**
+  * @brief  Double the retry timeout after an expiry
+  * @param  p_rtt: estimator to update
+  * @retval None
+  */
+static void Rtt_Backoff(RTT_EstimatorTypeDef *p_rtt)
+{
+  p_rtt->rto <<= 1;
+  if (p_rtt->rto > RTO_MAX_TIMEOUT)
+  {
+    p_rtt->rto = RTO_MAX_TIMEOUT;
+  }
+}
+
+#ifdef YMODEM_RESUME_HINT
+/**
+  * @brief  Tell the sender where an interrupted download resumes
+  * @note   Sent between the header ACK and the 'C' on the priority path, so
+  *         that the bytes keep their order. A sender that understands it
+  *         goes on with 1K blocks numbered from offset / 1024 + 1, any other
+  *         sender ignores it and starts over from block 1.
+  * @param  offset: bytes already programmed, page aligned
+  * @retval None
+  */
+static void SendResumeHint(uint32_t offset)
+{
+  uint32_t i;
+
+  Serial_PutByte(RESUME_HINT);
+  for (i = 0; i < 4; i++)
+  {
+    Serial_PutByte((uint8_t)(offset >> (8 * i)));
+  }
+}
+#endif /* YMODEM_RESUME_HINT */
+
+#ifdef YMODEM_XMODEM
+/**
+  * @brief  Program the 0x1A bytes held back from XMODEM blocks
+  * @param  length: number of bytes
+  * @retval FLASHIF_OK or the error of FLASH_If_StreamWrite()
+  */
+static uint32_t WritePadding(uint32_t length)
+{
+  uint8_t pad[32];
+  uint32_t chunk, status = FLASHIF_OK;
+
+  memset(pad, XMODEM_PAD, sizeof(pad));
+  while ((length > 0) && (status == FLASHIF_OK))
+  {
+    chunk = (length < sizeof(pad)) ? length : sizeof(pad);
+    status = FLASH_If_StreamWrite(pad, chunk);
+    length -= chunk;
+  }
+  return status;
+}
+#endif /* YMODEM_XMODEM */
+
+/**
+  * @brief  Program the file again from the page holding an address
+  * @note   The bytes of the page before the address matched the file: they are
+  *         saved, the page and the rest of the resumed part are erased, and
+  *         the stream restarts with them.
+  * @param  region_start: first address of the region of the file
+  * @param  address: first byte of the block not matching the Flash
+  * @param  end: end of the part kept from the interrupted download
+  * @retval FLASHIF_OK or the error of the erase or of FLASH_If_StreamWrite()
+  */
+static uint32_t RestartAt(uint32_t region_start, uint32_t address, uint32_t end)
+{
+  uint32_t page = address - ((address - region_start) % FLASH_PAGE_SIZE);
+  uint32_t status;
+
+  memcpy(aPageCopy, (const void*)page, address - page);
+  status = FLASH_If_EraseRange(page, end - page);
+  FLASH_If_StreamOpen(page);
+#ifdef YMODEM_MANIFEST
+  /* The page hash has to cover the saved bytes, only compared so far */
+  Manifest_CheckBlock(page - region_start, (const uint8_t*)aPageCopy, address - page);
+#endif /* YMODEM_MANIFEST */
+  if (status == FLASHIF_OK)
+  {
+    status = FLASH_If_StreamWrite((const uint8_t*)aPageCopy, address - page);
+  }
+  return status;
+}
+
+#ifdef YMODEM_ENCRYPTED
+/**
+  * @brief  Start decrypting a file from its header block
+  * @param  p_header: first bytes of the header block, 32-bit aligned
+  * @retval 1 if the header is valid, 0 otherwise
+  */
+static uint32_t OpenCipher(const uint8_t *p_header)
+{
+  if ((*(const uint32_t *)p_header != ENCRYPT_MAGIC) || (p_header[4] != ENCRYPT_VERSION))
+  {
+    return 0;
+  }
+  Chacha20_Init(&ImageCipher, aImageKey, &p_header[8], 0);
+  return 1;
+}
+#endif /* YMODEM_ENCRYPTED */
+
 /**
   * @brief  Receive a packet from sender
   * @param  data
@@ -61,22 +372,29 @@ uint8_t CalcChecksum(const uint8_t *p_data, uint32_t size);
   *     0: end of transmission
   *     2: abort by sender
   *    >0: packet length
-  * @param  timeout
+  * @param  timeout: time allowed for the start of the packet, the body gets
+  *         its wire time on top of it
   * @retval HAL_OK: normally return
   *         HAL_BUSY: abort by user
+  *         HAL_ERROR: corrupted frame, the line has been drained and is idle
+  *         HAL_TIMEOUT: nothing (or an incomplete frame) received in time
   */
 static HAL_StatusTypeDef ReceivePacket(uint8_t *p_data, uint32_t *p_length, uint32_t timeout)
 {
-  uint32_t crc;
+  uint32_t crc, crc_calc;
   uint32_t packet_size = 0;
   HAL_StatusTypeDef status;
   uint8_t char1;
 
   *p_length = 0;
-  status = HAL_UART_Receive(&UartHandle, &char1, 1, timeout);
+  PROF_START(PROF_RX_WAIT);
+  status = Serial_Receive(&char1, 1, timeout);
+  PROF_STOP(PROF_RX_WAIT);
 
   if (status == HAL_OK)
   {
+    PacketStartTick = HAL_GetTick();
+    TRACE_EVENT(TRACE_PKT_START, char1, 0);
     switch (char1)
     {
       case SOH:
@@ -86,10 +404,12 @@ static HAL_StatusTypeDef ReceivePacket(uint8_t *p_data, uint32_t *p_length, uint
         packet_size = PACKET_1K_SIZE;
         break;
       case EOT:
+        PROF_START(PROF_ACK);
         break;
       case CA:
-        if ((HAL_UART_Receive(&UartHandle, &char1, 1, timeout) == HAL_OK) && (char1 == CA))
+        if ((Serial_Receive(&char1, 1, timeout) == HAL_OK) && (char1 == CA))
         {
+          PROF_START(PROF_ACK);
           packet_size = 2;
         }
         else
@@ -102,6 +422,8 @@ static HAL_StatusTypeDef ReceivePacket(uint8_t *p_data, uint32_t *p_length, uint
         status = HAL_BUSY;
         break;
       default:
+        /* Not a frame header: resynchronize on the next one */
+        FlushLine();
         status = HAL_ERROR;
         break;
     }
@@ -109,26 +431,42 @@ static HAL_StatusTypeDef ReceivePacket(uint8_t *p_data, uint32_t *p_length, uint
 
     if (packet_size >= PACKET_SIZE )
     {
-      status = HAL_UART_Receive(&UartHandle, &p_data[PACKET_NUMBER_INDEX], packet_size + PACKET_OVERHEAD_SIZE, timeout);
+      timeout += ((packet_size + PACKET_OVERHEAD_SIZE) * UART_CHAR_BITS * 1000) / UartHandle.Init.BaudRate;
+      PROF_START(PROF_RX_XFER);
+      status = Serial_Receive(&p_data[PACKET_NUMBER_INDEX], packet_size + PACKET_OVERHEAD_SIZE, timeout);
+      PROF_STOP(PROF_RX_XFER);
+      PROF_START(PROF_ACK);
 
       /* Simple packet sanity check */
       if (status == HAL_OK )
       {
         if (p_data[PACKET_NUMBER_INDEX] != ((p_data[PACKET_CNUMBER_INDEX]) ^ NEGATIVE_BYTE))
         {
+          TRACE_EVENT(TRACE_SEQ_FAIL, p_data[PACKET_NUMBER_INDEX], 0);
+          FlushLine();
           packet_size = 0;
           status = HAL_ERROR;
         }
         else
         {
+          TRACE_EVENT(TRACE_HDR_OK, p_data[PACKET_NUMBER_INDEX], packet_size);
           /* Check packet CRC */
           crc = p_data[ packet_size + PACKET_DATA_INDEX ] << 8;
           crc += p_data[ packet_size + PACKET_DATA_INDEX + 1 ];
-          if (HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&p_data[PACKET_DATA_INDEX], packet_size) != crc )
+          PROF_START(PROF_CRC);
+          crc_calc = HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&p_data[PACKET_DATA_INDEX], packet_size);
+          PROF_STOP(PROF_CRC);
+          if (crc_calc != crc )
           {
+            TRACE_EVENT(TRACE_CRC_FAIL, p_data[PACKET_NUMBER_INDEX], 0);
+            FlushLine();
             packet_size = 0;
             status = HAL_ERROR;
           }
+          else
+          {
+            TRACE_EVENT(TRACE_CRC_OK, p_data[PACKET_NUMBER_INDEX], 0);
+          }
         }
       }
       else
@@ -181,17 +519,82 @@ static void PrepareIntialPacket(uint8_t *p_data, const uint8_t *p_file_name, uin
   }
 }
 
+/**
+  * @brief  Read a slice of a file stored as is at pTxBase
+  * @param  p_dst: output buffer
+  * @param  offset: offset in the file
+  * @param  length: number of bytes to copy
+  * @retval None
+  */
+static void ReadLinear(uint8_t *p_dst, uint32_t offset, uint32_t length)
+{
+  memcpy(p_dst, pTxBase + offset, length);
+}
+
+/**
+  * @brief  Read a slice of the sparse form of the image at pTxBase
+  * @note   The file is generated on the fly from aSparseRuns: the file
+  *         header, then for each run its record header and its flash data.
+  * @param  p_dst: output buffer
+  * @param  offset: offset in the sparse file
+  * @param  length: number of bytes to copy
+  * @retval None
+  */
+static void ReadSparse(uint8_t *p_dst, uint32_t offset, uint32_t length)
+{
+  uint32_t header[SPARSE_HEADER_SIZE / 4];
+  uint32_t run = 0, pos, chunk;
+  SparseRunTypeDef *p_run;
+
+  header[0] = SPARSE_MAGIC;
+  header[1] = (uint32_t)pTxBase;
+  header[2] = TxImageSize;
+  while ((length != 0) && (offset < SPARSE_HEADER_SIZE))
+  {
+    *p_dst++ = ((uint8_t *)header)[offset++];
+    length--;
+  }
+
+  while ((length != 0) && (run < SparseNbRuns))
+  {
+    p_run = &aSparseRuns[run];
+    if (offset >= p_run->stream_offset + SPARSE_RECORD_SIZE + p_run->length)
+    {
+      run++;
+      continue;
+    }
+    pos = offset - p_run->stream_offset;
+    if (pos < SPARSE_RECORD_SIZE)
+    {
+      header[0] = p_run->flash_offset;
+      header[1] = p_run->length;
+      *p_dst++ = ((uint8_t *)header)[pos];
+      chunk = 1;
+    }
+    else
+    {
+      pos -= SPARSE_RECORD_SIZE;
+      chunk = p_run->length - pos;
+      chunk = (chunk < length) ? chunk : length;
+      memcpy(p_dst, pTxBase + p_run->flash_offset + pos, chunk);
+      p_dst += chunk;
+    }
+    offset += chunk;
+    length -= chunk;
+  }
+}
+
 /**
   * @brief  Prepare the data packet
-  * @param  p_source: pointer to the data to be sent
+  * @param  read: function providing the file data
+  * @param  offset: offset of the block in the file
   * @param  p_packet: pointer to the output buffer
   * @param  pkt_nr: number of the packet
   * @param  size_blk: length of the block to be sent in bytes
   * @retval None
   */
-static void PreparePacket(uint8_t *p_source, uint8_t *p_packet, uint8_t pkt_nr, uint32_t size_blk)
+static void PreparePacket(pReadFunction read, uint32_t offset, uint8_t *p_packet, uint8_t pkt_nr, uint32_t size_blk)
 {
-  uint8_t *p_record;
   uint32_t i, size, packet_size;
 
   /* Make first three packet */
@@ -207,13 +610,9 @@ static void PreparePacket(uint8_t *p_source, uint8_t *p_packet, uint8_t pkt_nr,
   }
   p_packet[PACKET_NUMBER_INDEX] = pkt_nr;
   p_packet[PACKET_CNUMBER_INDEX] = (~pkt_nr);
-  p_record = p_source;
 
   /* Filename packet has valid data */
-  for (i = PACKET_DATA_INDEX; i < size + PACKET_DATA_INDEX;i++)
-  {
-    p_packet[i] = *p_record++;
-  }
+  read(&p_packet[PACKET_DATA_INDEX], offset, size);
   if ( size  <= packet_size)
   {
     for (i = size + PACKET_DATA_INDEX; i < packet_size + PACKET_DATA_INDEX; i++)
@@ -291,21 +690,53 @@ uint8_t CalcChecksum(const uint8_t *p_data, uint32_t size)
 /* Public functions ---------------------------------------------------------*/
 /**
   * @brief  Receive a file using the ymodem protocol with CRC16.
-  * @param  p_size The size of the file.
+  * @note   A batch of files can be sent in one session, each file is written
+  *         to the region its name selects (see aRegions).
+  * @param  p_size The size of the last file.
+  * @param  p_stats Filled with the session statistics.
   * @retval COM_StatusTypeDef result of reception/programming
   */
 
 uint64_t prgSize = 0;
-COM_StatusTypeDef Ymodem_Receive ( uint64_t *p_size )
+COM_StatusTypeDef Ymodem_Receive ( uint64_t *p_size, COM_StatsTypeDef *p_stats )
 {
   uint32_t i, packet_length, session_done = 0, file_done, errors = 0, session_begin = 0;
-  uint32_t flashdestination, ramsource, filesize;
+  uint32_t response_tick = 0, rtt_armed = 0, write_status;
+  uint32_t session_tick = 0, erase_cycles = 0, program_cycles = 0, stamp, cycles_per_ms;
+  uint32_t sleep_start = 0;
+  RTT_EstimatorTypeDef rtt;
+  uint32_t flashdestination, region_start, region_size, region_end, ramsource, filesize;
+  uint32_t resume_offset = 0, data_length, hash_end = 0, hash_length, signed_image = 0;
+  uint32_t xmodem = 0, packets_received;
+#ifdef YMODEM_XMODEM
+  uint32_t pad_held = 0;
+#endif /* YMODEM_XMODEM */
+#ifdef YMODEM_ENCRYPTED
+  uint32_t header_left = 0;
+#endif /* YMODEM_ENCRYPTED */
+#ifdef YMODEM_MANIFEST
+  uint32_t manifest_pending = 0, page_bad = 0, page_retries = 0, kept;
+  Manifest_StatusTypeDef manifest_status;
+#endif /* YMODEM_MANIFEST */
+  const RegionTypeDef *p_region;
   uint8_t *file_ptr;
-  uint8_t file_size[FILE_SIZE_LENGTH], tmp, packets_received;
+  uint8_t file_size[FILE_SIZE_LENGTH], tmp;
+  HAL_StatusTypeDef status;
   COM_StatusTypeDef result = COM_OK;
 
-  /* Initialize flashdestination variable */
-  flashdestination = APPLICATION_ADDRESS;
+  /* Initialize flashdestination variable, the file header selects the region */
+  flashdestination = Part_Address(PART_TYPE_APP);
+  region_start = flashdestination;
+  region_end = flashdestination;
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+#ifdef IAP_PROFILE
+  Prof_Reset();
+#endif /* IAP_PROFILE */
+#ifdef IAP_TRACE
+  Trace_Reset();
+#endif /* IAP_TRACE */
+  TRACE_EVENT(TRACE_SESSION_BEGIN, 0, 0);
+  memset(p_stats, 0, sizeof(COM_StatsTypeDef));
 
   while ((session_done == 0) && (result == COM_OK))
   {
@@ -313,91 +744,468 @@ COM_StatusTypeDef Ymodem_Receive ( uint64_t *p_size )
     file_done = 0;
     while ((file_done == 0) && (result == COM_OK))
     {
-      switch (ReceivePacket(aPacketData, &packet_length, DOWNLOAD_TIMEOUT))
+      /* Keep polling with 'C' at the fixed rate until the sender shows up,
+         on a slower clock */
+      Main_IdleClock(session_begin == 0);
+      status = ReceivePacket(aPacketData, &packet_length, (session_begin > 0) ? rtt.rto : DOWNLOAD_TIMEOUT);
+      Main_IdleClock(0);
+      switch (status)
       {
         case HAL_OK:
           errors = 0;
+          /* Sender turnaround since our last clean response */
+          if (rtt_armed)
+          {
+            Rtt_Update(&rtt, PacketStartTick - response_tick);
+          }
+          if (session_begin == 0)
+          {
+            session_tick = PacketStartTick;
+            sleep_start = Serial_RxSleepTime();
+          }
           switch (packet_length)
           {
             case 2:
               /* Abort by sender */
               Serial_PutByte(ACK);
+              PROF_STOP(PROF_ACK);
               result = COM_ABORT;
               break;
             case 0:
-              /* End of transmission */
+              /* End of transmission, program what is still buffered */
+#ifdef YMODEM_MANIFEST
+              if (manifest_pending || (Manifest_Verified() < filesize))
+              {
+                /* Pages missing: the file was cut short */
+                Serial_PutByte(CA);
+                Serial_PutByte(CA);
+                result = COM_DATA;
+                break;
+              }
+#endif /* YMODEM_MANIFEST */
+#ifdef YMODEM_XMODEM
+              if (xmodem)
+              {
+                /* The image ends before the padding held back */
+                filesize = flashdestination - region_start - pad_held;
+                *p_size = filesize;
+                p_stats->bytes_programmed = filesize;
+                hash_end = (signed_image && (filesize > VERIFY_TRAILER_SIZE)) ? (filesize - VERIFY_TRAILER_SIZE) : filesize;
+              }
+#endif /* YMODEM_XMODEM */
+              if (FLASH_If_StreamClose() != FLASHIF_OK)
+              {
+                /* End session */
+                Serial_PutByte(CA);
+                Serial_PutByte(CA);
+                result = COM_DATA;
+                break;
+              }
+#ifdef YMODEM_XMODEM
+              if (xmodem)
+              {
+                /* Hashed from the Flash, the end was not known before */
+                PROF_START(PROF_HASH);
+                Sha256_Update(&ImageHash, (const uint8_t*)region_start, hash_end);
+                PROF_STOP(PROF_HASH);
+              }
+#endif /* YMODEM_XMODEM */
+              Sha256_Final(&ImageHash, aFileDigest);
+              if (signed_image && !Verify_Image(region_start, filesize, aFileDigest))
+              {
+                /* Not started at boot either: do not resume it, start over */
+                Journal_Invalidate();
+                Serial_PutByte(CA);
+                Serial_PutByte(CA);
+                result = COM_SIGNATURE;
+                break;
+              }
               Serial_PutByte(ACK);
+              PROF_STOP(PROF_ACK);
+              Journal_Close();
+              if (signed_image)
+              {
+                /* The first boot needs no signature check */
+                Journal_Verified(filesize, Digest_Crc32(region_start, filesize));
+              }
               file_done = 1;
+              /* XMODEM sends one file, no empty header ends it */
+              session_done = xmodem;
               break;
             default:
               /* Normal packet */
-              if (aPacketData[PACKET_NUMBER_INDEX] != packets_received)//PACKET_NUMBER_INDEX = 2
+#ifdef YMODEM_RESUME_HINT
+              /* A sender following the resume hint skips the blocks already programmed */
+              if ((packets_received == 1) && (resume_offset > 0) && (flashdestination == region_start) &&
+                  (aPacketData[PACKET_NUMBER_INDEX] == (uint8_t)(resume_offset / PACKET_1K_SIZE + 1)))
               {
-                Serial_PutByte(NAK);
+                packets_received = aPacketData[PACKET_NUMBER_INDEX];
+                flashdestination += resume_offset;
+                Sha256_Update(&ImageHash, (const uint8_t*)region_start, (resume_offset < hash_end) ? resume_offset : hash_end);
+              }
+#endif /* YMODEM_RESUME_HINT */
+#ifdef YMODEM_XMODEM
+              /* An XMODEM sender has no header: its session starts with block 1 */
+              if ((session_begin == 0) && (aPacketData[PACKET_NUMBER_INDEX] == 1))
+              {
+                xmodem = 1;
+              }
+#endif /* YMODEM_XMODEM */
+              /* Counted past 255: block 256 wraps to number 0, it is no header */
+              if ((aPacketData[PACKET_NUMBER_INDEX] != (uint8_t)packets_received) && !(xmodem && (packets_received == 0)))//PACKET_NUMBER_INDEX = 2
+              {
+                if ((packets_received > 0) && (aPacketData[PACKET_NUMBER_INDEX] == (uint8_t)(packets_received - 1)))
+                {
+                  /* Our ACK was lost and the sender repeated the last block */
+                  Serial_PutByte(ACK);
+                }
+                else
+                {
+                  Serial_PutByte(NAK);
+                }
+                PROF_STOP(PROF_ACK);
+                p_stats->retransmits++;
               }
               else
               {
                 if (packets_received == 0)
                 {
-                  /* File name packet */
-                  if (aPacketData[PACKET_DATA_INDEX] != 0)
+                  /* File name packet, or block 1 of XMODEM */
+                  if (xmodem || (aPacketData[PACKET_DATA_INDEX] != 0))
                   {
-                    /* File name extraction */
-                    i = 0;
-                    file_ptr = aPacketData + PACKET_DATA_INDEX;
-                    while ( (*file_ptr != 0) && (i < FILE_NAME_LENGTH))
+                    if (xmodem)
                     {
-                      aFileName[i++] = *file_ptr++;
+                      /* Data, neither name nor size: the application slot, the size is known at EOT */
+                      aFileName[0] = '\0';
+                      filesize = 0;
                     }
+                    else
+                    {
+                      /* File name extraction */
+                      i = 0;
+                      file_ptr = aPacketData + PACKET_DATA_INDEX;
+                      while ( (*file_ptr != 0) && (i < FILE_NAME_LENGTH))
+                      {
+                        aFileName[i++] = *file_ptr++;
+                      }
 
-                    /* File size extraction */
-                    aFileName[i++] = '\0';
-                    i = 0;
-                    file_ptr ++;
-                    while ( (*file_ptr != ' ') && (i < FILE_SIZE_LENGTH))
+                      /* File size extraction */
+                      aFileName[i++] = '\0';
+                      i = 0;
+                      file_ptr ++;
+                      while ( (*file_ptr != ' ') && (i < FILE_SIZE_LENGTH))
+                      {
+                        file_size[i++] = *file_ptr++;
+                      }
+                      file_size[i++] = '\0';
+                      Str2Int(file_size, &filesize);
+                    }
+#ifdef YMODEM_ENCRYPTED
+                    /* The header block is not programmed, the size must be known */
+                    if (filesize <= ENCRYPT_HEADER_SIZE)
                     {
-                      file_size[i++] = *file_ptr++;
+                      /* End session */
+                      Serial_PutByte(CA);
+                      Serial_PutByte(CA);
+                      result = COM_DATA;
+                      break;
                     }
-                    file_size[i++] = '\0';
-                    Str2Int(file_size, &filesize);
+                    filesize -= ENCRYPT_HEADER_SIZE;
+                    header_left = ENCRYPT_HEADER_SIZE;
+#endif /* YMODEM_ENCRYPTED */
+
+                    /* Each file of the batch goes to the region its name selects */
+                    p_region = SelectRegion(aFileName);
+                    flashdestination = Part_Address(p_region->type);
+                    region_start = flashdestination;
+                    region_size = Part_Size(p_region->type);
+                    region_end = flashdestination + region_size;
 
                     /* Test the size of the image to be sent */
-                    /* Image size is greater than Flash size */
-                    prgSize = (*p_size);
-                    if ((*p_size) > (USER_FLASH_SIZE + 1))
+                    /* Image size is greater than the region size, or the layout has no such region */
+                    prgSize = filesize;
+                    if ((region_size == 0) || (filesize > region_size))
                     {
                       /* End session */
-                      tmp = CA;
-                      HAL_UART_Transmit(&UartHandle, &tmp, 1, NAK_TIMEOUT);
-                      HAL_UART_Transmit(&UartHandle, &tmp, 1, NAK_TIMEOUT);
+                      Serial_PutByte(CA);
+                      Serial_PutByte(CA);
                       result = COM_LIMIT;
+                      break;
+                    }
+                    /* The same image cut short earlier resumes after its last journaled page */
+                    resume_offset = Journal_Open(p_region->type, filesize,
+                                                 (uint16_t)HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&aPacketData[PACKET_DATA_INDEX], packet_length));
+                    if (xmodem || (resume_offset > region_size))
+                    {
+                      /* XMODEM starts over: the padding held back is not journaled */
+                      resume_offset = 0;
+                    }
+                    /* erase the rest of the region, then check it is blank */
+                    TRACE_EVENT(TRACE_ERASE_BEGIN, 0, 0);
+                    PROF_START(PROF_ERASE);
+                    stamp = Prof_Now();
+                    tmp = FLASH_If_EraseRange(region_start + resume_offset, region_size - resume_offset);
+                    if ((tmp == FLASHIF_OK) && !FLASH_If_IsErased(region_start + resume_offset, region_size - resume_offset))
+                    {
+                      tmp = FLASHIF_ERASEKO;
+                    }
+                    erase_cycles += Prof_Now() - stamp;
+                    PROF_STOP(PROF_ERASE);
+                    TRACE_EVENT(TRACE_ERASE_END, tmp, 0);
+                    if (tmp != FLASHIF_OK)
+                    {
+                      /* End session */
+                      Serial_PutByte(CA);
+                      Serial_PutByte(CA);
+                      result = COM_DATA;
+                      break;
                     }
-                    /* erase user application area */
-                    FLASH_If_Erase(APPLICATION_ADDRESS);
                     *p_size = filesize;
+                    FLASH_If_StreamOpen(region_start + resume_offset);
+                    Sha256_Init(&ImageHash);
+                    /* The signature trailer of an application is not hashed */
+                    hash_end = (filesize != 0) ? filesize : 0xFFFFFFFFU;
+#ifdef IAP_SIGNED_IMAGES
+                    signed_image = (p_region->type == PART_TYPE_APP);
+                    if (signed_image)
+                    {
+                      hash_end = (filesize > VERIFY_TRAILER_SIZE) ? (filesize - VERIFY_TRAILER_SIZE) : 0;
+                    }
+#endif /* IAP_SIGNED_IMAGES */
+#ifdef YMODEM_MANIFEST
+                    Manifest_Start();
+                    manifest_pending = 1;
+                    page_retries = 0;
+#endif /* YMODEM_MANIFEST */
+#ifdef YMODEM_XMODEM
+                    if (xmodem)
+                    {
+                      /* Hashed at EOT */
+                      hash_end = 0;
+                      pad_held = 0;
+                    }
+#endif /* YMODEM_XMODEM */
 
-                    Serial_PutByte(ACK);
-                    Serial_PutByte(CRC16);
+                    /* Block 1 of XMODEM is asked again, as data this time */
+                    Serial_PutByte(xmodem ? NAK : ACK);
+                    PROF_STOP(PROF_ACK);
+#if defined(YMODEM_RESUME_HINT) && !defined(YMODEM_ENCRYPTED) && !defined(YMODEM_MANIFEST)
+                    if (resume_offset > 0)
+                    {
+                      SendResumeHint(resume_offset);
+                    }
+#endif /* YMODEM_RESUME_HINT && !YMODEM_ENCRYPTED && !YMODEM_MANIFEST */
+                    if (!xmodem)
+                    {
+                      Serial_PutByte(CRC16);
+                    }
                   }
                   /* File header packet is empty, end session */
                   else
                   {
                     Serial_PutByte(ACK);
+                    PROF_STOP(PROF_ACK);
                     file_done = 1;
                     session_done = 1;
                     break;
                   }
                 }
+#ifdef YMODEM_ENCRYPTED
+                else if (header_left > 0)
+                {
+                  /* Header block: its first packet starts the key stream */
+                  if ((header_left == ENCRYPT_HEADER_SIZE) && !OpenCipher(&aPacketData[PACKET_DATA_INDEX]))
+                  {
+                    /* End session */
+                    Serial_PutByte(CA);
+                    Serial_PutByte(CA);
+                    result = COM_DATA;
+                    break;
+                  }
+                  header_left -= (packet_length < header_left) ? packet_length : header_left;
+                  Serial_PutByte(ACK);
+                  PROF_STOP(PROF_ACK);
+                }
+#endif /* YMODEM_ENCRYPTED */
+#ifdef YMODEM_MANIFEST
+                else if (manifest_pending)
+                {
+#ifdef YMODEM_ENCRYPTED
+                  Chacha20_Xor(&ImageCipher, &aPacketData[PACKET_DATA_INDEX], packet_length);
+#endif /* YMODEM_ENCRYPTED */
+                  manifest_status = Manifest_Receive(&aPacketData[PACKET_DATA_INDEX], packet_length);
+                  if (manifest_status == MANIFEST_DONE)
+                  {
+                    /* The image follows the manifest */
+                    manifest_pending = 0;
+                    if ((filesize <= Manifest_Size()) || ((filesize - Manifest_Size()) != Manifest_ImageLength()))
+                    {
+                      manifest_status = MANIFEST_FORMAT;
+                    }
+                    else
+                    {
+                      filesize -= Manifest_Size();
+                      *p_size = filesize;
+                      prgSize = filesize;
+                      hash_end = (signed_image && (filesize > VERIFY_TRAILER_SIZE)) ? (filesize - VERIFY_TRAILER_SIZE) : filesize;
+                    }
+                  }
+                  if ((manifest_status == MANIFEST_DONE) && (resume_offset > 0))
+                  {
+                    /* Only the kept pages that match their leaves are trusted */
+                    kept = Manifest_CheckFlash(region_start, resume_offset);
+                    if (kept < resume_offset)
+                    {
+                      if (FLASH_If_EraseRange(region_start + kept, resume_offset - kept) != FLASHIF_OK)
+                      {
+                        manifest_status = MANIFEST_FORMAT;
+                      }
+                      resume_offset = kept;
+                      Journal_Rewind(resume_offset);
+                      FLASH_If_StreamOpen(region_start + resume_offset);
+                    }
+                  }
+                  if ((manifest_status != MANIFEST_MORE) && (manifest_status != MANIFEST_DONE))
+                  {
+                    /* End session */
+                    Serial_PutByte(CA);
+                    Serial_PutByte(CA);
+                    result = (manifest_status == MANIFEST_SIGNATURE) ? COM_SIGNATURE : COM_DATA;
+                    break;
+                  }
+                  Serial_PutByte(ACK);
+                  PROF_STOP(PROF_ACK);
+                }
+#endif /* YMODEM_MANIFEST */
                 else /* Data packet */
                 {
                   ramsource = (uint32_t) & aPacketData[PACKET_DATA_INDEX];
+                  /* The padding of the last block is not written when the header gives the size */
+                  data_length = packet_length;
+                  if (filesize != 0)
+                  {
+                    data_length = (filesize > (flashdestination - region_start)) ? (filesize - (flashdestination - region_start)) : 0;
+                    if (data_length > packet_length)
+                    {
+                      data_length = packet_length;
+                    }
+                  }
+#ifdef YMODEM_XMODEM
+                  else if (xmodem)
+                  {
+                    /* 0x1A at the end may be the padding of the last block */
+                    while ((data_length > 0) && (aPacketData[PACKET_DATA_INDEX + data_length - 1] == XMODEM_PAD))
+                    {
+                      data_length--;
+                    }
+                  }
+#endif /* YMODEM_XMODEM */
+                  if (p_stats->blocks == 0)
+                  {
+                    p_stats->first_block_time = PacketStartTick - session_tick;
+                  }
+#ifdef YMODEM_ENCRYPTED
+                  /* In place, each block once: repeated blocks are not processed */
+#ifdef YMODEM_MANIFEST
+                  CipherMark = ImageCipher;
+#endif /* YMODEM_MANIFEST */
+                  PROF_START(PROF_DECRYPT);
+                  Chacha20_Xor(&ImageCipher, (uint8_t*)ramsource, data_length);
+                  PROF_STOP(PROF_DECRYPT);
+#endif /* YMODEM_ENCRYPTED */
 
-                  /* Write received data in Flash */
-                  if (FLASH_If_Write(flashdestination, (uint32_t*) ramsource, packet_length/4) == FLASHIF_OK)                   
+                  /* Write received data in Flash, within the region of the file */
+                  TRACE_EVENT(TRACE_PROG_BEGIN, packets_received, packet_length);
+                  PROF_START(PROF_WRITE);
+                  stamp = Prof_Now();
+                  if ((flashdestination + data_length) > region_end)
+                  {
+                    write_status = FLASHIF_WRITING_ERROR;
+                  }
+                  else if ((flashdestination < (region_start + resume_offset)) &&
+                           (memcmp((const void*)flashdestination, (const void*)ramsource, data_length) == 0))
                   {
+                    /* Already programmed by the interrupted download: compare only */
+                    write_status = FLASHIF_OK;
+                  }
+                  else
+                  {
+                    write_status = FLASHIF_OK;
+                    if (flashdestination < (region_start + resume_offset))
+                    {
+                      /* Not the journaled image after all, same name, size and
+                         header CRC: program it from the page of this block on */
+                      write_status = RestartAt(region_start, flashdestination, region_start + resume_offset);
+                      resume_offset = flashdestination - region_start;
+                      resume_offset -= resume_offset % FLASH_PAGE_SIZE;
+                      Journal_Rewind(resume_offset);
+                    }
+                    if (write_status == FLASHIF_OK)
+                    {
+                      /* Rows are programmed as they fill up, whatever the block size */
+#ifdef YMODEM_MANIFEST
+                      page_bad = !Manifest_CheckBlock(flashdestination - region_start, (const uint8_t*)ramsource, data_length);
+                      write_status = page_bad ? FLASHIF_WRITINGCTRL_ERROR : FLASH_If_StreamWrite((const uint8_t*) ramsource, data_length);
+#elif defined(YMODEM_XMODEM)
+                      /* Data follows: the 0x1A held back were not padding */
+                      write_status = ((data_length > 0) && (pad_held > 0)) ? WritePadding(pad_held) : FLASHIF_OK;
+                      if (write_status == FLASHIF_OK)
+                      {
+                        write_status = FLASH_If_StreamWrite((const uint8_t*) ramsource, data_length);
+                      }
+#else
+                      write_status = FLASH_If_StreamWrite((const uint8_t*) ramsource, data_length);
+#endif /* YMODEM_MANIFEST */
+                      if (write_status == FLASHIF_OK)
+                      {
+                        p_stats->bytes_programmed += data_length;
+                        if ((data_length == packet_length) &&
+                            (((flashdestination + packet_length - region_start) % FLASH_PAGE_SIZE) == 0))
+                        {
+                          /* A page boundary is a row boundary: the page is programmed and verified */
+                          Journal_Progress(flashdestination + packet_length - region_start);
+                        }
+                      }
+                    }
+                  }
+                  program_cycles += Prof_Now() - stamp;
+                  PROF_STOP(PROF_WRITE);
+                  TRACE_EVENT(TRACE_PROG_END, write_status, 0);
+                  if (write_status == FLASHIF_OK)
+                  {
+                    /* Hashed while the sender waits for the ACK anyway, the
+                       digest is ready at EOT */
+                    hash_length = flashdestination - region_start;
+                    hash_length = (hash_end > hash_length) ? (hash_end - hash_length) : 0;
+                    PROF_START(PROF_HASH);
+                    Sha256_Update(&ImageHash, (const uint8_t*)ramsource, (data_length < hash_length) ? data_length : hash_length);
+                    PROF_STOP(PROF_HASH);
                     flashdestination += packet_length;
+                    p_stats->blocks++;
+#ifdef YMODEM_XMODEM
+                    pad_held = ((data_length > 0) ? 0 : pad_held) + packet_length - data_length;
+#endif /* YMODEM_XMODEM */
+#ifdef YMODEM_MANIFEST
+                    page_retries = 0;
+#endif /* YMODEM_MANIFEST */
                     Serial_PutByte(ACK);
+                    PROF_STOP(PROF_ACK);
                   }
+#ifdef YMODEM_MANIFEST
+                  else if (page_bad && (page_retries < MANIFEST_PAGE_RETRIES))
+                  {
+                    /* The page does not match its leaf: ask again for the
+                       block completing it, nothing of it is programmed yet */
+#ifdef YMODEM_ENCRYPTED
+                    ImageCipher = CipherMark;
+#endif /* YMODEM_ENCRYPTED */
+                    page_retries++;
+                    p_stats->retransmits++;
+                    Serial_PutByte(NAK);
+                    PROF_STOP(PROF_ACK);
+                    break;
+                  }
+#endif /* YMODEM_MANIFEST */
                   else /* An error occurred while writing to Flash memory */
                   {
                     /* End session */
@@ -411,6 +1219,8 @@ COM_StatusTypeDef Ymodem_Receive ( uint64_t *p_size )
               }
               break;
           }
+          response_tick = HAL_GetTick();
+          rtt_armed = 1;
           break;
         case HAL_BUSY: /* Abort actually */
           Serial_PutByte(CA);
@@ -418,27 +1228,90 @@ COM_StatusTypeDef Ymodem_Receive ( uint64_t *p_size )
           result = COM_ABORT;
           break;
         default:
+          rtt_armed = 0;
+          if (status == HAL_TIMEOUT)
+          {
+            TRACE_EVENT(TRACE_TIMEOUT, 0, rtt.rto);
+          }
           if (session_begin > 0)
           {
             errors ++;
+            if (status == HAL_TIMEOUT)
+            {
+              Rtt_Backoff(&rtt);
+              p_stats->timeouts++;
+            }
+            else
+            {
+              p_stats->crc_errors++;
+            }
           }
           if (errors > MAX_ERRORS)
           {
             /* Abort communication */
             Serial_PutByte(CA);
             Serial_PutByte(CA);
+            result = COM_ERROR;
+          }
+          else if ((status == HAL_ERROR) && (session_begin > 0))
+          {
+            Serial_PutByte(NAK); /* Line is idle again, ask for a retransmission */
+            p_stats->retransmits++;
           }
           else
           {
             Serial_PutByte(CRC16); /* Ask for a packet */
+            if (session_begin > 0)
+            {
+              p_stats->retransmits++;
+            }
           }
           break;
       }
     }
   }
+  TRACE_EVENT(TRACE_SESSION_END, result, 0);
+
+  if (session_begin > 0)
+  {
+    cycles_per_ms = SystemCoreClock / 1000U;
+    p_stats->total_time = HAL_GetTick() - session_tick;
+    p_stats->erase_time = erase_cycles / cycles_per_ms;
+    p_stats->program_time = program_cycles / cycles_per_ms;
+    p_stats->sleep_time = (Serial_RxSleepTime() - sleep_start) / 1000U;
+    if (p_stats->total_time != 0)
+    {
+      p_stats->throughput = (uint32_t)(((uint64_t)p_stats->bytes_programmed * 1000U) / p_stats->total_time);
+      p_stats->sleep_ratio = (p_stats->sleep_time * 1000U) / p_stats->total_time;
+    }
+  }
   return result;
 }
 
+/**
+  * @brief  Append the CRC or checksum of a prepared packet
+  * @param  p_packet: packet prepared by PreparePacket() or PrepareIntialPacket()
+  * @param  pkt_size: size of the packet data in bytes
+  * @retval Length of the frame to send, from PACKET_START_INDEX
+  */
+static uint16_t AppendTrailer(uint8_t *p_packet, uint32_t pkt_size)
+{
+  uint8_t *p_trailer = &p_packet[PACKET_DATA_INDEX + pkt_size];
+#ifdef CRC16_F
+  uint32_t temp_crc;
+
+  PROF_START(PROF_CRC);
+  temp_crc = HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&p_packet[PACKET_DATA_INDEX], pkt_size);
+  PROF_STOP(PROF_CRC);
+  p_trailer[0] = (uint8_t)(temp_crc >> 8);
+  p_trailer[1] = (uint8_t)(temp_crc & 0xFF);
+  return (uint16_t)(PACKET_HEADER_SIZE + pkt_size + 2);
+#else /* CRC16_F */
+  p_trailer[0] = CalcChecksum(&p_packet[PACKET_DATA_INDEX], pkt_size);
+  return (uint16_t)(PACKET_HEADER_SIZE + pkt_size + 1);
+#endif /* CRC16_F */
+}
+
 /**
   * @brief  Transmit a file using the ymodem protocol
   * @param  p_buf: Address of the first byte
@@ -447,51 +1320,108 @@ COM_StatusTypeDef Ymodem_Receive ( uint64_t *p_size )
   * @retval COM_StatusTypeDef result of the communication
   */
 COM_StatusTypeDef Ymodem_Transmit (uint8_t *p_buf, const uint8_t *p_file_name, uint64_t file_size)
+{
+  pTxBase = p_buf;
+  return TransmitFile(p_file_name, file_size, ReadLinear);
+}
+
+/**
+  * @brief  Transmit a flash image in sparse form using the ymodem protocol
+  * @note   Pages that are fully erased are left out, see SPARSE_MAGIC for the
+  *         file layout.
+  * @param  p_buf: Address of the first byte, page aligned
+  * @param  p_file_name: Name of the file sent
+  * @param  image_size: Size of the image, see FLASH_If_GetImageSize()
+  * @retval COM_StatusTypeDef result of the communication
+  */
+COM_StatusTypeDef Ymodem_TransmitSparse (uint8_t *p_buf, const uint8_t *p_file_name, uint32_t image_size)
+{
+  uint32_t offset, length, stream_size = SPARSE_HEADER_SIZE;
+  SparseRunTypeDef *p_run = NULL;
+
+  pTxBase = p_buf;
+  TxImageSize = image_size;
+  SparseNbRuns = 0;
+
+  for (offset = 0; offset < image_size; offset += FLASH_PAGE_SIZE)
+  {
+    length = image_size - offset;
+    length = (length < FLASH_PAGE_SIZE) ? length : FLASH_PAGE_SIZE;
+    if (FLASH_If_IsErased((uint32_t)p_buf + offset, (length + 3) & ~3U))
+    {
+      p_run = NULL;
+    }
+    else if (p_run != NULL)
+    {
+      /* Extend the current run */
+      p_run->length += length;
+      stream_size += length;
+    }
+    else
+    {
+      p_run = &aSparseRuns[SparseNbRuns++];
+      p_run->flash_offset = offset;
+      p_run->length = length;
+      p_run->stream_offset = stream_size;
+      stream_size += SPARSE_RECORD_SIZE + length;
+    }
+  }
+
+  return TransmitFile(p_file_name, stream_size, ReadSparse);
+}
+
+/**
+  * @brief  Transmit a file using the ymodem protocol
+  * @param  p_file_name: Name of the file sent
+  * @param  file_size: Size of the transmission
+  * @param  read: function providing the file data
+  * @retval COM_StatusTypeDef result of the communication
+  */
+static COM_StatusTypeDef TransmitFile(const uint8_t *p_file_name, uint32_t file_size, pReadFunction read)
 {
   uint32_t errors = 0, ack_recpt = 0, size = 0, pkt_size;
-  uint8_t *p_buf_int;
+  uint32_t offset, next_ready;
   COM_StatusTypeDef result = COM_OK;
   uint32_t blk_number = 1;
+  uint32_t sent_tick;
+  uint16_t frame_length, next_length = 0;
   uint8_t a_rx_ctrl[2];
   uint8_t i;
-#ifdef CRC16_F    
-  uint32_t temp_crc;
-#else /* CRC16_F */   
-  uint8_t temp_chksum;
-#endif /* CRC16_F */  
+  uint8_t *p_packet, *p_next;
+  HAL_StatusTypeDef rx_status;
+  RTT_EstimatorTypeDef rtt;
+
+  /* The receiver may erase its whole target area before it ACKs the header */
+  Rtt_Init(&rtt, RTO_MAX_TIMEOUT);
+#ifdef IAP_PROFILE
+  Prof_Reset();
+#endif /* IAP_PROFILE */
 
   /* Prepare first block - header */
   PrepareIntialPacket(aPacketData, p_file_name, file_size);
+  frame_length = AppendTrailer(aPacketData, PACKET_SIZE);
 
   while (( !ack_recpt ) && ( result == COM_OK ))
   {
     /* Send Packet */
-    HAL_UART_Transmit(&UartHandle, &aPacketData[PACKET_START_INDEX], PACKET_SIZE + PACKET_HEADER_SIZE, NAK_TIMEOUT);
-
-    /* Send CRC or Check Sum based on CRC16_F */
-#ifdef CRC16_F    
-    temp_crc = HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&aPacketData[PACKET_DATA_INDEX], PACKET_SIZE);
-    Serial_PutByte(temp_crc >> 8);
-    Serial_PutByte(temp_crc & 0xFF);
-#else /* CRC16_F */   
-    temp_chksum = CalcChecksum (&aPacketData[PACKET_DATA_INDEX], PACKET_SIZE);
-    Serial_PutByte(temp_chksum);
-#endif /* CRC16_F */
+    Serial_PutFrame(&aPacketData[PACKET_START_INDEX], frame_length);
+    Serial_WaitTxDone();
 
     /* Wait for Ack and 'C' */
-    if (HAL_UART_Receive(&UartHandle, &a_rx_ctrl[0], 1, NAK_TIMEOUT) == HAL_OK)
+    if (Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto) == HAL_OK)
     {
       if (a_rx_ctrl[0] == ACK)
       {
         ack_recpt = 1;
+        /* Consume the 'C' that asks for the first data block */
+        Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto);
       }
       else if (a_rx_ctrl[0] == CA)
       {
-        if ((HAL_UART_Receive(&UartHandle, &a_rx_ctrl[0], 1, NAK_TIMEOUT) == HAL_OK) && (a_rx_ctrl[0] == CA))
+        if ((Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto) == HAL_OK) && (a_rx_ctrl[0] == CA))
         {
           HAL_Delay( 2 );
-          __HAL_UART_FLUSH_DRREGISTER(&UartHandle);
-          __HAL_UART_CLEAR_IT(&UartHandle, UART_CLEAR_OREF);
+          Serial_RxFlush();
           result = COM_ABORT;
         }
       }
@@ -506,50 +1436,63 @@ COM_StatusTypeDef Ymodem_Transmit (uint8_t *p_buf, const uint8_t *p_file_name, u
     }
   }
 
-  p_buf_int = p_buf;
+  /* Data blocks are timed from scratch, the header ACK included the erase */
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  offset = 0;
   size = file_size;
 
+  /* Blocks are sent by DMA from one buffer while the next block is framed
+   * in the other one, the buffers swap on each ACK */
+  p_packet = aPacketData;
+  p_next = aTxPacketData;
+  pkt_size = (size >= PACKET_1K_SIZE) ? PACKET_1K_SIZE : PACKET_SIZE;
+  if (size)
+  {
+    PreparePacket(read, offset, p_packet, blk_number, size);
+    frame_length = AppendTrailer(p_packet, pkt_size);
+  }
+
   /* Here 1024 bytes length is used to send the packets */
   while ((size) && (result == COM_OK ))
   {
-    /* Prepare next packet */
-    PreparePacket(p_buf_int, aPacketData, blk_number, size);
+    pkt_size = (size >= PACKET_1K_SIZE) ? PACKET_1K_SIZE : PACKET_SIZE;
     ack_recpt = 0;
     a_rx_ctrl[0] = 0;
     errors = 0;
+    next_ready = 0;
 
     /* Resend packet if NAK for few times else end of communication */
     while (( !ack_recpt ) && ( result == COM_OK ))
     {
-      /* Send next packet */
-      if (size >= PACKET_1K_SIZE)
-      {
-        pkt_size = PACKET_1K_SIZE;
-      }
-      else
+      /* Send packet */
+      PROF_START(PROF_TX);
+      Serial_PutFrame(&p_packet[PACKET_START_INDEX], frame_length);
+
+      /* Frame the next block while this one is on the wire */
+      if ((!next_ready) && (size > pkt_size))
       {
-        pkt_size = PACKET_SIZE;
+        PreparePacket(read, offset + pkt_size, p_next, blk_number + 1, size - pkt_size);
+        next_length = AppendTrailer(p_next, ((size - pkt_size) >= PACKET_1K_SIZE) ? PACKET_1K_SIZE : PACKET_SIZE);
+        next_ready = 1;
       }
 
-      HAL_UART_Transmit(&UartHandle, &aPacketData[PACKET_START_INDEX], pkt_size + PACKET_HEADER_SIZE, NAK_TIMEOUT);
-      
-      /* Send CRC or Check Sum based on CRC16_F */
-#ifdef CRC16_F    
-      temp_crc = HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&aPacketData[PACKET_DATA_INDEX], pkt_size);
-      Serial_PutByte(temp_crc >> 8);
-      Serial_PutByte(temp_crc & 0xFF);
-#else /* CRC16_F */   
-      temp_chksum = CalcChecksum (&aPacketData[PACKET_DATA_INDEX], pkt_size);
-      Serial_PutByte(temp_chksum);
-#endif /* CRC16_F */
-      
+      Serial_WaitTxDone();
+      PROF_STOP(PROF_TX);
+      sent_tick = HAL_GetTick();
+
       /* Wait for Ack */
-      if ((HAL_UART_Receive(&UartHandle, &a_rx_ctrl[0], 1, NAK_TIMEOUT) == HAL_OK) && (a_rx_ctrl[0] == ACK))
+      rx_status = Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto);
+      if ((rx_status == HAL_OK) && (a_rx_ctrl[0] == ACK))
       {
         ack_recpt = 1;
+        /* Only first transmissions give an unambiguous sample */
+        if (errors == 0)
+        {
+          Rtt_Update(&rtt, HAL_GetTick() - sent_tick);
+        }
         if (size > pkt_size)
         {
-          p_buf_int += pkt_size;
+          offset += pkt_size;
           size -= pkt_size;
           if (blk_number == (USER_FLASH_SIZE / PACKET_1K_SIZE))
           {
@@ -559,15 +1502,24 @@ COM_StatusTypeDef Ymodem_Transmit (uint8_t *p_buf, const uint8_t *p_file_name, u
           {
             blk_number++;
           }
+
+          /* The next block is already framed */
+          p_next = p_packet;
+          p_packet = (p_packet == aPacketData) ? aTxPacketData : aPacketData;
+          frame_length = next_length;
         }
         else
         {
-          p_buf_int += pkt_size;
+          offset += pkt_size;
           size = 0;
         }
       }
       else
       {
+        if (rx_status == HAL_TIMEOUT)
+        {
+          Rtt_Backoff(&rtt);
+        }
         errors++;
       }
 
@@ -588,7 +1540,7 @@ COM_StatusTypeDef Ymodem_Transmit (uint8_t *p_buf, const uint8_t *p_file_name, u
     Serial_PutByte(EOT);
 
     /* Wait for Ack */
-    if (HAL_UART_Receive(&UartHandle, &a_rx_ctrl[0], 1, NAK_TIMEOUT) == HAL_OK)
+    if (Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto) == HAL_OK)
     {
       if (a_rx_ctrl[0] == ACK)
       {
@@ -596,11 +1548,10 @@ COM_StatusTypeDef Ymodem_Transmit (uint8_t *p_buf, const uint8_t *p_file_name, u
       }
       else if (a_rx_ctrl[0] == CA)
       {
-        if ((HAL_UART_Receive(&UartHandle, &a_rx_ctrl[0], 1, NAK_TIMEOUT) == HAL_OK) && (a_rx_ctrl[0] == CA))
+        if ((Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto) == HAL_OK) && (a_rx_ctrl[0] == CA))
         {
           HAL_Delay( 2 );
-          __HAL_UART_FLUSH_DRREGISTER(&UartHandle);
-          __HAL_UART_CLEAR_IT(&UartHandle, UART_CLEAR_OREF);
+          Serial_RxFlush();
           result = COM_ABORT;
         }
       }
@@ -629,26 +1580,17 @@ COM_StatusTypeDef Ymodem_Transmit (uint8_t *p_buf, const uint8_t *p_file_name, u
     }
 
     /* Send Packet */
-    HAL_UART_Transmit(&UartHandle, &aPacketData[PACKET_START_INDEX], PACKET_SIZE + PACKET_HEADER_SIZE, NAK_TIMEOUT);
-
-    /* Send CRC or Check Sum based on CRC16_F */
-#ifdef CRC16_F    
-    temp_crc = HAL_CRC_Calculate(&CrcHandle, (uint32_t*)&aPacketData[PACKET_DATA_INDEX], PACKET_SIZE);
-    Serial_PutByte(temp_crc >> 8);
-    Serial_PutByte(temp_crc & 0xFF);
-#else /* CRC16_F */   
-    temp_chksum = CalcChecksum (&aPacketData[PACKET_DATA_INDEX], PACKET_SIZE);
-    Serial_PutByte(temp_chksum);
-#endif /* CRC16_F */
+    frame_length = AppendTrailer(aPacketData, PACKET_SIZE);
+    Serial_PutFrame(&aPacketData[PACKET_START_INDEX], frame_length);
+    Serial_WaitTxDone();
 
     /* Wait for Ack and 'C' */
-    if (HAL_UART_Receive(&UartHandle, &a_rx_ctrl[0], 1, NAK_TIMEOUT) == HAL_OK)
+    if (Serial_Receive(&a_rx_ctrl[0], 1, rtt.rto) == HAL_OK)
     {
       if (a_rx_ctrl[0] == CA)
       {
           HAL_Delay( 2 );
-          __HAL_UART_FLUSH_DRREGISTER(&UartHandle);
-          __HAL_UART_CLEAR_IT(&UartHandle, UART_CLEAR_OREF);
+          Serial_RxFlush();
           result = COM_ABORT;
       }
     }
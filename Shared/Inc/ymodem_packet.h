@@ -1,50 +1,22 @@
 /**
   ******************************************************************************
-  * @file    IAP_Main/Inc/ymodem.h 
-  * @author  MCD Application Team
+  * @file    ymodem_packet.h
+  * @author  Lierda STBU
   * @version 1.0.0
-  * @date    8-April-2015
-  * @brief   This file provides all the software function headers of the ymodem.c 
-  *          file.
+  * @date    2026-10-18
+  * @brief   This file provides the YMODEM packet layout and control bytes,
+  *          used by the bootloader (Core/Inc/ymodem.h, services.c) and by
+  *          the update agent of the application: the include path of both
+  *          projects has Shared/Inc.
   ******************************************************************************
-  *
-  * Licensed under MCD-ST Liberty SW License Agreement V2, (the "License");
-  * You may not use this file except in compliance with the License.
-  * You may obtain a copy of the License at:
-  *
-  *        http://www.st.com/software_license_agreement_liberty_v2
-  *
-  * Unless required by applicable law or agreed to in writing, software 
-  * distributed under the License is distributed on an "AS IS" BASIS, 
-  * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
-  * See the License for the specific language governing permissions and
-  * limitations under the License.
-  *
-  ******************************************************************************
-  */ 
+  */
 
 /* Define to prevent recursive inclusion -------------------------------------*/
-#ifndef __YMODEM_H_
-#define __YMODEM_H_
+#ifndef __YMODEM_PACKET_H
+#define __YMODEM_PACKET_H
 
 /* Includes ------------------------------------------------------------------*/
-/* Exported types ------------------------------------------------------------*/
-
-/**
-  * @brief  Comm status structures definition
-  */
-typedef enum
-{
-  COM_OK       = 0x00,
-  COM_ERROR    = 0x01,
-  COM_ABORT    = 0x02,
-  COM_TIMEOUT  = 0x03,
-  COM_DATA     = 0x04,
-  COM_LIMIT    = 0x05
-} COM_StatusTypeDef;
-/**
-  * @}
-  */
+#include <stdint.h>
 
 /* Exported constants --------------------------------------------------------*/
 /* Packet structure defines */
@@ -77,17 +49,6 @@ typedef enum
 #define CRC16                   ((uint8_t)0x43)  /* 'C' == 0x43, request 16-bit CRC */
 #define NEGATIVE_BYTE           ((uint8_t)0xFF)
 
-#define ABORT1                  ((uint8_t)0x41)  /* 'A' == 0x41, abort by user */
-#define ABORT2                  ((uint8_t)0x61)  /* 'a' == 0x61, abort by user */
-
-#define NAK_TIMEOUT             ((uint32_t)0x100000)
-#define DOWNLOAD_TIMEOUT        ((uint32_t)1000) /* One second retry delay */
-#define MAX_ERRORS              ((uint32_t)5)
-
-/* Exported functions ------------------------------------------------------- */
-COM_StatusTypeDef Ymodem_Receive(uint32_t *p_size);
-COM_StatusTypeDef Ymodem_Transmit(uint8_t *p_buf, const uint8_t *p_file_name, uint32_t file_size);
-
-#endif  /* __YMODEM_H_ */
+#endif  /* __YMODEM_PACKET_H */
 
-/*******************(C)COPYRIGHT STMicroelectronics ********END OF FILE********/
+/*******************************END OF FILE************************************/
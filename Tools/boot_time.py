@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Check the boot phase times reported by the application.
+
+The bootloader times each phase from reset (Core/Src/boot_time.c) and the
+application prints them once after its UART is up (APPCore/Src/boot_time.c):
+
+    Boot (us): reset 2210, hal 35, gpio 14, key 21, clock 96, check 41230, jump 2180, total 45786, inputs 0x00
+
+The line is read from the serial port after a reset, or from a log. The
+application must only have been started with no decision input set, and no
+phase may be slower than in the baseline by more than the tolerance:
+
+    boot_time.py --port /dev/ttyUSB0 --save baseline.json   # reference board
+    boot_time.py --port /dev/ttyUSB0 --baseline baseline.json
+    boot_time.py --log console.txt --baseline baseline.json --tolerance 10
+"""
+
+import argparse
+import json
+import re
+import sys
+
+PHASES = ("reset", "hal", "gpio", "key", "clock", "check", "jump")
+INPUTS = {0x01: "boot request", 0x02: "key pressed", 0x04: "no image", 0x08: "not verified"}
+LINE = re.compile(r"Boot \(us\):(?P<fields>.*)")
+
+
+def parse(text):
+    for line in text.splitlines():
+        match = LINE.search(line)
+        if match is None:
+            continue
+        values = {}
+        for field in match.group("fields").split(","):
+            name, _, value = field.strip().partition(" ")
+            if name:
+                values[name] = int(value, 0)
+        missing = [name for name in PHASES + ("total", "inputs") if name not in values]
+        if missing:
+            raise ValueError("boot line without %s" % ", ".join(missing))
+        return values
+    raise ValueError("no boot line received")
+
+
+def read_port(port, baud, timeout):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=timeout) as link:
+        link.reset_input_buffer()
+        print("reset the board...", file=sys.stderr)
+        return link.read_until(b"inputs").decode("ascii", "replace") + \
+            link.readline().decode("ascii", "replace")
+
+
+def check(values, baseline, tolerance, slack):
+    problems = []
+    # The application is only started when nothing asks for the IAP
+    if values["inputs"] != 0:
+        names = [name for bit, name in INPUTS.items() if values["inputs"] & bit]
+        problems.append("application started with inputs %s" % ", ".join(names))
+    if sum(values[name] for name in PHASES) != values["total"]:
+        problems.append("phases do not add up to the total")
+    for name in PHASES + ("total",):
+        if name not in baseline:
+            continue
+        limit = baseline[name] * (100 + tolerance) // 100 + slack
+        if values[name] > limit:
+            problems.append("%s: %d us, baseline %d us" % (name, values[name], baseline[name]))
+    return problems
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    source = parser.add_mutually_exclusive_group(required=True)
+    source.add_argument("--port", help="serial port of the application")
+    source.add_argument("--log", help="console log holding the boot line")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=30, help="seconds to wait for the line")
+    parser.add_argument("--baseline", help="JSON baseline to compare with")
+    parser.add_argument("--save", help="write the times as a JSON baseline")
+    parser.add_argument("--tolerance", type=int, default=5, help="percent above the baseline")
+    parser.add_argument("--slack", type=int, default=20, help="us above the baseline, for short phases")
+    args = parser.parse_args()
+
+    try:
+        if args.port:
+            text = read_port(args.port, args.baud, args.timeout)
+        else:
+            with open(args.log, encoding="ascii", errors="replace") as f:
+                text = f.read()
+        values = parse(text)
+    except (OSError, ValueError) as err:
+        sys.exit("error: %s" % err)
+
+    for name in PHASES + ("total",):
+        print("%-6s %8d us" % (name, values[name]))
+
+    baseline = {}
+    if args.baseline:
+        with open(args.baseline) as f:
+            baseline = json.load(f)
+    if args.save:
+        with open(args.save, "w") as f:
+            json.dump({name: values[name] for name in PHASES + ("total",)}, f, indent=2)
+
+    problems = check(values, baseline, args.tolerance, args.slack)
+    for problem in problems:
+        print("regression: %s" % problem, file=sys.stderr)
+    sys.exit(1 if problems else 0)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,114 @@
+#!/usr/bin/env python3
+"""Encrypt an image for a bootloader built with YMODEM_ENCRYPTED.
+
+The output is one 1024-byte header block, then the image encrypted with
+ChaCha20 (RFC 8439, block counter from 0), decrypted by the bootloader as the
+blocks arrive (see Core/Src/ymodem.c). The header is:
+
+    magic "IAPE" | version | 3 reserved | 12-byte nonce | 0xFF up to 1024
+
+Send the output with any YMODEM sender; the name still selects the region.
+Sign before encrypting: the signature covers the plain image. A fresh random
+nonce is drawn for every output, never reuse one with the same key.
+
+    encrypt_image.py keygen image.key      # prints the aImageKey array
+    encrypt_image.py encrypt --key image.key app_signed.bin app.bin
+
+The cipher gives no integrity on its own, build with IAP_SIGNED_IMAGES.
+"""
+
+import argparse
+import os
+import struct
+import sys
+
+MAGIC = 0x45504149
+VERSION = 1
+HEADER_SIZE = 1024
+MASK = 0xFFFFFFFF
+
+
+def rotl(value, count):
+    return ((value << count) | (value >> (32 - count))) & MASK
+
+
+def quarter(x, a, b, c, d):
+    x[a] = (x[a] + x[b]) & MASK
+    x[d] = rotl(x[d] ^ x[a], 16)
+    x[c] = (x[c] + x[d]) & MASK
+    x[b] = rotl(x[b] ^ x[c], 12)
+    x[a] = (x[a] + x[b]) & MASK
+    x[d] = rotl(x[d] ^ x[a], 8)
+    x[c] = (x[c] + x[d]) & MASK
+    x[b] = rotl(x[b] ^ x[c], 7)
+
+
+def chacha20_block(key, counter, nonce):
+    state = [0x61707865, 0x3320646e, 0x79622d32, 0x6b206574]
+    state += list(struct.unpack("<8I", key)) + [counter] + list(struct.unpack("<3I", nonce))
+    x = list(state)
+    for _ in range(10):
+        quarter(x, 0, 4, 8, 12)
+        quarter(x, 1, 5, 9, 13)
+        quarter(x, 2, 6, 10, 14)
+        quarter(x, 3, 7, 11, 15)
+        quarter(x, 0, 5, 10, 15)
+        quarter(x, 1, 6, 11, 12)
+        quarter(x, 2, 7, 8, 13)
+        quarter(x, 3, 4, 9, 14)
+    return struct.pack("<16I", *[(a + b) & MASK for a, b in zip(x, state)])
+
+
+def chacha20(key, nonce, data, counter=0):
+    out = bytearray(data)
+    for offset in range(0, len(out), 64):
+        stream = chacha20_block(key, counter + offset // 64, nonce)
+        for i, byte in enumerate(stream[:len(out) - offset]):
+            out[offset + i] ^= byte
+    return bytes(out)
+
+
+def c_array(key):
+    rows = []
+    for i in range(0, len(key), 16):
+        rows.append("  " + ", ".join("0x%02x" % b for b in key[i:i + 16]))
+    return "{\n" + ",\n".join(rows) + "\n};"
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+    keygen = commands.add_parser("keygen", help="make a new key file")
+    keygen.add_argument("key")
+    encrypt = commands.add_parser("encrypt", help="encrypt an image")
+    encrypt.add_argument("--key", required=True, help="32-byte key file made by keygen")
+    encrypt.add_argument("image", help="plain binary")
+    encrypt.add_argument("output", help="encrypted binary to download")
+    args = parser.parse_args()
+
+    if args.command == "keygen":
+        if os.path.exists(args.key):
+            sys.exit("error: %s exists, not overwritten" % args.key)
+        key = os.urandom(32)
+        with open(args.key, "wb") as f:
+            f.write(key)
+        print(c_array(key))
+        return
+
+    with open(args.key, "rb") as f:
+        key = f.read()
+    if len(key) != 32:
+        sys.exit("error: %s is not a 32-byte key" % args.key)
+    with open(args.image, "rb") as f:
+        data = f.read()
+    nonce = os.urandom(12)
+    header = struct.pack("<IB3x", MAGIC, VERSION) + nonce
+    header += b"\xff" * (HEADER_SIZE - len(header))
+    with open(args.output, "wb") as f:
+        f.write(header + chacha20(key, nonce, data))
+    print("%s: %d bytes encrypted, nonce %s" % (args.output, len(data), nonce.hex()))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""Check the Flash of a unit against an image without reading it back.
+
+Sends a DIGEST_REQUEST_KEY request to the bootloader main menu (see
+Core/Src/menu.c) and compares the digest computed on the device with the one
+of the image. With --pages the digest of each Flash page is asked as well and
+the pages that differ are listed. The answer frame is:
+
+    magic "IAPD" | version | algorithm | status | digest size | start | length
+    | pages | reserved | range digest | page digests | CRC16 (MSB first)
+
+    flash_digest.py --port /dev/ttyUSB0 app.bin                # app slot
+    flash_digest.py --port /dev/ttyUSB0 --address 0x08017000 cal.bin --pages
+
+Exits with status 1 when the Flash does not match the image.
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+import time
+import zlib
+
+DIGEST_MAGIC = 0x44504149
+ALGORITHMS = {"crc32": 1, "sha256": 2}
+FLAG_PAGES = 0x01
+STATUS = {1: "range not inside the Flash", 2: "algorithm not supported"}
+PAGE_SIZE = 0x800
+HEADER = struct.Struct("<IBBBBIIHH")
+REQUEST = struct.Struct("<BBHII")
+
+
+def crc16_xmodem(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def digest(algorithm, data):
+    if algorithm == ALGORITHMS["crc32"]:
+        return struct.pack("<I", zlib.crc32(data) & 0xFFFFFFFF)
+    if algorithm == ALGORITHMS["sha256"]:
+        return hashlib.sha256(data).digest()
+    raise ValueError("unknown algorithm %d" % algorithm)
+
+
+def split_pages(start, data):
+    """Cut the image on the Flash page boundaries, as the bootloader does."""
+    chunks, offset = [], 0
+    while offset < len(data):
+        end = min(((start + offset) // PAGE_SIZE + 1) * PAGE_SIZE - start, len(data))
+        chunks.append((start + offset, data[offset:end]))
+        offset = end
+    return chunks
+
+
+def parse(frame):
+    magic, _, algorithm, status, size, start, length, pages, _ = HEADER.unpack_from(frame)
+    if magic != DIGEST_MAGIC:
+        raise ValueError("bad digest magic 0x%08x" % magic)
+    if status != 0:
+        raise ValueError(STATUS.get(status, "status %d" % status))
+    end = HEADER.size + size * (pages + 1)
+    if len(frame) < end + 2:
+        raise ValueError("truncated digest frame")
+    if crc16_xmodem(frame[:end]) != struct.unpack_from(">H", frame, end)[0]:
+        raise ValueError("digest frame CRC mismatch")
+    body = frame[HEADER.size:end]
+    return [body[i:i + size] for i in range(0, len(body), size)]
+
+
+def fetch(port, baud, request, timeout):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=0.1) as link:
+        link.reset_input_buffer()
+        link.write(b"D" + request)
+        # skip the menu text until the frame shows up
+        data, deadline = b"", time.time() + timeout
+        magic = struct.pack("<I", DIGEST_MAGIC)
+        while time.time() < deadline:
+            data += link.read(256)
+            found = data.find(magic)
+            if found >= 0 and len(data) - found >= HEADER.size:
+                frame = data[found:]
+                size, pages = frame[7], struct.unpack_from("<H", frame, 16)[0]
+                total = HEADER.size + size * (pages + 1) + 2
+                while len(frame) < total and time.time() < deadline:
+                    frame += link.read(total - len(frame))
+                return frame
+        raise ValueError("no digest frame received")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("image", help="binary expected in the Flash")
+    parser.add_argument("--port", required=True, help="serial port of the bootloader")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--address", type=lambda text: int(text, 0), default=0x0800C000,
+                        help="Flash address of the image (default: app slot)")
+    parser.add_argument("--algorithm", choices=sorted(ALGORITHMS), default="crc32")
+    parser.add_argument("--pages", action="store_true", help="also compare each Flash page")
+    parser.add_argument("--timeout", type=float, default=10.0, help="seconds to wait for the answer")
+    args = parser.parse_args()
+
+    with open(args.image, "rb") as f:
+        data = f.read()
+    algorithm = ALGORITHMS[args.algorithm]
+    request = REQUEST.pack(algorithm, FLAG_PAGES if args.pages else 0, 0, args.address, len(data))
+
+    try:
+        digests = parse(fetch(args.port, args.baud, request, args.timeout))
+    except ValueError as err:
+        sys.exit("error: %s" % err)
+
+    match = digests[0] == digest(algorithm, data)
+    print("range 0x%08x+0x%x: %s" % (args.address, len(data), "match" if match else "MISMATCH"))
+    for (address, chunk), device in zip(split_pages(args.address, data), digests[1:]):
+        if device != digest(algorithm, chunk):
+            print("  page 0x%08x differs" % address)
+    sys.exit(0 if match else 1)
+
+
+if __name__ == "__main__":
+    main()
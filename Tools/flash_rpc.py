@@ -0,0 +1,409 @@
+#!/usr/bin/env python3
+"""Erase, write, read and digest the Flash through the binary command protocol.
+
+Sends RPC_REQUEST_KEY to the bootloader main menu (see Core/Src/menu.c) and
+then COBS framed requests ending with 0x00 (Core/Inc/rpc.h). Decoded, a frame
+is:
+
+    request: command | 0 | id (16-bit) | arguments | CRC-32 (zlib)
+    answer:  command | 0x80 | status | id (16-bit) | results | CRC-32
+
+Several requests are kept outstanding as long as they fit in the receive ring
+of the bootloader, each one is sent again after a timeout. The bootloader goes
+back to its menu after 10 s without a request.
+
+    flash_rpc.py --port /dev/ttyUSB0 info
+    flash_rpc.py --port /dev/ttyUSB0 write app.bin --changed    # changed pages only
+    flash_rpc.py --port /dev/ttyUSB0 digest 0x0800C000 0x1000 --algorithm sha256
+    flash_rpc.py --port /dev/ttyUSB0 read 0x08017000 0x1000 cal.bin
+    flash_rpc.py --port /dev/ttyUSB0 jump
+
+Without a board, "standin" opens a pseudo terminal served by a model of the
+bootloader and prints its name, to be given as --port to the other commands:
+
+    flash_rpc.py standin --drop 5 &
+"""
+
+import argparse
+import hashlib
+import os
+import random
+import struct
+import sys
+import time
+import zlib
+
+REQUEST_KEY = b"R"
+VERSION = 1
+REPLY = 0x80
+CMD = {"getinfo": 0x01, "erase": 0x02, "write": 0x03, "read": 0x04, "digest": 0x05, "jump": 0x06}
+STATUS = {1: "unknown command", 2: "bad length", 3: "outside the slots or not aligned",
+          4: "Flash erase or program failed, or not erased"}
+ALGORITHMS = {"crc32": 1, "sha256": 2}
+SLOT_NAMES = {0x02: "app", 0x03: "calibration", 0x04: "resource"}
+HEADER = struct.Struct("<BBH")
+INFO = struct.Struct("<BBHII")
+SLOT = struct.Struct("<B3xII")
+RANGE = struct.Struct("<II")
+
+
+class RpcError(Exception):
+    pass
+
+
+def cobs_encode(data):
+    out, block = bytearray(), bytearray()
+    for byte in data:
+        if byte == 0:
+            out += bytes([len(block) + 1]) + block
+            block = bytearray()
+            continue
+        block.append(byte)
+        if len(block) == 254:
+            out += b"\xff" + block
+            block = bytearray()
+    out += bytes([len(block) + 1]) + block
+    return bytes(out) + b"\x00"
+
+
+def cobs_decode(frame):
+    out, index = bytearray(), 0
+    while index < len(frame):
+        code = frame[index]
+        if code == 0 or index + code > len(frame):
+            raise ValueError("bad COBS frame")
+        out += frame[index + 1:index + code]
+        index += code
+        if code < 0xFF and index < len(frame):
+            out.append(0)
+    return bytes(out)
+
+
+def seal(payload):
+    return cobs_encode(payload + struct.pack("<I", zlib.crc32(payload) & 0xFFFFFFFF))
+
+
+def unseal(frame):
+    """Payload of a frame without its delimiter, None if damaged."""
+    try:
+        data = cobs_decode(frame)
+    except ValueError:
+        return None
+    if len(data) < HEADER.size + 4:
+        return None
+    if struct.unpack_from("<I", data, len(data) - 4)[0] != zlib.crc32(data[:-4]) & 0xFFFFFFFF:
+        return None
+    return data[:-4]
+
+
+def digest(algorithm, data):
+    if algorithm == ALGORITHMS["crc32"]:
+        return struct.pack("<I", zlib.crc32(data) & 0xFFFFFFFF)
+    if algorithm == ALGORITHMS["sha256"]:
+        return hashlib.sha256(data).digest()
+    raise ValueError("unknown algorithm %d" % algorithm)
+
+
+class Client:
+    """Pipelined requests over a pyserial port already in the protocol."""
+
+    def __init__(self, link, timeout, retries):
+        self.link = link
+        self.timeout = timeout
+        self.retries = retries
+        self.window = 256           # until GETINFO tells the receive ring size
+        self.next_id = 0
+        self.pending = b""
+        self.resent = 0
+
+    def run(self, requests):
+        """Send (command, arguments) requests, return their results in order."""
+        frames, results = [], [None] * len(requests)
+        for command, arguments in requests:
+            frames.append(seal(HEADER.pack(command, 0, self.next_id) + arguments))
+            self.next_id = (self.next_id + 1) & 0xFFFF
+        first_id = (self.next_id - len(requests)) & 0xFFFF
+        done = sent = 0
+        tries, deadline = 0, None
+        while done < len(requests):
+            # Keep the outstanding frames within the receive ring
+            while sent < len(frames) and \
+                    sum(len(frame) for frame in frames[done:sent + 1]) <= self.window:
+                self.link.write(frames[sent])
+                sent += 1
+                deadline = time.time() + self.timeout
+            payload = self.receive(deadline)
+            if payload is None:
+                tries += 1
+                if tries > self.retries:
+                    raise RpcError("no answer to request %d" % done)
+                # Served in order: send again from the oldest unanswered
+                self.resent += sent - done
+                sent = done
+                continue
+            command, status, request_id = HEADER.unpack_from(payload)
+            index = (request_id - first_id) & 0xFFFF
+            if index != done:
+                continue            # answer to a request sent twice
+            if command != requests[index][0] | REPLY:
+                raise RpcError("answer to command 0x%02x instead of 0x%02x"
+                               % (command & ~REPLY, requests[index][0]))
+            if status != 0:
+                raise RpcError(STATUS.get(status, "status %d" % status))
+            results[index] = payload[HEADER.size:]
+            done += 1
+            tries, deadline = 0, time.time() + self.timeout
+        return results
+
+    def receive(self, deadline):
+        while True:
+            end = self.pending.find(b"\x00")
+            while end >= 0:
+                frame, self.pending = self.pending[:end], self.pending[end + 1:]
+                payload = unseal(frame)
+                if payload is not None:
+                    return payload
+                end = self.pending.find(b"\x00")
+            if time.time() >= deadline:
+                return None
+            self.pending += self.link.read(max(1, self.link.in_waiting))
+
+    def info(self):
+        data = self.run([(CMD["getinfo"], b"")])[0]
+        version, count, max_data, page_size, ring = INFO.unpack_from(data)
+        if version != VERSION:
+            raise RpcError("protocol version %d, expected %d" % (version, VERSION))
+        slots = [SLOT.unpack_from(data, INFO.size + i * SLOT.size) for i in range(count)]
+        # Requests not served yet wait in the receive ring
+        self.window = ring
+        return {"max_data": max_data, "page_size": page_size, "ring": ring, "slots": slots}
+
+
+def open_link(args):
+    import serial  # pyserial
+
+    link = serial.Serial(args.port, args.baud, timeout=0.05)
+    link.reset_input_buffer()
+    link.write(REQUEST_KEY)
+    # Let the menu echo settle before the first frame
+    time.sleep(0.1)
+    link.reset_input_buffer()
+    return link
+
+
+def pages_of(start, length, page_size):
+    first = start - start % page_size
+    return list(range(first, start + length, page_size))
+
+
+def cmd_info(client, info, args):
+    print("protocol %d, %d bytes per request, page 0x%x, receive ring %d bytes"
+          % (VERSION, info["max_data"], info["page_size"], info["ring"]))
+    for kind, address, size in info["slots"]:
+        print("  %-12s 0x%08x+0x%x" % (SLOT_NAMES.get(kind, "type %d" % kind), address, size))
+
+
+def cmd_erase(client, info, args):
+    client.run([(CMD["erase"], RANGE.pack(args.address, args.length))])
+
+
+def cmd_write(client, info, args):
+    with open(args.image, "rb") as f:
+        data = f.read()
+    # Doubleword programming: pad with the erased value
+    data += b"\xff" * (-len(data) % 8)
+    page_size = info["page_size"]
+    pages = pages_of(args.address, len(data), page_size)
+    if args.address % page_size:
+        raise RpcError("address 0x%08x is not page aligned" % args.address)
+    if args.changed:
+        requests = [(CMD["digest"], RANGE.pack(page, page_size) + bytes([ALGORITHMS["crc32"], 0, 0, 0]))
+                    for page in pages]
+        device = client.run(requests)
+        image = data + b"\xff" * (-len(data) % page_size)
+        pages = [page for page, crc in zip(pages, device)
+                 if crc != digest(ALGORITHMS["crc32"], image[page - args.address:][:page_size])]
+    requests = []
+    for page in pages:
+        requests.append((CMD["erase"], RANGE.pack(page, page_size)))
+        chunk = data[page - args.address:][:page_size].rstrip(b"\xff")
+        chunk += b"\xff" * (-len(chunk) % 8)
+        for offset in range(0, len(chunk), args.chunk):
+            requests.append((CMD["write"], struct.pack("<I", page + offset) +
+                             chunk[offset:offset + args.chunk]))
+    client.run(requests)
+    print("%d page(s) written, %d request(s) sent again" % (len(pages), client.resent))
+
+
+def cmd_read(client, info, args):
+    requests = [(CMD["read"], RANGE.pack(args.address + offset, min(args.chunk, args.length - offset)))
+                for offset in range(0, args.length, args.chunk)]
+    with open(args.output, "wb") as f:
+        f.write(b"".join(client.run(requests)))
+
+
+def cmd_digest(client, info, args):
+    algorithm = ALGORITHMS[args.algorithm]
+    result = client.run([(CMD["digest"], RANGE.pack(args.address, args.length) +
+                          bytes([algorithm, 0, 0, 0]))])[0]
+    print(result.hex())
+
+
+def cmd_jump(client, info, args):
+    client.run([(CMD["jump"], b"")])
+
+
+def standin(args):
+    """Serve the protocol on a pseudo terminal from a model of the Flash."""
+    import tty
+
+    page_size, ring = 0x800, 2048
+    slots = [(0x02, 0x0800C000, 0xB000), (0x03, 0x08017000, 0x1000), (0x04, 0x08018000, 0x7000)]
+    flash = {address: bytearray(b"\xff" * size) for _, address, size in slots}
+    rng = random.Random(args.seed)
+
+    def locate(address, length):
+        for _, start, size in slots:
+            if start <= address and address + length <= start + size:
+                return flash[start], address - start
+        return None, 0
+
+    def execute(request):
+        command, _, request_id = HEADER.unpack_from(request)
+        arguments, status, result = request[HEADER.size:], 0, b""
+        address, length = RANGE.unpack_from(arguments) if len(arguments) >= 8 else (0, 0)
+        if command == CMD["getinfo"]:
+            result = INFO.pack(VERSION, len(slots), 1024, page_size, ring) + \
+                b"".join(SLOT.pack(*slot) for slot in slots)
+        elif command == CMD["erase"]:
+            memory, offset = locate(address, length)
+            if len(arguments) != 8:
+                status = 2
+            elif address % page_size or length == 0 or memory is None:
+                status = 3
+            else:
+                first = offset - offset % page_size
+                last = offset + length + (-(offset + length) % page_size)
+                memory[first:last] = b"\xff" * (last - first)
+        elif command == CMD["write"]:
+            data = arguments[4:]
+            address = struct.unpack_from("<I", arguments)[0] if len(arguments) >= 4 else 0
+            memory, offset = locate(address, len(data))
+            if len(arguments) < 12 or len(data) > 1024 or len(data) % 8:
+                status = 2
+            elif address % 8 or memory is None:
+                status = 3
+            elif memory[offset:offset + len(data)] == data:
+                pass
+            elif memory[offset:offset + len(data)] != b"\xff" * len(data):
+                status = 4
+            else:
+                memory[offset:offset + len(data)] = data
+        elif command == CMD["read"]:
+            memory, offset = locate(address, length)
+            if len(arguments) != 8 or length > 1024:
+                status = 2
+            elif memory is None:
+                status = 3
+            else:
+                result = bytes(memory[offset:offset + length])
+        elif command == CMD["digest"]:
+            memory, offset = locate(address, length)
+            if len(arguments) != 12:
+                status = 2
+            elif arguments[8] not in ALGORITHMS.values():
+                status = 1
+            elif length == 0 or memory is None:
+                status = 3
+            else:
+                result = digest(arguments[8], bytes(memory[offset:offset + length]))
+        elif command == CMD["jump"]:
+            status = 0 if not arguments else 2
+        else:
+            status = 1
+        return HEADER.pack(command | REPLY, status, request_id) + (result if status == 0 else b"")
+
+    master, slave = os.openpty()
+    tty.setraw(slave)
+    print(os.ttyname(slave), flush=True)
+    menu, pending, last = True, b"", time.time()
+    while True:
+        data = os.read(master, 4096)
+        if not menu and time.time() - last > 10:
+            menu = True         # idle timeout, back to the menu
+        last = time.time()
+        if menu:
+            # Bytes before the key are menu input
+            key = data.find(REQUEST_KEY)
+            if key < 0:
+                continue
+            menu, pending, data = False, b"", data[key + 1:]
+        pending += data
+        end = pending.find(b"\x00")
+        while end >= 0:
+            frame, pending = pending[:end], pending[end + 1:]
+            end = pending.find(b"\x00")
+            request = unseal(frame)
+            if request is None or rng.randrange(100) < args.drop:
+                continue        # dropped, as a damaged frame
+            reply = execute(request)
+            os.write(master, seal(reply))
+            if request[0] == CMD["jump"] and reply[1] == 0:
+                menu, pending, end = True, b"", -1
+
+
+def main():
+    number = lambda text: int(text, 0)
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", help="serial port of the bootloader")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--timeout", type=float, default=1.0, help="seconds to wait for an answer")
+    parser.add_argument("--retries", type=int, default=5, help="times a request is sent again")
+    commands = parser.add_subparsers(dest="command", required=True)
+    commands.add_parser("info", help="list the slots and limits")
+    command = commands.add_parser("erase", help="erase the pages of a range")
+    command.add_argument("address", type=number)
+    command.add_argument("length", type=number)
+    command = commands.add_parser("write", help="erase and write an image")
+    command.add_argument("image")
+    command.add_argument("--address", type=number, default=0x0800C000,
+                         help="Flash address of the image (default: app slot)")
+    command.add_argument("--changed", action="store_true",
+                         help="only the pages whose CRC-32 differs from the image")
+    command.add_argument("--chunk", type=int, default=512, help="bytes per request, multiple of 8")
+    command = commands.add_parser("read", help="read a range into a file")
+    command.add_argument("address", type=number)
+    command.add_argument("length", type=number)
+    command.add_argument("output")
+    command.add_argument("--chunk", type=int, default=1024, help="bytes per request")
+    command = commands.add_parser("digest", help="digest a range on the device")
+    command.add_argument("address", type=number)
+    command.add_argument("length", type=number)
+    command.add_argument("--algorithm", choices=sorted(ALGORITHMS), default="crc32")
+    commands.add_parser("jump", help="restart into the application if it checks")
+    command = commands.add_parser("standin", help="serve a model of the bootloader on a PTY")
+    command.add_argument("--drop", type=int, default=0, help="percent of requests ignored")
+    command.add_argument("--seed", type=int, default=0)
+    args = parser.parse_args()
+
+    if args.command == "standin":
+        standin(args)
+        return
+    if args.port is None:
+        parser.error("--port is required")
+    if getattr(args, "chunk", 8) % 8 or not 0 < getattr(args, "chunk", 8) <= 1024:
+        parser.error("--chunk must be a multiple of 8, up to 1024")
+
+    try:
+        link = open_link(args)
+        with link:
+            client = Client(link, args.timeout, args.retries)
+            info = client.info()
+            globals()["cmd_" + args.command](client, info, args)
+    except (OSError, ValueError, RpcError) as err:
+        sys.exit("error: %s" % err)
+
+
+if __name__ == "__main__":
+    main()
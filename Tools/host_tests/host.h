@@ -0,0 +1,101 @@
+/**
+  ******************************************************************************
+  * @file    host.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the helpers shared by the host checks: failure
+  *          report, test data and time stamps for the benchmarks.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_H
+#define __HOST_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+/* Exported macro ------------------------------------------------------------*/
+/* Stop the check at the first failure, with its place in the source */
+#define CHECK(cond)                                                            \
+  do                                                                           \
+  {                                                                            \
+    if (!(cond))                                                               \
+    {                                                                          \
+      fprintf(stderr, "%s:%d: check failed: %s\n", __FILE__, __LINE__, #cond); \
+      exit(1);                                                                 \
+    }                                                                          \
+  } while (0)
+
+/* Exported functions ------------------------------------------------------- */
+
+/**
+  * @brief  Deterministic test data, xorshift32
+  * @param  p_state: generator state, not 0
+  * @retval Next value
+  */
+static inline uint32_t Host_Random(uint32_t *p_state)
+{
+  uint32_t x = *p_state;
+
+  x ^= x << 13;
+  x ^= x >> 17;
+  x ^= x << 5;
+  *p_state = x;
+  return x;
+}
+
+/**
+  * @brief  Decode a hexadecimal string
+  * @param  p_out: receives strlen(p_hex) / 2 bytes
+  * @param  p_hex: digits, no separator
+  * @retval Number of bytes
+  */
+static inline uint32_t Host_Hex(uint8_t *p_out, const char *p_hex)
+{
+  uint32_t i, n = (uint32_t)strlen(p_hex) / 2;
+  unsigned int byte;
+
+  for (i = 0; i < n; i++)
+  {
+    sscanf(&p_hex[2 * i], "%2x", &byte);
+    p_out[i] = (uint8_t)byte;
+  }
+  return n;
+}
+
+/**
+  * @brief  Monotonic time in ns
+  */
+static inline uint64_t Host_Nanoseconds(void)
+{
+  struct timespec now;
+
+  clock_gettime(CLOCK_MONOTONIC, &now);
+  return (uint64_t)now.tv_sec * 1000000000U + (uint64_t)now.tv_nsec;
+}
+
+/**
+  * @brief  Cycle counter of the host, 0 where there is none to read
+  */
+static inline uint64_t Host_Cycles(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+  uint32_t low, high;
+
+  /* Not x86intrin.h: its arguments named __I clash with CMSIS */
+  __asm__ volatile ("rdtsc" : "=a" (low), "=d" (high));
+  return ((uint64_t)high << 32) | low;
+#else
+  return 0;
+#endif
+}
+
+#endif  /* __HOST_H */
+
+/*******************************END OF FILE************************************/
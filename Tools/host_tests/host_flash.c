@@ -0,0 +1,122 @@
+/**
+  ******************************************************************************
+  * @file    host_flash.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the HAL Flash driver flash_if.c links against
+  *          on the host. A doubleword or a fast row is only programmed over
+  *          erased cells, as the FLASH_SR PROGERR check of the device
+  *          requires; anything else is refused and counted.
+  *          The checks must be linked with -no-pie: flash_if.c passes the
+  *          row buffer to HAL_FLASH_Program as a 32-bit address.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "host.h"
+#include "host_flash.h"
+#include <sys/mman.h>
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t *pArray;
+static uint32_t FlashLocked = 1;
+
+/* Exported variables --------------------------------------------------------*/
+HostFlash_StatsTypeDef HostFlashStats;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Check that a range of the array is erased
+  */
+static uint32_t HostFlash_IsErased(uint32_t address, uint32_t length)
+{
+  uint32_t i;
+
+  for (i = 0; i < length; i++)
+  {
+    if (pArray[address - FLASH_BASE + i] != 0xFF)
+    {
+      return 0;
+    }
+  }
+  return 1;
+}
+
+/* Public functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Map the array at FLASH_BASE on first use, then erase all of it
+  */
+void HostFlash_Reset(void)
+{
+  if (pArray == NULL)
+  {
+    pArray = mmap((void *)FLASH_BASE, HOST_FLASH_SIZE, PROT_READ | PROT_WRITE,
+                  MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+    CHECK(pArray == (uint8_t *)FLASH_BASE);
+  }
+  memset(pArray, 0xFF, HOST_FLASH_SIZE);
+  memset(&HostFlashStats, 0, sizeof(HostFlashStats));
+  FlashLocked = 1;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Unlock(void)
+{
+  FlashLocked = 0;
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_FLASH_Lock(void)
+{
+  FlashLocked = 1;
+  return HAL_OK;
+}
+
+/**
+  * @brief  Program a doubleword, or a row of 32 doublewords from the RAM
+  *         address in the low word of Data
+  */
+HAL_StatusTypeDef HAL_FLASH_Program(uint32_t TypeProgram, uint32_t Address, uint64_t Data)
+{
+  uint32_t length = (TypeProgram == FLASH_TYPEPROGRAM_FAST) ? 256 : 8;
+
+  if (FlashLocked || ((Address % length) != 0) || (Address < FLASH_BASE) ||
+      ((Address + length) > (FLASH_BASE + HOST_FLASH_SIZE)) || !HostFlash_IsErased(Address, length))
+  {
+    HostFlashStats.refused++;
+    return HAL_ERROR;
+  }
+  if (TypeProgram == FLASH_TYPEPROGRAM_FAST)
+  {
+    memcpy(&pArray[Address - FLASH_BASE], (const void *)(uintptr_t)(uint32_t)Data, length);
+    HostFlashStats.fast_rows++;
+  }
+  else
+  {
+    memcpy(&pArray[Address - FLASH_BASE], &Data, length);
+    HostFlashStats.doublewords++;
+  }
+  return HAL_OK;
+}
+
+/**
+  * @brief  Erase whole pages
+  */
+HAL_StatusTypeDef HAL_FLASHEx_Erase(FLASH_EraseInitTypeDef *pEraseInit, uint32_t *PageError)
+{
+  if (FlashLocked || ((pEraseInit->Page + pEraseInit->NbPages) > (HOST_FLASH_SIZE / FLASH_PAGE_SIZE)))
+  {
+    *PageError = pEraseInit->Page;
+    HostFlashStats.refused++;
+    return HAL_ERROR;
+  }
+  memset(&pArray[pEraseInit->Page * FLASH_PAGE_SIZE], 0xFF, pEraseInit->NbPages * FLASH_PAGE_SIZE);
+  HostFlashStats.pages_erased += pEraseInit->NbPages;
+  *PageError = 0xFFFFFFFFU;
+  return HAL_OK;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,41 @@
+/**
+  ******************************************************************************
+  * @file    host_flash.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the Flash model of the host checks: 128K of
+  *          RAM mapped at FLASH_BASE, so flash_if.c reads it at the addresses
+  *          it uses on the device, and the HAL Flash calls that program and
+  *          erase it with the rules of the NOR array.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_FLASH_H
+#define __HOST_FLASH_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define HOST_FLASH_SIZE         ((uint32_t)0x20000)
+
+/* Exported types ------------------------------------------------------------*/
+typedef struct
+{
+  uint32_t fast_rows;           /* FLASH_TYPEPROGRAM_FAST operations */
+  uint32_t doublewords;         /* FLASH_TYPEPROGRAM_DOUBLEWORD operations */
+  uint32_t pages_erased;
+  uint32_t refused;             /* Programming over data, misaligned or locked */
+} HostFlash_StatsTypeDef;
+
+/* Exported variables --------------------------------------------------------*/
+extern HostFlash_StatsTypeDef HostFlashStats;
+
+/* Exported functions ------------------------------------------------------- */
+void HostFlash_Reset(void);
+
+#endif  /* __HOST_FLASH_H */
+
+/*******************************END OF FILE************************************/
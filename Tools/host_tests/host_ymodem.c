@@ -0,0 +1,258 @@
+/**
+  ******************************************************************************
+  * @file    host_ymodem.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides what ymodem.c links against on the host: the
+  *          serial line model, the tick and the CRC unit. The Flash, journal
+  *          and signature paths stop a check that reaches them, unless it is
+  *          built with HOST_YMODEM_FLASH: it then links the Flash model with
+  *          flash_if.c, journal.c, partition.c and sha256.c, and provides
+  *          Verify_Image and Digest_Crc32 itself.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "main.h"
+#include "common.h"
+#include "flash_if.h"
+#include "ymodem.h"
+#include "menu.h"
+#include "partition.h"
+#include "journal.h"
+#include "sha256.h"
+#include "verify.h"
+#include "digest.h"
+#include "serial_rx.h"
+#include "host.h"
+#include "host_ymodem.h"
+
+/* Private define ------------------------------------------------------------*/
+#define LINE_SIZE               ((uint32_t)8192)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint64_t at;          /* Arrival time in ns */
+  uint8_t byte;
+} Line_ByteTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static Line_ByteTypeDef aLine[LINE_SIZE];
+static uint32_t LineHead;
+static uint32_t LineTail;
+
+/* Exported variables --------------------------------------------------------*/
+uint64_t HostTime;
+uint8_t HostResponse;
+void (*pHostSender)(uint8_t response);
+UART_HandleTypeDef UartHandle;
+CRC_HandleTypeDef CrcHandle;
+__IO uint32_t uwTick;
+uint32_t SystemCoreClock = 16000000U;
+uint8_t aFileName[FILE_NAME_LENGTH];
+uint8_t aFileDigest[SHA256_DIGEST_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+static void Host_Unexpected(const char *p_name)
+{
+  fprintf(stderr, "%s: not expected on the host\n", p_name);
+  exit(1);
+}
+
+/* Line model ----------------------------------------------------------------*/
+
+/**
+  * @brief  Empty the line and restart the clock
+  */
+void Line_Reset(void)
+{
+  LineHead = 0;
+  LineTail = 0;
+  HostTime = 0;
+  HostResponse = 0;
+  UartHandle.Init.BaudRate = HOST_BAUD_RATE;
+}
+
+/**
+  * @brief  Queue bytes sent back to back towards the receiver
+  * @param  p_data: bytes
+  * @param  length: number of bytes
+  * @param  start: time the first start bit leaves, in ns
+  */
+void Line_Send(const uint8_t *p_data, uint32_t length, uint64_t start)
+{
+  uint32_t i;
+
+  if (LineHead == LineTail)
+  {
+    LineHead = 0;
+    LineTail = 0;
+  }
+  CHECK((LINE_SIZE - LineHead) >= length);
+  if ((LineHead != LineTail) && (start < aLine[LineHead - 1].at))
+  {
+    start = aLine[LineHead - 1].at;
+  }
+  for (i = 0; i < length; i++)
+  {
+    aLine[LineHead].at = start + (i + 1) * HOST_CHAR_NS;
+    aLine[LineHead].byte = p_data[i];
+    LineHead++;
+  }
+}
+
+/**
+  * @brief  Time the last byte queued is received, in ns
+  */
+uint64_t Line_Idle(void)
+{
+  return (LineHead != 0) ? aLine[LineHead - 1].at : HostTime;
+}
+
+/**
+  * @brief  Bytes queued and not read yet
+  */
+uint32_t Line_Pending(void)
+{
+  return LineHead - LineTail;
+}
+
+/* HAL -----------------------------------------------------------------------*/
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(HostTime / 1000000U);
+}
+
+void HAL_Delay(uint32_t Delay)
+{
+  HostTime += (uint64_t)Delay * 1000000U;
+}
+
+/**
+  * @brief  CRC16-XMODEM over bytes, as the CRC unit is set up by MX_CRC_Init
+  */
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  const uint8_t *p_data = (const uint8_t *)pBuffer;
+  uint32_t i, bit;
+  uint16_t crc = 0;
+
+  (void)hcrc;
+  for (i = 0; i < BufferLength; i++)
+  {
+    crc ^= (uint16_t)(p_data[i] << 8);
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/* Serial --------------------------------------------------------------------*/
+
+/**
+  * @brief  Serial_Receive of serial_rx.c on the line model: the timeout runs
+  *         from the call and expires on the first tick past it
+  */
+HAL_StatusTypeDef Serial_Receive(uint8_t *p_data, uint32_t size, uint32_t timeout)
+{
+  uint32_t tickstart = HAL_GetTick();
+  uint64_t next, deadline = ((uint64_t)tickstart + timeout + 1) * 1000000U;
+
+  while (size != 0)
+  {
+    next = (LineHead != LineTail) ? aLine[LineTail].at : UINT64_MAX;
+    if (next <= HostTime)
+    {
+      *p_data++ = aLine[LineTail++].byte;
+      size--;
+    }
+    else if ((timeout != HAL_MAX_DELAY) && (next >= deadline))
+    {
+      HostTime = (HostTime > deadline) ? HostTime : deadline;
+      return HAL_TIMEOUT;
+    }
+    else
+    {
+      HostTime = next;
+    }
+  }
+  return HAL_OK;
+}
+
+void Serial_RxFlush(void)
+{
+  while ((LineHead != LineTail) && (aLine[LineTail].at <= HostTime))
+  {
+    LineTail++;
+  }
+}
+
+uint32_t Serial_RxSleepTime(void)
+{
+  return 0;
+}
+
+HAL_StatusTypeDef Serial_PutByte(uint8_t param)
+{
+  HostResponse = param;
+  if (pHostSender != NULL)
+  {
+    pHostSender(param);
+  }
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef Serial_PutFrame(uint8_t *p_frame, uint16_t length)
+{
+  (void)p_frame;
+  (void)length;
+  return HAL_OK;
+}
+
+void Serial_WaitTxDone(void)
+{
+}
+
+void Main_IdleClock(uint32_t idle)
+{
+  (void)idle;
+}
+
+void Int2Str(uint8_t *p_str, uint32_t intnum)
+{
+  sprintf((char *)p_str, "%u", (unsigned int)intnum);
+}
+
+uint32_t Str2Int(uint8_t *inputstr, uint32_t *intnum)
+{
+  *intnum = (uint32_t)strtoul((const char *)inputstr, NULL, 0);
+  return 1;
+}
+
+/* Not driven by the checks --------------------------------------------------*/
+#ifndef HOST_YMODEM_FLASH
+uint32_t FLASH_If_EraseRange(uint32_t start, uint32_t length) { Host_Unexpected(__func__); return 0; }
+uint32_t FLASH_If_IsErased(uint32_t start, uint32_t length) { Host_Unexpected(__func__); return 0; }
+void FLASH_If_StreamOpen(uint32_t destination) { Host_Unexpected(__func__); }
+uint32_t FLASH_If_StreamWrite(const uint8_t *p_data, uint32_t length) { Host_Unexpected(__func__); return 0; }
+uint32_t FLASH_If_StreamClose(void) { Host_Unexpected(__func__); return 0; }
+uint32_t Journal_Open(uint8_t type, uint32_t size, uint16_t header_crc) { Host_Unexpected(__func__); return 0; }
+void Journal_Progress(uint32_t offset) { Host_Unexpected(__func__); }
+void Journal_Rewind(uint32_t offset) { Host_Unexpected(__func__); }
+void Journal_Close(void) { Host_Unexpected(__func__); }
+void Journal_Invalidate(void) { Host_Unexpected(__func__); }
+void Journal_Verified(uint32_t size, uint32_t crc) { Host_Unexpected(__func__); }
+uint32_t Part_Address(Part_TypeTypeDef type) { Host_Unexpected(__func__); return 0; }
+uint32_t Part_Size(Part_TypeTypeDef type) { Host_Unexpected(__func__); return 0; }
+void Sha256_Init(Sha256_CtxTypeDef *p_ctx) { Host_Unexpected(__func__); }
+void Sha256_Update(Sha256_CtxTypeDef *p_ctx, const uint8_t *p_data, uint32_t length) { Host_Unexpected(__func__); }
+void Sha256_Final(Sha256_CtxTypeDef *p_ctx, uint8_t *p_digest) { Host_Unexpected(__func__); }
+uint32_t Verify_Image(uint32_t start, uint32_t size, const uint8_t *p_digest) { Host_Unexpected(__func__); return 0; }
+uint32_t Digest_Crc32(uint32_t start, uint32_t length) { Host_Unexpected(__func__); return 0; }
+#endif /* HOST_YMODEM_FLASH */
+
+/*******************************END OF FILE************************************/
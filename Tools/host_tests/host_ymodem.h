@@ -0,0 +1,37 @@
+/**
+  ******************************************************************************
+  * @file    host_ymodem.h
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   This file provides the serial line model the host checks of
+  *          ymodem.c drive: bytes reach the receiver at the wire rate of the
+  *          UART, on a simulated clock that HAL_GetTick reads.
+  ******************************************************************************
+  */
+
+/* Define to prevent recursive inclusion -------------------------------------*/
+#ifndef __HOST_YMODEM_H
+#define __HOST_YMODEM_H
+
+/* Includes ------------------------------------------------------------------*/
+#include <stdint.h>
+
+/* Exported constants --------------------------------------------------------*/
+#define HOST_BAUD_RATE          ((uint32_t)115200)
+#define HOST_CHAR_NS            ((uint64_t)10 * 1000000000U / HOST_BAUD_RATE)
+
+/* Exported variables --------------------------------------------------------*/
+extern uint64_t HostTime;               /* Simulated time in ns */
+extern uint8_t HostResponse;            /* Last byte sent by the receiver */
+extern void (*pHostSender)(uint8_t response); /* Called with each byte sent by the receiver */
+
+/* Exported functions ------------------------------------------------------- */
+void Line_Reset(void);
+void Line_Send(const uint8_t *p_data, uint32_t length, uint64_t start);
+uint64_t Line_Idle(void);
+uint32_t Line_Pending(void);
+
+#endif  /* __HOST_YMODEM_H */
+
+/*******************************END OF FILE************************************/
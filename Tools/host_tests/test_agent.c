@@ -0,0 +1,540 @@
+/**
+  ******************************************************************************
+  * @file    test_agent.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   Main-loop jitter of APPCore/Src/update_agent.c during a download,
+  *          on a simulated clock.
+  *
+  *          The application loop calls Agent_Poll between short pieces of its
+  *          own work. A YMODEM sender at 115200 baud answers the agent's
+  *          ACK, NAK and 'C'. The bootloader services run on the Flash model
+  *          and stall the core: a page erase for the given time, a doubleword
+  *          for 85 us. The UART FIFO is off in usart.c, so a byte arriving
+  *          while another waits in RDR during a stall is an overrun.
+  *
+  *          The period between two Agent_Poll calls is measured on the
+  *          simulated clock and compared with the statistics of the agent,
+  *          which reads the same clock through TIM6.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "host_flash.h"
+#include "update_agent.h"
+#include "boot_request.h"
+#include "services.h"
+#include "ymodem_packet.h"
+
+/* Private variables ---------------------------------------------------------*/
+/* The peripherals and the service table of the agent, as host structures */
+static TIM_TypeDef HostTim6;
+static USART_TypeDef HostUsart;
+static Svc_TableTypeDef HostSvc;
+
+#undef TIM6
+#define TIM6                    (&HostTim6)
+#undef SVC_TABLE
+#define SVC_TABLE               ((const Svc_TableTypeDef *)&HostSvc)
+#undef __HAL_RCC_TIM6_CLK_ENABLE
+#define __HAL_RCC_TIM6_CLK_ENABLE() do { } while (0)
+#undef NVIC_SystemReset
+#define NVIC_SystemReset()      CHECK(0)
+
+#include "update_agent.c"
+
+/* Private define ------------------------------------------------------------*/
+#define SIM_CHAR_NS             ((uint64_t)10 * 1000000000U / 115200)
+#define SIM_PROGRAM_NS          ((uint64_t)85000)     /* One doubleword, typical */
+#define SIM_CRC_NS              ((uint64_t)16)        /* Per byte through the CRC unit */
+#define SIM_APP_WORK_NS         ((uint64_t)20000)     /* Application work per pass of the loop */
+#define SIM_TURNAROUND_NS       ((uint64_t)1000000)   /* Sender reaction to an ACK */
+#define SIM_LIMIT_NS            ((uint64_t)60 * 1000000000U)
+#define SIM_TX_SIZE             ((uint32_t)2048)
+#define SIM_IMAGE_SIZE          ((uint32_t)(34 * 1024 + 100))
+
+/* Layout of the check: application and staging slots */
+#define SIM_APP_OFFSET          ((uint32_t)0xC000)
+#define SIM_APP_SIZE            ((uint32_t)0x9000)
+#define SIM_STAGE_OFFSET        ((uint32_t)0x15000)
+#define SIM_STAGE_SIZE          ((uint32_t)0xA000)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  SENDER_START = 0,     /* 'U' sent, waiting for 'C' */
+  SENDER_HEADER,        /* Header block sent, waiting for ACK */
+  SENDER_WAIT_C,        /* Waiting for 'C' before the first block */
+  SENDER_DATA,          /* Data block sent, waiting for ACK */
+  SENDER_EOT,           /* EOT sent, waiting for ACK then 'C' */
+  SENDER_CLOSE,         /* Closing header sent, waiting for ACK */
+  SENDER_DONE
+} Sender_StateTypeDef;
+
+typedef struct
+{
+  uint64_t erase_ns;    /* Stall of one page erase */
+  uint64_t period_max;  /* ns, longest time between two Agent_Poll calls */
+  uint64_t period_prog; /* ns, longest of those without an erase */
+  uint64_t elapsed;     /* ns, 'U' to the image staged */
+  uint32_t periods;
+  uint32_t over_2ms;    /* Periods above 2 ms */
+} Sim_ResultTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static uint64_t SimNow;                 /* ns */
+static uint64_t aTxAt[SIM_TX_SIZE];     /* Arrival of each byte of the sender */
+static uint8_t aTxByte[SIM_TX_SIZE];
+static uint32_t TxHead;
+static uint32_t TxTail;
+static uint32_t Overruns;
+static uint32_t PagesErased;
+
+static uint8_t aImage[SIM_IMAGE_SIZE];
+static Sender_StateTypeDef SenderState;
+static uint32_t SenderBlock;            /* Block sent last, 1 is the first data block */
+static uint8_t aSenderPacket[PACKET_1K_SIZE + PACKET_OVERHEAD_SIZE + 1];
+static uint32_t SenderPacketLength;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Let time pass. Bytes reach the RXNE interrupt as they arrive,
+  *         unless the core is stalled by the Flash: then only the first
+  *         waits in RDR and the others overrun it.
+  */
+static void Sim_Run(uint64_t ns, uint32_t stalled)
+{
+  uint64_t end = SimNow + ns;
+  uint32_t held = 0;
+  uint8_t first = 0;
+
+  while ((TxTail != TxHead) && (aTxAt[TxTail % SIM_TX_SIZE] <= end))
+  {
+    if (stalled)
+    {
+      first = (held == 0) ? aTxByte[TxTail % SIM_TX_SIZE] : first;
+      held++;
+    }
+    else
+    {
+      SimNow = aTxAt[TxTail % SIM_TX_SIZE];
+      HostTim6.CNT = (uint16_t)(SimNow / 1000);
+      HostUsart.ISR = USART_ISR_RXNE_RXFNE;
+      HostUsart.RDR = aTxByte[TxTail % SIM_TX_SIZE];
+      Agent_IRQHandler();
+    }
+    TxTail++;
+  }
+  SimNow = end;
+  HostTim6.CNT = (uint16_t)(SimNow / 1000);
+  if (held != 0)
+  {
+    Overruns += held - 1;
+    HostUsart.ISR = USART_ISR_RXNE_RXFNE | ((held > 1) ? USART_ISR_ORE : 0);
+    HostUsart.RDR = first;
+    Agent_IRQHandler();
+  }
+}
+
+/**
+  * @brief  Queue bytes of the sender on the line, after its turnaround
+  */
+static void Sender_Send(const uint8_t *p_data, uint32_t length)
+{
+  uint64_t at = SimNow + SIM_TURNAROUND_NS;
+  uint32_t i;
+
+  if ((TxTail != TxHead) && (aTxAt[(TxHead - 1) % SIM_TX_SIZE] > at))
+  {
+    at = aTxAt[(TxHead - 1) % SIM_TX_SIZE];
+  }
+  CHECK((TxHead - TxTail + length) <= SIM_TX_SIZE);
+  for (i = 0; i < length; i++)
+  {
+    at += SIM_CHAR_NS;
+    aTxAt[TxHead % SIM_TX_SIZE] = at;
+    aTxByte[TxHead % SIM_TX_SIZE] = p_data[i];
+    TxHead++;
+  }
+}
+
+/**
+  * @brief  CRC16-XMODEM, running value
+  */
+static uint16_t Sim_Crc16Update(uint16_t crc, const uint8_t *p_data, uint32_t length)
+{
+  uint32_t i, bit;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t)p_data[i] << 8;
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**
+  * @brief  CRC-32 (zlib), running value, not inverted
+  */
+static uint32_t Sim_Crc32Update(uint32_t crc, const uint8_t *p_data, uint32_t length)
+{
+  uint32_t i, bit;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= p_data[i];
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320U : 0);
+    }
+  }
+  return crc;
+}
+
+/**
+  * @brief  Frame a block of the sender
+  */
+static void Sender_Frame(uint8_t number, const uint8_t *p_data, uint32_t length, uint32_t size)
+{
+  uint16_t crc;
+
+  aSenderPacket[0] = (size == PACKET_1K_SIZE) ? STX : SOH;
+  aSenderPacket[1] = number;
+  aSenderPacket[2] = (uint8_t)~number;
+  memset(&aSenderPacket[PACKET_HEADER_SIZE], 0x1A, size);
+  memcpy(&aSenderPacket[PACKET_HEADER_SIZE], p_data, length);
+  crc = Sim_Crc16Update(0, &aSenderPacket[PACKET_HEADER_SIZE], size);
+  aSenderPacket[PACKET_HEADER_SIZE + size] = (uint8_t)(crc >> 8);
+  aSenderPacket[PACKET_HEADER_SIZE + size + 1] = (uint8_t)crc;
+  SenderPacketLength = PACKET_HEADER_SIZE + size + PACKET_TRAILER_SIZE;
+}
+
+/**
+  * @brief  Frame block SenderBlock of the image
+  */
+static void Sender_Block(void)
+{
+  uint32_t offset = (SenderBlock - 1) * PACKET_1K_SIZE;
+  uint32_t length = SIM_IMAGE_SIZE - offset;
+
+  length = (length < PACKET_1K_SIZE) ? length : PACKET_1K_SIZE;
+  Sender_Frame((uint8_t)SenderBlock, &aImage[offset], length, PACKET_1K_SIZE);
+  Sender_Send(aSenderPacket, SenderPacketLength);
+}
+
+/**
+  * @brief  The sender reacts to a byte of the agent
+  */
+static void Sender_Receive(uint8_t byte)
+{
+  uint8_t header[PACKET_SIZE], eot = EOT;
+  int length;
+
+  switch (SenderState)
+  {
+    case SENDER_START:
+      if (byte == CRC16)
+      {
+        memset(header, 0, sizeof(header));
+        length = snprintf((char *)header, sizeof(header), "app.bin");
+        snprintf((char *)&header[length + 1], sizeof(header) - length - 1, "%u", (unsigned int)SIM_IMAGE_SIZE);
+        Sender_Frame(0, header, sizeof(header), PACKET_SIZE);
+        Sender_Send(aSenderPacket, SenderPacketLength);
+        SenderState = SENDER_HEADER;
+      }
+      break;
+    case SENDER_HEADER:
+      SenderState = (byte == ACK) ? SENDER_WAIT_C : SenderState;
+      break;
+    case SENDER_WAIT_C:
+      if (byte == CRC16)
+      {
+        SenderBlock = 1;
+        Sender_Block();
+        SenderState = SENDER_DATA;
+      }
+      break;
+    case SENDER_DATA:
+      if ((byte == ACK) && ((SenderBlock * PACKET_1K_SIZE) >= SIM_IMAGE_SIZE))
+      {
+        Sender_Send(&eot, 1);
+        SenderState = SENDER_EOT;
+      }
+      else if (byte == ACK)
+      {
+        SenderBlock++;
+        Sender_Block();
+      }
+      else if (byte == NAK)
+      {
+        Sender_Send(aSenderPacket, SenderPacketLength);
+      }
+      break;
+    case SENDER_EOT:
+      if (byte == CRC16)
+      {
+        memset(header, 0, sizeof(header));
+        Sender_Frame(0, header, sizeof(header), PACKET_SIZE);
+        Sender_Send(aSenderPacket, SenderPacketLength);
+        SenderState = SENDER_CLOSE;
+      }
+      break;
+    case SENDER_CLOSE:
+      SenderState = (byte == ACK) ? SENDER_DONE : SenderState;
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  Services of the bootloader, as Core/Src/services.c, stalling the
+  *         core while the Flash is busy
+  */
+static uint64_t SimEraseNs;
+
+static uint32_t Sim_FlashErase(uint32_t start, uint32_t length)
+{
+  FLASH_EraseInitTypeDef erase = { 0 };
+  uint32_t error;
+
+  if (((start % FLASH_PAGE_SIZE) != 0) || (start < (FLASH_BASE + SIM_STAGE_OFFSET)) ||
+      ((start + length) > (FLASH_BASE + SIM_STAGE_OFFSET + SIM_STAGE_SIZE)))
+  {
+    return 0;
+  }
+  erase.TypeErase = FLASH_TYPEERASE_PAGES;
+  erase.Page = (start - FLASH_BASE) / FLASH_PAGE_SIZE;
+  erase.NbPages = (length + FLASH_PAGE_SIZE - 1) / FLASH_PAGE_SIZE;
+  HAL_FLASH_Unlock();
+  CHECK(HAL_FLASHEx_Erase(&erase, &error) == HAL_OK);
+  HAL_FLASH_Lock();
+  PagesErased += erase.NbPages;
+  Sim_Run(SimEraseNs * erase.NbPages, 1);
+  return 1;
+}
+
+static uint32_t Sim_FlashWrite(uint32_t destination, const uint8_t *p_source, uint32_t length)
+{
+  uint64_t dword;
+  uint32_t i;
+
+  if (((length % 8) != 0) || ((destination % 8) != 0) || (destination < (FLASH_BASE + SIM_STAGE_OFFSET)) ||
+      ((destination + length) > (FLASH_BASE + SIM_STAGE_OFFSET + SIM_STAGE_SIZE)))
+  {
+    return 0;
+  }
+  HAL_FLASH_Unlock();
+  for (i = 0; i < length; i += 8)
+  {
+    memcpy(&dword, &p_source[i], 8);
+    CHECK(HAL_FLASH_Program(FLASH_TYPEPROGRAM_DOUBLEWORD, destination + i, dword) == HAL_OK);
+  }
+  HAL_FLASH_Lock();
+  Sim_Run(SIM_PROGRAM_NS * (length / 8), 1);
+  return memcmp((const void *)(uintptr_t)destination, p_source, length) == 0;
+}
+
+static uint16_t Sim_Crc16(uint16_t crc, const uint8_t *p_data, uint32_t length)
+{
+  Sim_Run(length * SIM_CRC_NS, 0);
+  return Sim_Crc16Update(crc, p_data, length);
+}
+
+static uint32_t Sim_Crc32(uint32_t crc, const uint8_t *p_data, uint32_t length)
+{
+  Sim_Run(length * SIM_CRC_NS, 0);
+  return Sim_Crc32Update(crc, p_data, length);
+}
+
+static uint32_t Sim_YmodemCheck(const uint8_t *p_packet)
+{
+  const uint8_t *p_data = &p_packet[PACKET_DATA_INDEX];
+  uint32_t size = (p_packet[PACKET_START_INDEX] == STX) ? PACKET_1K_SIZE : PACKET_SIZE;
+  uint16_t crc = ((uint16_t)p_data[size] << 8) | p_data[size + 1];
+
+  if (((p_packet[PACKET_START_INDEX] != STX) && (p_packet[PACKET_START_INDEX] != SOH)) ||
+      (p_packet[PACKET_NUMBER_INDEX] != (p_packet[PACKET_CNUMBER_INDEX] ^ 0xFF)))
+  {
+    return 0;
+  }
+  return (Sim_Crc16(0, p_data, size) == crc) ? size : 0;
+}
+
+/**
+  * @brief  Partition table of the bootloader with a staging slot
+  */
+static void Sim_Table(void)
+{
+  Agent_TableTypeDef table;
+
+  memset(&table, 0xFF, sizeof(table));
+  table.magic = AGENT_PART_MAGIC;
+  table.version = AGENT_PART_VERSION;
+  table.count = 2;
+  table.slot[0].offset = SIM_APP_OFFSET;
+  table.slot[0].size = SIM_APP_SIZE;
+  table.slot[0].type = AGENT_PART_TYPE_APP;
+  table.slot[0].flags = 0;
+  table.slot[0].reserved = 0;
+  table.slot[1].offset = SIM_STAGE_OFFSET;
+  table.slot[1].size = SIM_STAGE_SIZE;
+  table.slot[1].type = AGENT_PART_TYPE_STAGING;
+  table.slot[1].flags = 0;
+  table.slot[1].reserved = 0;
+  table.crc = Sim_Crc16Update(0, (const uint8_t *)table.slot, 2 * sizeof(Agent_SlotTypeDef));
+  memcpy((void *)(uintptr_t)AGENT_PART_TABLE_ADDRESS, &table, sizeof(table));
+}
+
+/**
+  * @brief  Download the image while the application loop runs
+  */
+static void Sim_Download(uint64_t erase_ns, Sim_ResultTypeDef *p_result)
+{
+  static UART_HandleTypeDef huart;
+  const Agent_StatsTypeDef *p_stats;
+  const uint32_t *p_header;
+  uint64_t last = 0, period, start;
+  uint32_t erased, crc;
+  uint8_t key = AGENT_START_KEY;
+
+  memset(p_result, 0, sizeof(*p_result));
+  p_result->erase_ns = erase_ns;
+  SimEraseNs = erase_ns;
+  HostFlash_Reset();
+  Sim_Table();
+  SimNow = 0;
+  TxHead = TxTail = 0;
+  Overruns = 0;
+  PagesErased = 0;
+  SenderState = SENDER_START;
+  huart.Instance = &HostUsart;
+  Agent_Init(&huart);
+
+  Sender_Send(&key, 1);
+  start = SimNow;
+  while ((SimNow < SIM_LIMIT_NS) && (Agent_GetState() != AGENT_STAGED) && (Agent_GetState() != AGENT_ERROR))
+  {
+    Sim_Run(SIM_APP_WORK_NS, 0);
+    if ((Agent_GetState() == AGENT_RECEIVING) || (Agent_GetState() == AGENT_CHECKING))
+    {
+      period = SimNow - last;
+      p_result->period_max = (period > p_result->period_max) ? period : p_result->period_max;
+      p_result->over_2ms += (period > 2000000U);
+      p_result->periods++;
+    }
+    last = SimNow;
+    erased = PagesErased;
+    Agent_Poll();
+    if (PagesErased == erased)
+    {
+      period = SimNow - last + SIM_APP_WORK_NS;
+      p_result->period_prog = (period > p_result->period_prog) ? period : p_result->period_prog;
+    }
+  }
+  p_result->elapsed = SimNow - start;
+
+  /* Staged: the image, then the header with its magic last */
+  CHECK(Agent_GetState() == AGENT_STAGED);
+  CHECK(SenderState == SENDER_DONE);
+  CHECK(memcmp((const void *)(uintptr_t)(FLASH_BASE + SIM_STAGE_OFFSET + AGENT_STAGE_IMAGE_OFFSET),
+               aImage, SIM_IMAGE_SIZE) == 0);
+  crc = Sim_Crc32Update(0xFFFFFFFFU, aImage, SIM_IMAGE_SIZE) ^ 0xFFFFFFFFU;
+  p_header = (const uint32_t *)(uintptr_t)(FLASH_BASE + SIM_STAGE_OFFSET);
+  CHECK((p_header[0] == SIM_IMAGE_SIZE) && (p_header[1] == crc) && (p_header[3] == AGENT_STAGE_MAGIC));
+  CHECK(Overruns == 0);
+  CHECK(HostFlashStats.refused == 0);
+
+  /* The agent measures the same periods through TIM6 */
+  p_stats = Agent_GetStats();
+  CHECK(p_stats->rx_errors == 0);
+  CHECK(p_stats->bytes == SIM_IMAGE_SIZE);
+  CHECK((p_stats->loop_max + 1) >= (p_result->period_max / 1000));
+  CHECK(p_stats->loop_max <= ((p_result->period_max / 1000) + 1));
+}
+
+/**
+  * @brief  Print one line of results and check the bounds
+  */
+static void Sim_Report(const Sim_ResultTypeDef *p_result)
+{
+  /* One page erase, the stall itself, plus the loop's own work */
+  uint64_t erase_bound = p_result->erase_ns + SIM_APP_WORK_NS + 500000U;
+  /* One slice: AGENT_SLICE_BYTES of doublewords */
+  uint64_t slice_bound = (AGENT_SLICE_BYTES / 8) * SIM_PROGRAM_NS + SIM_APP_WORK_NS + 500000U;
+
+  printf("  %10.1f  %8.2f  %13.2f  %6u  %6u  %8.2f  %4.1f\n", (double)p_result->erase_ns / 1e6,
+         (double)p_result->period_max / 1e6, (double)p_result->period_prog / 1e6,
+         (unsigned int)p_result->periods, (unsigned int)p_result->over_2ms, (double)p_result->elapsed / 1e9,
+         (double)SIM_IMAGE_SIZE / ((double)p_result->elapsed / 1e9) / 1000.0);
+  CHECK(p_result->period_max <= erase_bound);
+  CHECK(p_result->period_prog <= slice_bound);
+  /* Only the erases, one per page of the slot used, exceed 2 ms */
+  CHECK(p_result->over_2ms <= ((AGENT_STAGE_IMAGE_OFFSET + SIM_IMAGE_SIZE) / FLASH_PAGE_SIZE + 1));
+}
+
+/* Public functions ---------------------------------------------------------*/
+uint32_t SystemCoreClock = 64000000U;
+
+void Boot_Request(uint32_t request)
+{
+  CHECK(0);
+}
+
+uint32_t HAL_GetTick(void)
+{
+  return (uint32_t)(SimNow / 1000000U);
+}
+
+/**
+  * @brief  The agent sends with the core waiting on TXE, interrupts run
+  */
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef *huart, uint8_t *pData, uint16_t Size, uint32_t Timeout)
+{
+  uint16_t i;
+
+  for (i = 0; i < Size; i++)
+  {
+    Sim_Run(SIM_CHAR_NS, 0);
+    Sender_Receive(pData[i]);
+  }
+  return HAL_OK;
+}
+
+int main(void)
+{
+  static const uint64_t aErase[] = { 22000000U, 40000000U };  /* Typical and maximum */
+  Sim_ResultTypeDef result;
+  uint32_t i, seed = 0xA6E27U;
+
+  HostSvc.magic = SVC_MAGIC;
+  HostSvc.version = SVC_VERSION;
+  HostSvc.count = SVC_COUNT;
+  HostSvc.FlashErase = Sim_FlashErase;
+  HostSvc.FlashWrite = Sim_FlashWrite;
+  HostSvc.Crc16 = Sim_Crc16;
+  HostSvc.Crc32 = Sim_Crc32;
+  HostSvc.YmodemCheck = Sim_YmodemCheck;
+  for (i = 0; i < SIM_IMAGE_SIZE; i++)
+  {
+    aImage[i] = (uint8_t)Host_Random(&seed);
+  }
+
+  printf("%u bytes staged at 115200 baud, %u us of application work per pass\n",
+         (unsigned int)SIM_IMAGE_SIZE, (unsigned int)(SIM_APP_WORK_NS / 1000));
+  printf("  erase (ms)  max (ms)  no erase (ms)  passes  > 2 ms  time (s)  kB/s\n");
+  for (i = 0; i < (sizeof(aErase) / sizeof(aErase[0])); i++)
+  {
+    Sim_Download(aErase[i], &result);
+    Sim_Report(&result);
+  }
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
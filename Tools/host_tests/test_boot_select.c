@@ -0,0 +1,108 @@
+/**
+  ******************************************************************************
+  * @file    test_boot_select.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   The boot decision of Core/Src/boot_select.c, in the order main
+  *          takes it, over every combination of boot request, key level,
+  *          first word of the application slot and signature result.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "boot_select.h"
+#include "boot_time.h"
+#include "main.h"
+
+/* Private variables ---------------------------------------------------------*/
+static uint32_t VerifyResult;
+static uint32_t VerifyCalls;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Verify_Boot of the check
+  */
+static uint32_t Boot_Verify(void)
+{
+  VerifyCalls++;
+  return VerifyResult;
+}
+
+/**
+  * @brief  The decision as main takes it: the slot only when the early
+  *         inputs leave the application to start
+  */
+static uint32_t Boot_Decide(uint32_t request, GPIO_PinState key, uint32_t stack_pointer)
+{
+  uint32_t inputs = BootSelect_Early(request, key);
+
+  if (inputs == 0)
+  {
+    inputs |= BootSelect_Image(stack_pointer, Boot_Verify);
+  }
+  return inputs;
+}
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  static const uint32_t aRequests[] =
+  {
+    0, BOOT_REQUEST_MENU, BOOT_REQUEST_DOWNLOAD, 0xFFFFFFFFU, BOOT_REQUEST_MENU ^ 1U, 0x42504149
+  };
+  /* First words of the slot, and whether each is a stack pointer in the RAM */
+  static const uint32_t aStacks[][2] =
+  {
+    { 0x20009000, 1 }, { 0x20000000, 1 }, { 0x2001FFFC, 1 }, { 0xFFFFFFFFU, 0 },
+    { 0x00000000, 0 }, { 0x20020000, 0 }, { 0x10009000, 0 }, { 0x20040000, 0 },
+    { 0x0800C000, 0 }
+  };
+  static const GPIO_PinState aKeys[] = { GPIO_PIN_SET, GPIO_PIN_RESET };
+  uint32_t r, k, s, v, inputs, expected, requested, started = 0, cases = 0;
+
+  for (r = 0; r < (sizeof(aRequests) / sizeof(aRequests[0])); r++)
+  {
+    requested = (aRequests[r] == BOOT_REQUEST_MENU) || (aRequests[r] == BOOT_REQUEST_DOWNLOAD);
+    for (k = 0; k < (sizeof(aKeys) / sizeof(aKeys[0])); k++)
+    {
+      for (s = 0; s < (sizeof(aStacks) / sizeof(aStacks[0])); s++)
+      {
+        for (v = 0; v < 2; v++)
+        {
+          /* One input only, the first in the order of main */
+          if (requested)
+          {
+            expected = BOOT_INPUT_REQUEST;
+          }
+          else if (aKeys[k] == GPIO_PIN_RESET)
+          {
+            expected = BOOT_INPUT_KEY;
+          }
+          else if (!aStacks[s][1])
+          {
+            expected = BOOT_INPUT_NO_IMAGE;
+          }
+          else
+          {
+            expected = v ? 0 : BOOT_INPUT_UNVERIFIED;
+          }
+          VerifyResult = v;
+          VerifyCalls = 0;
+          inputs = Boot_Decide(aRequests[r], aKeys[k], aStacks[s][0]);
+          CHECK(inputs == expected);
+          /* The signature is checked only for an image that would start */
+          CHECK(VerifyCalls == ((!requested && (aKeys[k] == GPIO_PIN_SET) && aStacks[s][1]) ? 1U : 0U));
+          started += (inputs == 0);
+          cases++;
+        }
+      }
+    }
+  }
+  printf("%u combinations, the application started in %u: ok\n", (unsigned int)cases, (unsigned int)started);
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,320 @@
+/**
+  ******************************************************************************
+  * @file    test_chacha20.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   chacha20.c against the RFC 8439 vectors and a plain transcription
+  *          of the RFC block function, with the data fed in pieces of every
+  *          size from unaligned addresses. Then the download path: an
+  *          encrypted image decrypted packet by packet in place and streamed
+  *          to the Flash model by flash_if.c must read back as the plain
+  *          image. Built with HOST_BENCH, also times the key stream.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "host_flash.h"
+#include "chacha20.h"
+#include "flash_if.h"
+#include "partition.h"
+#include "ymodem.h"
+
+/* Private define ------------------------------------------------------------*/
+#define CHACHA_STREAM_SIZE      ((uint32_t)4099)
+#define CHACHA_IMAGE_SIZE       ((uint32_t)(37 * 1024 + 13))
+#define CHACHA_BENCH_SIZE       ((uint32_t)(1024 * 1024))
+#define CHACHA_BENCH_ROUNDS     ((uint32_t)16)
+
+/* Private macro -------------------------------------------------------------*/
+#define ROTL(x, n)              (((x) << (n)) | ((x) >> (32 - (n))))
+
+/* Private variables ---------------------------------------------------------*/
+/* Key 00..1f of RFC 8439 sections 2.3.2 and 2.4.2, also the development key
+   of ymodem.c */
+static uint8_t aKey[CHACHA20_KEY_SIZE];
+static const char aSunscreen[] =
+  "Ladies and Gentlemen of the class of '99: If I could offer you only one tip "
+  "for the future, sunscreen would be it.";
+static uint8_t aPlain[CHACHA_IMAGE_SIZE];
+static uint8_t aCipher[CHACHA_IMAGE_SIZE];
+static uint8_t aExpected[CHACHA_IMAGE_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  RFC 8439 section 2.3, written as the text reads
+  */
+static void Chacha_Reference(uint8_t *p_out, const uint8_t *p_key, uint32_t counter, const uint8_t *p_nonce)
+{
+  static const uint8_t aQuarters[8][4] =
+  {
+    { 0, 4, 8, 12 }, { 1, 5, 9, 13 }, { 2, 6, 10, 14 }, { 3, 7, 11, 15 },
+    { 0, 5, 10, 15 }, { 1, 6, 11, 12 }, { 2, 7, 8, 13 }, { 3, 4, 9, 14 }
+  };
+  uint32_t s[16], x[16], i, r, q, *a, *b, *c, *d;
+
+  s[0] = 0x61707865;
+  s[1] = 0x3320646e;
+  s[2] = 0x79622d32;
+  s[3] = 0x6b206574;
+  for (i = 0; i < 8; i++)
+  {
+    memcpy(&s[4 + i], &p_key[4 * i], 4);
+  }
+  s[12] = counter;
+  for (i = 0; i < 3; i++)
+  {
+    memcpy(&s[13 + i], &p_nonce[4 * i], 4);
+  }
+  memcpy(x, s, sizeof(x));
+  for (r = 0; r < 20; r++)
+  {
+    for (q = (r & 1) * 4; q < ((r & 1) * 4 + 4); q++)
+    {
+      a = &x[aQuarters[q][0]];
+      b = &x[aQuarters[q][1]];
+      c = &x[aQuarters[q][2]];
+      d = &x[aQuarters[q][3]];
+      *a += *b; *d ^= *a; *d = ROTL(*d, 16);
+      *c += *d; *b ^= *c; *b = ROTL(*b, 12);
+      *a += *b; *d ^= *a; *d = ROTL(*d, 8);
+      *c += *d; *b ^= *c; *b = ROTL(*b, 7);
+    }
+  }
+  for (i = 0; i < 16; i++)
+  {
+    x[i] += s[i];
+  }
+  /* The host is little endian, as the RFC serialization */
+  memcpy(p_out, x, 64);
+}
+
+/**
+  * @brief  Encrypt with the reference, from block counter
+  */
+static void Chacha_ReferenceXor(uint8_t *p_out, const uint8_t *p_in, uint32_t length,
+                                const uint8_t *p_nonce, uint32_t counter)
+{
+  uint8_t block[64];
+  uint32_t i;
+
+  for (i = 0; i < length; i++)
+  {
+    if ((i % 64) == 0)
+    {
+      Chacha_Reference(block, aKey, counter + i / 64, p_nonce);
+    }
+    p_out[i] = p_in[i] ^ block[i % 64];
+  }
+}
+
+/**
+  * @brief  Chacha20_Xor over a buffer copied at p_work, in pieces of chunk
+  *         bytes, or of random sizes below 150 if chunk is 0
+  */
+static void Chacha_Chunked(uint8_t *p_work, const uint8_t *p_in, uint32_t length, const uint8_t *p_nonce,
+                           uint32_t counter, uint32_t chunk, uint32_t *p_seed)
+{
+  Chacha20_CtxTypeDef ctx;
+  uint32_t offset, size;
+
+  memcpy(p_work, p_in, length);
+  Chacha20_Init(&ctx, aKey, p_nonce, counter);
+  Chacha20_Xor(&ctx, p_work, 0);
+  for (offset = 0; offset < length; offset += size)
+  {
+    size = (chunk != 0) ? chunk : (Host_Random(p_seed) % 150);
+    size = (size < (length - offset)) ? size : (length - offset);
+    Chacha20_Xor(&ctx, &p_work[offset], size);
+  }
+}
+
+/**
+  * @brief  Download an encrypted image the way Ymodem_Receive does: each
+  *         packet decrypted in place, then streamed to the Flash
+  * @param  p_sizes: packet sizes to cycle through, 0 terminated
+  * @param  stop: offset where the first session drops, page aligned, or
+  *         CHACHA_IMAGE_SIZE. The second session resends the image from the
+  *         start, the part already programmed is only compared; packets of
+  *         128 and 1K bytes never straddle the offset.
+  */
+static void Chacha_Download(const uint8_t *p_nonce, const uint32_t *p_sizes, uint32_t stop)
+{
+  static uint32_t aPacket[PACKET_1K_SIZE / 4];
+  Chacha20_CtxTypeDef ctx;
+  uint32_t offset, size, n, resume = 0, start = Part_Address(PART_TYPE_APP);
+  const uint8_t *p_flash = (const uint8_t *)(uintptr_t)start;
+
+  HostFlash_Reset();
+  CHECK(FLASH_If_Erase(start) == FLASHIF_OK);
+  do
+  {
+    Chacha20_Init(&ctx, aKey, p_nonce, 0);
+    FLASH_If_StreamOpen(start + resume);
+    for (offset = 0, n = 0; offset < stop; offset += size)
+    {
+      size = p_sizes[n];
+      n = (p_sizes[n + 1] != 0) ? (n + 1) : 0;
+      size = (size < (stop - offset)) ? size : (stop - offset);
+      memcpy(aPacket, &aCipher[offset], size);
+      Chacha20_Xor(&ctx, (uint8_t *)aPacket, size);
+      if (offset < resume)
+      {
+        CHECK(memcmp(&p_flash[offset], aPacket, size) == 0);
+      }
+      else
+      {
+        CHECK(FLASH_If_StreamWrite((const uint8_t *)aPacket, size) == FLASHIF_OK);
+      }
+    }
+    /* The rows filled before the link dropped are programmed */
+    CHECK(FLASH_If_StreamFlush() == FLASHIF_OK);
+    resume = stop;
+    stop = CHACHA_IMAGE_SIZE;
+  } while (resume < CHACHA_IMAGE_SIZE);
+  CHECK(FLASH_If_StreamClose() == FLASHIF_OK);
+  CHECK(memcmp(p_flash, aPlain, CHACHA_IMAGE_SIZE) == 0);
+  CHECK(FLASH_If_IsErased((start + CHACHA_IMAGE_SIZE + 7) & ~7U, FLASH_PAGE_SIZE));
+  CHECK(FLASH_If_GetImageSize(start, Part_Size(PART_TYPE_APP)) == ((CHACHA_IMAGE_SIZE + 7) & ~7U));
+  CHECK(HostFlashStats.refused == 0);
+}
+
+#ifdef HOST_BENCH
+/**
+  * @brief  Time the key stream over CHACHA_BENCH_SIZE bytes in 1K packets
+  */
+static void Chacha_Bench(void)
+{
+  static uint8_t aBench[CHACHA_BENCH_SIZE];
+  Chacha20_CtxTypeDef ctx;
+  uint8_t nonce[CHACHA20_NONCE_SIZE] = { 0 };
+  uint64_t ns, cycles;
+  uint32_t i, offset;
+
+  Chacha20_Init(&ctx, aKey, nonce, 0);
+  ns = Host_Nanoseconds();
+  cycles = Host_Cycles();
+  for (i = 0; i < CHACHA_BENCH_ROUNDS; i++)
+  {
+    for (offset = 0; offset < CHACHA_BENCH_SIZE; offset += PACKET_1K_SIZE)
+    {
+      Chacha20_Xor(&ctx, &aBench[offset], PACKET_1K_SIZE);
+    }
+  }
+  cycles = Host_Cycles() - cycles;
+  ns = Host_Nanoseconds() - ns;
+  printf("bench: %.1f MB/s, %.2f ns/byte, %.1f host cycles/byte\n",
+         (double)CHACHA_BENCH_SIZE * CHACHA_BENCH_ROUNDS / ((double)ns / 1e9) / 1e6,
+         (double)ns / CHACHA_BENCH_SIZE / CHACHA_BENCH_ROUNDS,
+         (double)cycles / CHACHA_BENCH_SIZE / CHACHA_BENCH_ROUNDS);
+}
+#endif /* HOST_BENCH */
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  static const uint32_t aYmodem[] = { PACKET_1K_SIZE, 0 };
+  static const uint32_t aMixed[] = { PACKET_1K_SIZE, PACKET_SIZE, PACKET_SIZE, PACKET_1K_SIZE, 0 };
+  static const uint32_t aOdd[] = { 1, 255, 257, 7, 1000, 3, 64, 0 };
+  static uint8_t aWork[CHACHA_STREAM_SIZE + 3];
+  uint8_t nonce[CHACHA20_NONCE_SIZE], block[64], expected[128];
+  Chacha20_CtxTypeDef ctx;
+  uint32_t i, align, chunk, seed = 0xC4AC4A20U;
+
+  for (i = 0; i < CHACHA20_KEY_SIZE; i++)
+  {
+    aKey[i] = (uint8_t)i;
+  }
+
+  printf("RFC 8439 vectors\n");
+  /* 2.3.2: the block function, counter 1 */
+  Host_Hex(nonce, "000000090000004a00000000");
+  Host_Hex(expected, "10f1e7e4d13b5915500fdd1fa32071c4c7d1f4c733c068030422aa9ac3d46c4e"
+                     "d2826446079faa0914c2d705d98b02a2b5129cd1de164eb9cbd083e8a2503c4e");
+  memset(block, 0, sizeof(block));
+  Chacha20_Init(&ctx, aKey, nonce, 1);
+  Chacha20_Xor(&ctx, block, sizeof(block));
+  CHECK(memcmp(block, expected, 64) == 0);
+  Chacha_Reference(block, aKey, 1, nonce);
+  CHECK(memcmp(block, expected, 64) == 0);
+
+  /* 2.4.2: the sunscreen text, counter 1, in pieces of every size from
+     every alignment */
+  Host_Hex(nonce, "000000000000004a00000000");
+  Host_Hex(expected, "6e2e359a2568f98041ba0728dd0d6981e97e7aec1d4360c20a27afccfd9fae0b"
+                     "f91b65c5524733ab8f593dabcd62b3571639d624e65152ab8f530c359f0861d8"
+                     "07ca0dbf500d6a6156a38e088a22b65e52bc514d16ccf806818ce91ab7793736"
+                     "5af90bbf74a35be6b40b8eedf2785e42874d");
+  for (align = 0; align < 4; align++)
+  {
+    for (chunk = 1; chunk <= (sizeof(aSunscreen) - 1); chunk++)
+    {
+      Chacha_Chunked(&aWork[align], (const uint8_t *)aSunscreen, sizeof(aSunscreen) - 1, nonce, 1, chunk, &seed);
+      CHECK(memcmp(&aWork[align], expected, sizeof(aSunscreen) - 1) == 0);
+    }
+  }
+
+  /* A.1 test vector 1: the all-zero key and nonce */
+  memset(aKey, 0, sizeof(aKey));
+  memset(nonce, 0, sizeof(nonce));
+  memset(block, 0, sizeof(block));
+  Host_Hex(expected, "76b8e0ada0f13d90405d6ae55386bd28bdd219b8a08ded1aa836efcc8b770dc7"
+                     "da41597c5157488d7724e03fb8d84a376a43b8f41518a11cc387b669b2ee6586");
+  Chacha20_Init(&ctx, aKey, nonce, 0);
+  Chacha20_Xor(&ctx, block, sizeof(block));
+  CHECK(memcmp(block, expected, 64) == 0);
+  printf("  2.3.2, 2.4.2 in %u piece sizes from 4 alignments, A.1 #1: ok\n", (unsigned int)(sizeof(aSunscreen) - 1));
+
+  printf("Long streams against the RFC text\n");
+  for (i = 0; i < CHACHA20_KEY_SIZE; i++)
+  {
+    aKey[i] = (uint8_t)Host_Random(&seed);
+  }
+  for (i = 0; i < CHACHA_STREAM_SIZE; i++)
+  {
+    aPlain[i] = (uint8_t)Host_Random(&seed);
+  }
+  for (i = 0; i < 64; i++)
+  {
+    memcpy(nonce, &aPlain[i], sizeof(nonce));
+    Chacha_ReferenceXor(aExpected, aPlain, CHACHA_STREAM_SIZE, nonce, i * 1000);
+    Chacha_Chunked(&aWork[i & 3], aPlain, CHACHA_STREAM_SIZE, nonce, i * 1000, 0, &seed);
+    CHECK(memcmp(&aWork[i & 3], aExpected, CHACHA_STREAM_SIZE) == 0);
+  }
+  printf("  64 streams of %u bytes in random pieces: ok\n", (unsigned int)CHACHA_STREAM_SIZE);
+
+  printf("Decrypt then stream to Flash\n");
+  HostFlash_Reset();
+  Part_Init();
+  for (i = 0; i < CHACHA20_KEY_SIZE; i++)
+  {
+    aKey[i] = (uint8_t)i;
+  }
+  Host_Hex(nonce, "a0a1a2a3a4a5a6a7a8a9aaab");
+  for (i = 0; i < CHACHA_IMAGE_SIZE; i++)
+  {
+    aPlain[i] = (uint8_t)Host_Random(&seed);
+  }
+  Chacha_ReferenceXor(aCipher, aPlain, CHACHA_IMAGE_SIZE, nonce, 0);
+  Chacha_Download(nonce, aYmodem, CHACHA_IMAGE_SIZE);
+  /* Every full row goes with one fast programming operation */
+  CHECK(HostFlashStats.fast_rows == (CHACHA_IMAGE_SIZE / FLASH_ROW_SIZE));
+  printf("  %u bytes in 1K packets: %u fast rows, %u doublewords\n", (unsigned int)CHACHA_IMAGE_SIZE,
+         (unsigned int)HostFlashStats.fast_rows, (unsigned int)HostFlashStats.doublewords);
+  Chacha_Download(nonce, aMixed, CHACHA_IMAGE_SIZE);
+  CHECK(HostFlashStats.fast_rows == (CHACHA_IMAGE_SIZE / FLASH_ROW_SIZE));
+  Chacha_Download(nonce, aOdd, CHACHA_IMAGE_SIZE);
+  printf("  128 and 1K packets, odd packet sizes: ok\n");
+  Chacha_Download(nonce, aYmodem, 9 * FLASH_PAGE_SIZE);
+  Chacha_Download(nonce, aMixed, 5 * FLASH_PAGE_SIZE);
+  printf("  resumed at a page boundary, the programmed part compared: ok\n");
+
+#ifdef HOST_BENCH
+  Chacha_Bench();
+#endif /* HOST_BENCH */
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,378 @@
+/**
+  ******************************************************************************
+  * @file    test_ed25519.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   Ed25519_Verify of ed25519.c against the RFC 8032 section 7.1
+  *          vectors, a 1K message signed with the RFC 8032 section 6
+  *          reference code, and forgeries that must be refused. Sc_Reduce is
+  *          checked against a bitwise long division, under UBSan.
+  *
+  *          The check build counts the field operations of one verification
+  *          (-finstrument-functions) and turns them into a Cortex-M0+ cycle
+  *          estimate; the bench build times the verification on the host.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "ed25519.c"
+
+/* Private define ------------------------------------------------------------*/
+#define ED_MESSAGE_SEED         ((uint32_t)0xED25519)
+#define ED_REDUCE_ROUNDS        ((uint32_t)20000)
+#define ED_BENCH_ROUNDS         ((uint32_t)200)
+#define ED_FORGED_BITS          ((uint32_t)32)
+
+/* Cortex-M0+ cycles of each operation, counted from the loops at zero wait
+   state: 2-cycle loads, 1-cycle MULS, about 12 cycles per limb product
+   with its 64-bit accumulation and loop control, plus the fold and carry */
+#define M0_CYCLES_MUL           ((uint32_t)3900)
+#define M0_CYCLES_SQ            ((uint32_t)2600)
+#define M0_CYCLES_ADD           ((uint32_t)450)
+#define M0_CYCLES_PACK          ((uint32_t)900)
+#define M0_CORE_CLOCK_MHZ       ((uint32_t)64)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  const char *p_name;
+  const char *p_key;
+  const char *p_message;
+  const char *p_signature;
+} Ed_VectorTypeDef;
+
+typedef struct
+{
+  uint32_t mul;
+  uint32_t sq;
+  uint32_t add;         /* Fe_Add and Fe_Sub */
+  uint32_t pack;
+} Ed_CountTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static const Ed_VectorTypeDef aVectors[] =
+{
+  { "TEST 1",
+    "d75a980182b10ab7d54bfed3c964073a0ee172f3daa62325af021a68f707511a",
+    "",
+    "e5564300c360ac729086e2cc806e828a84877f1eb8e5d974d873e06522490155"
+    "5fb8821590a33bacc61e39701cf9b46bd25bf5f0595bbe24655141438e7a100b" },
+  { "TEST 2",
+    "3d4017c3e843895a92b70aa74d1b7ebc9c982ccf2ec4968cc0cd55f12af4660c",
+    "72",
+    "92a009a9f0d4cab8720e820b5f642540a2b27b5416503f8fb3762223ebdb69da"
+    "085ac1e43e15996e458f3613d0f11d8c387b2eaeb4302aeeb00d291612bb0c00" },
+  { "TEST 3",
+    "fc51cd8e6218a1a38da47ed00230f0580816ed13ba3303ac5deb911548908025",
+    "af82",
+    "6291d657deec24024827e69c3abe01a30ce548a284743a445e3680d7db5ac3ac"
+    "18ff9b538d16f290ae67f760984dc6594a7c15e9716ed28dc027beceea1ec40a" },
+  { "SHA(abc)",
+    "ec172b93ad5e563bf4932c70e1245034c35467ef2efd4d64ebf819683467e2bf",
+    "ddaf35a193617abacc417349ae20413112e6fa4e89a97ea20a9eeee64b55d39a"
+    "2192992a274fc1a836ba3c23a3feebbd454d4423643ce80e2a9ac94fa54ca49f",
+    "dc2a4459e7369633a52b1bf277839a00201009a3efbf3ecb69bea2186c26b589"
+    "09351fc9ac90b3ecfdfbc7c66431e0303dca179c138ac17ad9bef1177331a704" },
+};
+
+/* The first 1024 bytes of the Host_Random stream from ED_MESSAGE_SEED,
+   signed with the TEST 3 secret key by the RFC 8032 section 6 code */
+static const char aLongSignature[] =
+  "a472bf03467cb44cc728c02983f285bd8b0c1975c45341a7061c563ed383e0e4"
+  "61e71ff9b96504fdaa19fd2f85cfe9f3e2152456f4d81869da3ab18821eca901";
+
+/* 64-byte inputs of Sc_Reduce and their residues modulo L, from Python */
+static const char *const aReduce[][2] =
+{
+  { "0000000000000000000000000000000000000000000000000000000000000000"
+    "0000000000000000000000000000000000000000000000000000000000000000",
+    "0000000000000000000000000000000000000000000000000000000000000000" },
+  { "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff"
+    "ffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff",
+    "000f9c44e31106a447938568a71b0ed065bef517d273ecce3d9a307c1b419903" },
+  { "edd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010"
+    "0000000000000000000000000000000000000000000000000000000000000000",
+    "0000000000000000000000000000000000000000000000000000000000000000" },
+  { "ecd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010"
+    "0000000000000000000000000000000000000000000000000000000000000000",
+    "ecd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010" },
+  { "0000000000000000000000000000000000000000000000000000000000000000"
+    "0100000000000000000000000000000000000000000000000000000000000000",
+    "1d95988d7431ecd670cf7d73f45befc6feffffffffffffffffffffffffffff0f" },
+  { "ecd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010"
+    "689faee7d21893c0b2e6bc17f5cef7a600000000000000000000000000000080",
+    "ecd3f55c1a631258d69cf7a2def9de1400000000000000000000000000000010" },
+};
+
+static Ed_CountTypeDef Counts;
+static uint8_t aLongMessage[1024];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Count the field operations, called on entry of every function
+  *         when built with -finstrument-functions
+  */
+__attribute__((no_instrument_function))
+void __cyg_profile_func_enter(void *p_function, void *p_caller)
+{
+  (void)p_caller;
+  if (p_function == (void *)Fe_Mul)
+  {
+    Counts.mul++;
+  }
+  else if (p_function == (void *)Fe_Sq)
+  {
+    Counts.sq++;
+  }
+  else if ((p_function == (void *)Fe_Add) || (p_function == (void *)Fe_Sub))
+  {
+    Counts.add++;
+  }
+  else if (p_function == (void *)Fe_Pack)
+  {
+    Counts.pack++;
+  }
+}
+
+__attribute__((no_instrument_function))
+void __cyg_profile_func_exit(void *p_function, void *p_caller)
+{
+  (void)p_function;
+  (void)p_caller;
+}
+
+/**
+  * @brief  x mod L by bitwise long division, the reference for Sc_Reduce
+  */
+static void Sc_Reference(uint8_t *p_out, const uint8_t *p_x)
+{
+  uint8_t r[33];
+  uint32_t i, j, t, borrow;
+  int32_t bit;
+
+  memset(r, 0, sizeof(r));
+  for (bit = 511; bit >= 0; bit--)
+  {
+    /* r = 2r + bit, below 2L */
+    t = (p_x[bit >> 3] >> (bit & 7)) & 1;
+    for (i = 0; i < 33; i++)
+    {
+      t |= (uint32_t)r[i] << 1;
+      r[i] = (uint8_t)t;
+      t >>= 8;
+    }
+    /* r >= L: subtract it */
+    for (j = 33; j-- > 0;)
+    {
+      t = (j < 32) ? aOrder[j] : 0;
+      if (r[j] != t)
+      {
+        break;
+      }
+    }
+    if ((j == (uint32_t)-1) || (r[j] > ((j < 32) ? aOrder[j] : 0)))
+    {
+      borrow = 0;
+      for (i = 0; i < 33; i++)
+      {
+        t = (uint32_t)r[i] - ((i < 32) ? aOrder[i] : 0) - borrow;
+        r[i] = (uint8_t)t;
+        borrow = (t >> 8) & 1;
+      }
+    }
+  }
+  memcpy(p_out, r, 32);
+}
+
+/**
+  * @brief  Sc_Reduce of 64 bytes, as Ed25519_Verify calls it
+  */
+static void Sc_Check(const uint8_t *p_x, uint8_t *p_out)
+{
+  int64_t x[64];
+  uint32_t i;
+
+  for (i = 0; i < 64; i++)
+  {
+    x[i] = p_x[i];
+  }
+  Sc_Reduce(p_out, x);
+}
+
+/**
+  * @brief  Verify a signature given in hexadecimal
+  */
+static uint32_t Ed_Verify(const char *p_key, const uint8_t *p_message, uint32_t length, const char *p_signature)
+{
+  uint8_t key[ED25519_PUBLIC_KEY_SIZE], signature[ED25519_SIGNATURE_SIZE];
+
+  CHECK(Host_Hex(key, p_key) == ED25519_PUBLIC_KEY_SIZE);
+  CHECK(Host_Hex(signature, p_signature) == ED25519_SIGNATURE_SIZE);
+  return Ed25519_Verify(signature, key, p_message, length);
+}
+
+/**
+  * @brief  Flip random bits of the signature and of the message: each
+  *         forgery must be refused
+  * @retval Number of forgeries
+  */
+static uint32_t Ed_Forgeries(const char *p_key, const uint8_t *p_message, uint32_t length, const char *p_signature)
+{
+  static uint8_t aForged[1024];
+  uint8_t key[ED25519_PUBLIC_KEY_SIZE], signature[ED25519_SIGNATURE_SIZE];
+  uint32_t i, flip, forgeries = 0, seed = 0xBAD5EED;
+
+  Host_Hex(key, p_key);
+  Host_Hex(signature, p_signature);
+  /* The top bits of R and S, then random ones */
+  for (i = 0; i < ED_FORGED_BITS; i++)
+  {
+    flip = (i == 0) ? 255 : ((i == 1) ? 511 : (Host_Random(&seed) % (ED25519_SIGNATURE_SIZE * 8)));
+    signature[flip >> 3] ^= (uint8_t)(1U << (flip & 7));
+    CHECK(!Ed25519_Verify(signature, key, p_message, length));
+    signature[flip >> 3] ^= (uint8_t)(1U << (flip & 7));
+    forgeries++;
+  }
+  for (i = 0; (length != 0) && (i < ED_FORGED_BITS); i++)
+  {
+    flip = Host_Random(&seed) % (length * 8);
+    memcpy(aForged, p_message, length);
+    aForged[flip >> 3] ^= (uint8_t)(1U << (flip & 7));
+    CHECK(!Ed25519_Verify(signature, key, aForged, length));
+    forgeries++;
+  }
+  /* Same message, shorter */
+  if (length != 0)
+  {
+    CHECK(!Ed25519_Verify(signature, key, p_message, length - 1));
+    forgeries++;
+  }
+  return forgeries;
+}
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  uint8_t message[64], signature[ED25519_SIGNATURE_SIZE], key[ED25519_PUBLIC_KEY_SIZE];
+  uint8_t x[64], out[32], expected[32];
+  uint32_t i, j, length, seed;
+  int64_t borrow;
+
+  printf("RFC 8032 vectors\n");
+  for (i = 0; i < (sizeof(aVectors) / sizeof(aVectors[0])); i++)
+  {
+    length = Host_Hex(message, aVectors[i].p_message);
+    CHECK(Ed_Verify(aVectors[i].p_key, message, length, aVectors[i].p_signature));
+    printf("  %-10s accepted, %u forgeries refused\n", aVectors[i].p_name,
+           (unsigned int)Ed_Forgeries(aVectors[i].p_key, message, length, aVectors[i].p_signature));
+  }
+  seed = ED_MESSAGE_SEED;
+  for (i = 0; i < sizeof(aLongMessage); i++)
+  {
+    aLongMessage[i] = (uint8_t)Host_Random(&seed);
+  }
+  CHECK(Ed_Verify(aVectors[2].p_key, aLongMessage, sizeof(aLongMessage), aLongSignature));
+  printf("  1K message accepted, %u forgeries refused\n",
+         (unsigned int)Ed_Forgeries(aVectors[2].p_key, aLongMessage, sizeof(aLongMessage), aLongSignature));
+
+  printf("Malleability and key encodings\n");
+  /* S + L verifies on paper but is not canonical */
+  Host_Hex(signature, aVectors[0].p_signature);
+  Host_Hex(key, aVectors[0].p_key);
+  for (i = 0, borrow = 0; i < 32; i++)
+  {
+    borrow += (int64_t)signature[32 + i] + aOrder[i];
+    signature[32 + i] = (uint8_t)borrow;
+    borrow >>= 8;
+  }
+  CHECK(borrow == 0);
+  CHECK(!Ed25519_Verify(signature, key, message, 0));
+  /* S = L */
+  memcpy(&signature[32], aOrder, 32);
+  CHECK(!Ed25519_Verify(signature, key, message, 0));
+  /* y = p, a non canonical encoding of y = 0 */
+  Host_Hex(signature, aVectors[0].p_signature);
+  Host_Hex(key, "edffffffffffffffffffffffffffffffffffffffffffffffffffffffffffff7f");
+  CHECK(!Ed25519_Verify(signature, key, message, 0));
+  /* y = 2 is not on the curve */
+  memset(key, 0, sizeof(key));
+  key[0] = 2;
+  CHECK(!Ed25519_Verify(signature, key, message, 0));
+  printf("  S + L, S = L, y = p and a point off the curve refused\n");
+
+  printf("Sc_Reduce\n");
+  for (i = 0; i < (sizeof(aReduce) / sizeof(aReduce[0])); i++)
+  {
+    Host_Hex(x, aReduce[i][0]);
+    Host_Hex(expected, aReduce[i][1]);
+    Sc_Check(x, out);
+    CHECK(memcmp(out, expected, 32) == 0);
+    Sc_Reference(out, x);
+    CHECK(memcmp(out, expected, 32) == 0);
+  }
+  seed = 0x5CA1AB1E;
+  for (i = 0; i < ED_REDUCE_ROUNDS; i++)
+  {
+    /* Random bytes, with runs of 0x00 and 0xFF for the carry paths */
+    for (j = 0; j < 64; j++)
+    {
+      x[j] = (uint8_t)Host_Random(&seed);
+      x[j] = ((i & 3) == 1) ? (x[j] | 0xF0) : (((i & 3) == 2) ? (x[j] & 0x0F) : x[j]);
+    }
+    Sc_Check(x, out);
+    Sc_Reference(expected, x);
+    CHECK(memcmp(out, expected, 32) == 0);
+  }
+  printf("  %u fixed and %u random inputs match the long division\n",
+         (unsigned int)(sizeof(aReduce) / sizeof(aReduce[0])), (unsigned int)ED_REDUCE_ROUNDS);
+
+#ifdef HOST_BENCH
+  {
+    uint64_t ns, cycles;
+
+    Host_Hex(signature, aLongSignature);
+    Host_Hex(key, aVectors[2].p_key);
+    ns = Host_Nanoseconds();
+    cycles = Host_Cycles();
+    for (i = 0; i < ED_BENCH_ROUNDS; i++)
+    {
+      CHECK(Ed25519_Verify(signature, key, aLongMessage, sizeof(aLongMessage)));
+    }
+    cycles = Host_Cycles() - cycles;
+    ns = Host_Nanoseconds() - ns;
+    printf("bench: %.1f us, %.0f host cycles per verification of a 1K message\n",
+           (double)ns / ED_BENCH_ROUNDS / 1e3, (double)cycles / ED_BENCH_ROUNDS);
+  }
+#else
+  {
+    uint64_t estimate;
+
+    /* A 32-byte message, as verify.c signs the SHA-256 of the image */
+    Host_Hex(signature, aVectors[3].p_signature);
+    Host_Hex(key, aVectors[3].p_key);
+    length = Host_Hex(message, aVectors[3].p_message);
+    memset(&Counts, 0, sizeof(Counts));
+    CHECK(Ed25519_Verify(signature, key, message, length));
+    printf("Cortex-M0+ estimate\n");
+    if (Counts.mul == 0)
+    {
+      printf("  not counted, build with -finstrument-functions\n");
+    }
+    else
+    {
+      estimate = (uint64_t)Counts.mul * M0_CYCLES_MUL + (uint64_t)Counts.sq * M0_CYCLES_SQ
+               + (uint64_t)Counts.add * M0_CYCLES_ADD + (uint64_t)Counts.pack * M0_CYCLES_PACK;
+      printf("  %u Fe_Mul, %u Fe_Sq, %u Fe_Add/Fe_Sub, %u Fe_Pack\n", (unsigned int)Counts.mul,
+             (unsigned int)Counts.sq, (unsigned int)Counts.add, (unsigned int)Counts.pack);
+      printf("  about %.1f M cycles, %.0f ms at %u MHz before Flash wait states\n", (double)estimate / 1e6,
+             (double)estimate / (M0_CORE_CLOCK_MHZ * 1000), (unsigned int)M0_CORE_CLOCK_MHZ);
+    }
+  }
+#endif /* HOST_BENCH */
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,237 @@
+/**
+  ******************************************************************************
+  * @file    test_resync.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   Bit error injection into 1K YMODEM frames on the line model, read
+  *          back with ReceivePacket and FlushLine of ymodem.c.
+  *
+  *          The receiver answers as Ymodem_Receive does: ACK a clean block,
+  *          NAK a corrupted frame once the line is idle, NAK after the
+  *          adaptive timeout when a frame falls short. Every block must
+  *          arrive intact, and a corrupted frame must cost no more than the
+  *          resync idle gap before the sender is told. The recovery latency
+  *          is the time from the end of a bad frame on the line to the start
+  *          of its retransmission.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "host_ymodem.h"
+#include "ymodem.c"
+
+/* Private define ------------------------------------------------------------*/
+#define RESYNC_BLOCKS           ((uint32_t)2000)
+#define SENDER_TURNAROUND_NS    ((uint64_t)1000000)   /* Host reaction to an ACK or NAK */
+#define FRAME_SIZE              (PACKET_HEADER_SIZE + PACKET_1K_SIZE + PACKET_TRAILER_SIZE)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t frames;      /* Frames sent, retransmissions included */
+  uint32_t corrupted;   /* Frames with a bit flipped or a byte lost */
+  uint32_t resyncs;     /* HAL_ERROR: NAKed once the line went idle */
+  uint32_t timeouts;    /* HAL_TIMEOUT: NAKed after the retry timeout */
+  uint32_t misframed;   /* Header turned into EOT, CA or an abort key */
+  uint64_t resync_sum;  /* Recovery latencies, ns */
+  uint64_t resync_max;
+  uint64_t timeout_sum;
+  uint64_t timeout_max;
+  uint64_t elapsed;     /* First start bit to the last ACK, ns */
+} Resync_ResultTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static uint8_t aFrame[FRAME_SIZE];
+static uint8_t aSent[FRAME_SIZE];
+static uint32_t aReceived[(PACKET_1K_SIZE + PACKET_DATA_INDEX + PACKET_TRAILER_SIZE + 3) / 4];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Frame block number of the test image
+  */
+static void Resync_Frame(uint32_t number)
+{
+  uint32_t i, seed = number * 2654435761U + 1;
+  uint16_t crc;
+
+  aFrame[0] = STX;
+  aFrame[1] = (uint8_t)number;
+  aFrame[2] = (uint8_t)number ^ NEGATIVE_BYTE;
+  for (i = 0; i < PACKET_1K_SIZE; i++)
+  {
+    aFrame[PACKET_HEADER_SIZE + i] = (uint8_t)Host_Random(&seed);
+  }
+  crc = (uint16_t)HAL_CRC_Calculate(&CrcHandle, (uint32_t *)&aFrame[PACKET_HEADER_SIZE], PACKET_1K_SIZE);
+  aFrame[PACKET_HEADER_SIZE + PACKET_1K_SIZE] = (uint8_t)(crc >> 8);
+  aFrame[PACKET_HEADER_SIZE + PACKET_1K_SIZE + 1] = (uint8_t)crc;
+}
+
+/**
+  * @brief  Copy the frame with each data bit flipped and each byte lost at
+  *         the given rates, a lost byte being an overrun
+  * @param  p_seed: generator state
+  * @param  ber: bit error rate
+  * @param  loss: byte loss rate
+  * @param  p_length: receives the number of bytes left
+  * @retval 1 if the copy differs from the frame
+  */
+static uint32_t Resync_Corrupt(uint32_t *p_seed, double ber, double loss, uint32_t *p_length)
+{
+  uint32_t i, bit, length = 0, damaged = 0;
+  uint32_t flip = (uint32_t)(ber * 4294967296.0);
+  uint32_t drop = (uint32_t)(loss * 4294967296.0);
+
+  for (i = 0; i < FRAME_SIZE; i++)
+  {
+    if ((drop != 0) && (Host_Random(p_seed) < drop))
+    {
+      damaged = 1;
+      continue;
+    }
+    aSent[length] = aFrame[i];
+    for (bit = 0; (flip != 0) && (bit < 8); bit++)
+    {
+      if (Host_Random(p_seed) < flip)
+      {
+        aSent[length] ^= (uint8_t)(1U << bit);
+        damaged = 1;
+      }
+    }
+    length++;
+  }
+  *p_length = length;
+  return damaged;
+}
+
+/**
+  * @brief  Send RESYNC_BLOCKS blocks through a line with the given bit error
+  *         and byte loss rates
+  */
+static void Resync_Run(double ber, double loss, uint32_t seed, Resync_ResultTypeDef *p_result)
+{
+  RTT_EstimatorTypeDef rtt;
+  uint8_t *p_packet = (uint8_t *)aReceived;
+  uint32_t number = 1, length, sent, response_tick = 0, rtt_armed = 0, corrupted;
+  uint64_t start = 0, frame_end, next, dead;
+  HAL_StatusTypeDef status;
+
+  memset(p_result, 0, sizeof(*p_result));
+  Line_Reset();
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  Resync_Frame(number);
+
+  while (number <= RESYNC_BLOCKS)
+  {
+    corrupted = Resync_Corrupt(&seed, ber, loss, &sent);
+    p_result->frames++;
+    p_result->corrupted += corrupted;
+    Line_Send(aSent, sent, start);
+    frame_end = Line_Idle();
+
+    status = ReceivePacket(p_packet, &length, rtt.rto);
+    if ((status == HAL_OK) && (length == PACKET_1K_SIZE) && (p_packet[PACKET_NUMBER_INDEX] == (uint8_t)number))
+    {
+      /* A corrupted frame accepted would be a CRC16 miss */
+      CHECK(memcmp(&p_packet[PACKET_DATA_INDEX], &aFrame[PACKET_HEADER_SIZE], PACKET_1K_SIZE) == 0);
+      if (rtt_armed)
+      {
+        Rtt_Update(&rtt, PacketStartTick - response_tick);
+      }
+      response_tick = HAL_GetTick();
+      rtt_armed = 1;
+      Resync_Frame(++number);
+    }
+    else
+    {
+      CHECK(corrupted);
+      rtt_armed = 0;
+      if (status == HAL_TIMEOUT)
+      {
+        Rtt_Backoff(&rtt);
+      }
+      /* The rest of a misframed block is drained as a corrupted frame would be */
+      if ((status == HAL_OK) || (status == HAL_BUSY))
+      {
+        p_result->misframed++;
+        FlushLine();
+      }
+    }
+
+    /* The answer goes out once ReceivePacket returns, after the last byte read */
+    next = HostTime + HOST_CHAR_NS + SENDER_TURNAROUND_NS;
+    next = (next > frame_end) ? next : frame_end;
+    dead = next - frame_end;
+    if (status == HAL_ERROR)
+    {
+      p_result->resyncs++;
+      p_result->resync_sum += dead;
+      p_result->resync_max = (dead > p_result->resync_max) ? dead : p_result->resync_max;
+    }
+    else if (status == HAL_TIMEOUT)
+    {
+      p_result->timeouts++;
+      p_result->timeout_sum += dead;
+      p_result->timeout_max = (dead > p_result->timeout_max) ? dead : p_result->timeout_max;
+    }
+    CHECK(Line_Pending() == 0);
+    start = next;
+  }
+  p_result->elapsed = HostTime;
+}
+
+/**
+  * @brief  Print one line of results and check it
+  */
+static void Resync_Report(double rate, const Resync_ResultTypeDef *p_result, uint64_t bound)
+{
+  printf("%8.0e  %6u %4u  %6u  %5.2f/%5.2f  %7u  %5.0f/%5.0f  %9u  %5.1f\n", rate,
+         (unsigned int)p_result->frames, (unsigned int)p_result->corrupted, (unsigned int)p_result->resyncs,
+         p_result->resyncs ? (double)p_result->resync_sum / p_result->resyncs / 1e6 : 0.0,
+         (double)p_result->resync_max / 1e6, (unsigned int)p_result->timeouts,
+         p_result->timeouts ? (double)p_result->timeout_sum / p_result->timeouts / 1e6 : 0.0,
+         (double)p_result->timeout_max / 1e6, (unsigned int)p_result->misframed,
+         (double)RESYNC_BLOCKS * PACKET_1K_SIZE / ((double)p_result->elapsed / 1e9) / 1000.0);
+  CHECK(p_result->frames == (RESYNC_BLOCKS + p_result->resyncs + p_result->timeouts + p_result->misframed));
+  CHECK(p_result->resync_max <= bound);
+  /* A short frame waits for the retry timeout, clamped to RTO_MAX_TIMEOUT,
+     plus the wire time of a 1K frame */
+  CHECK(p_result->timeout_max <= ((uint64_t)(RTO_MAX_TIMEOUT + 100 + 2) * 1000000U + SENDER_TURNAROUND_NS));
+}
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  static const double aBer[] = { 0.0, 1e-6, 1e-5, 1e-4, 2e-4 };
+  static const double aLoss[] = { 1e-5, 1e-4, 1e-3 };
+  static const char aHeader[] = "  frames  bad  resync  mean/max ms  timeout  mean/max ms  misframed   kB/s\n";
+  Resync_ResultTypeDef result;
+  uint64_t bound;
+  uint32_t i, idle;
+
+  /* FlushLine waits for this idle gap, plus one tick of HAL_GetTick */
+  idle = (RESYNC_IDLE_CHARS * UART_CHAR_BITS * 1000 + HOST_BAUD_RATE - 1) / HOST_BAUD_RATE + 1;
+  bound = (uint64_t)(idle + 1) * 1000000U + HOST_CHAR_NS + SENDER_TURNAROUND_NS;
+
+  printf("%u blocks of 1K at %u baud, sender turnaround %u ms, resync gap %u ms\n",
+         (unsigned int)RESYNC_BLOCKS, (unsigned int)HOST_BAUD_RATE,
+         (unsigned int)(SENDER_TURNAROUND_NS / 1000000U), (unsigned int)idle);
+  printf("     BER%s", aHeader);
+  for (i = 0; i < (sizeof(aBer) / sizeof(aBer[0])); i++)
+  {
+    Resync_Run(aBer[i], 0.0, 0x1234567U + i, &result);
+    Resync_Report(aBer[i], &result, bound);
+    CHECK((aBer[i] != 0.0) || (result.corrupted == 0));
+  }
+  printf("    loss%s", aHeader);
+  for (i = 0; i < (sizeof(aLoss) / sizeof(aLoss[0])); i++)
+  {
+    Resync_Run(0.0, aLoss[i], 0x7654321U + i, &result);
+    Resync_Report(aLoss[i], &result, bound);
+  }
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,539 @@
+/**
+  ******************************************************************************
+  * @file    test_rpc.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   Core/Src/rpc.c on the host: its COBS coder at the block limits
+  *          and on malformed frames, each command of Rpc_Execute on the
+  *          Flash model with the default partition table, and Rpc_Serve fed
+  *          frames sealed by Tools/flash_rpc.py.
+  *
+  *          The serial port is a script of received bytes and a list of the
+  *          frames sent. The CRC unit is replaced by a bitwise CRC-32.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include <setjmp.h>
+#include "host.h"
+#include "host_flash.h"
+#include "sha256.h"
+
+/* A restart of the IAP returns to the check */
+static jmp_buf RpcReset;
+
+#include "stm32g0xx_hal.h"
+#undef NVIC_SystemReset
+#define NVIC_SystemReset()      longjmp(RpcReset, 1)
+
+#include "rpc.c"
+
+/* Private define ------------------------------------------------------------*/
+#define RPC_SCRIPT_SIZE         ((uint32_t)16384)
+#define RPC_SENT_MAX            ((uint32_t)16)
+#define RPC_SEED                ((uint32_t)0xC0B5)
+
+/* Private variables ---------------------------------------------------------*/
+CRC_HandleTypeDef hcrc;
+
+static uint8_t aScript[RPC_SCRIPT_SIZE];        /* Bytes received by Rpc_Serve */
+static uint32_t ScriptLength;
+static uint32_t ScriptRead;
+static uint8_t aSent[RPC_SENT_MAX][RPC_MAX_FRAME];
+static uint32_t aSentLength[RPC_SENT_MAX];
+static uint32_t SentCount;
+static uint32_t Invalidated;                    /* Journal_Invalidate calls */
+
+/* Request and answer of Rpc_Execute, 32-bit aligned as in rpc.c */
+static uint32_t aRequest[RPC_FRAME_WORDS];
+static uint32_t aReply[RPC_PAYLOAD_WORDS];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  CRC-32 (zlib)
+  */
+static uint32_t Rpc_Crc32(const uint8_t *p_data, uint32_t length)
+{
+  uint32_t crc = 0xFFFFFFFFU, i, bit;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= p_data[i];
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc >> 1) ^ ((crc & 1) ? 0xEDB88320U : 0);
+    }
+  }
+  return crc ^ 0xFFFFFFFFU;
+}
+
+/**
+  * @brief  COBS as in the papers: the payload is cut at its zeros, each piece
+  *         sent in blocks of 254 bytes led by 0xFF, then the rest led by its
+  *         length + 1, which stands for the zero after it
+  */
+static uint32_t Rpc_RefEncode(const uint8_t *p_data, uint32_t length, uint8_t *p_frame)
+{
+  uint32_t in = 0, out = 0, run;
+
+  while (1)
+  {
+    for (run = 0; ((in + run) < length) && (p_data[in + run] != 0); run++)
+    {
+    }
+    for (; run >= 254; run -= 254)
+    {
+      p_frame[out++] = 0xFF;
+      memcpy(&p_frame[out], &p_data[in], 254);
+      out += 254;
+      in += 254;
+    }
+    p_frame[out++] = (uint8_t)(run + 1);
+    memcpy(&p_frame[out], &p_data[in], run);
+    out += run;
+    in += run;
+    if (in == length)
+    {
+      break;
+    }
+    /* The zero */
+    in++;
+  }
+  p_frame[out++] = 0;
+  return out;
+}
+
+/**
+  * @brief  Encode with rpc.c, compare with the reference, decode again from a
+  *         buffer of the exact frame size
+  */
+static void Rpc_RoundTrip(const uint8_t *p_data, uint32_t length)
+{
+  static uint8_t aFrame[RPC_MAX_FRAME + 300], aRef[RPC_MAX_FRAME + 300];
+  uint32_t frame, ref, i;
+  uint8_t *p_copy;
+
+  frame = Rpc_CobsEncode(p_data, length, aFrame);
+  ref = Rpc_RefEncode(p_data, length, aRef);
+  CHECK((frame == ref) && (memcmp(aFrame, aRef, frame) == 0));
+  CHECK(frame <= (length + (length / 254) + 2));
+  for (i = 0; i < (frame - 1); i++)
+  {
+    CHECK(aFrame[i] != 0);
+  }
+  CHECK(aFrame[frame - 1] == 0);
+
+  p_copy = malloc(frame - 1 + 1);
+  memcpy(p_copy, aFrame, frame - 1);
+  CHECK(Rpc_CobsDecode(p_copy, frame - 1) == length);
+  CHECK(memcmp(p_copy, p_data, length) == 0);
+  free(p_copy);
+}
+
+/**
+  * @brief  Decode a frame given in hexadecimal, exact size buffer
+  */
+static uint32_t Rpc_Decode(const char *p_hex, uint8_t *p_out)
+{
+  uint8_t aFrame[64];
+  uint32_t length = Host_Hex(aFrame, p_hex), out;
+  uint8_t *p_copy = malloc(length + 1);
+
+  memcpy(p_copy, aFrame, length);
+  out = Rpc_CobsDecode(p_copy, length);
+  memcpy(p_out, p_copy, out);
+  free(p_copy);
+  return out;
+}
+
+/**
+  * @brief  The COBS coder
+  */
+static void Rpc_Cobs(void)
+{
+  static uint8_t aData[RPC_MAX_PAYLOAD + 600];
+  static const uint32_t aRuns[] = { 0, 1, 253, 254, 255, 507, 508, 509, 762, RPC_MAX_PAYLOAD };
+  uint8_t out[64];
+  uint8_t *p_garbage;
+  uint32_t i, j, length, density, seed = RPC_SEED;
+
+  /* Runs of non zero bytes around the 254-byte block, alone, then followed
+     by a zero, a trailing zero or a second run */
+  for (i = 0; i < (sizeof(aRuns) / sizeof(aRuns[0])); i++)
+  {
+    memset(aData, 0x5A, aRuns[i]);
+    Rpc_RoundTrip(aData, aRuns[i]);
+    aData[aRuns[i]] = 0;
+    Rpc_RoundTrip(aData, aRuns[i] + 1);
+    aData[aRuns[i] + 1] = 0;
+    Rpc_RoundTrip(aData, aRuns[i] + 2);
+    memset(&aData[aRuns[i] + 1], 0xA5, 254);
+    Rpc_RoundTrip(aData, aRuns[i] + 1 + 254);
+  }
+  memset(aData, 0, 600);
+  for (i = 0; i < 600; i++)
+  {
+    Rpc_RoundTrip(aData, i);
+  }
+
+  /* A full block then the frame end: 254 bytes, no zero implied after them */
+  memset(aData, 0x11, 254);
+  length = Rpc_CobsEncode(aData, 254, aData + 300);
+  CHECK((length == 257) && (aData[300] == 0xFF) && (aData[300 + 255] == 0x01));
+
+  /* Random payloads, from all zeros to none */
+  for (i = 0; i < 4000; i++)
+  {
+    length = Host_Random(&seed) % (RPC_MAX_PAYLOAD + 1);
+    density = Host_Random(&seed) % 9;
+    for (j = 0; j < length; j++)
+    {
+      aData[j] = ((Host_Random(&seed) % 8) < density) ? 0 : (uint8_t)(1 + Host_Random(&seed) % 255);
+    }
+    Rpc_RoundTrip(aData, length);
+  }
+
+  /* Malformed: empty, a zero code, a run longer than the frame */
+  CHECK(Rpc_Decode("", out) == 0);
+  CHECK(Rpc_Decode("00", out) == 0);
+  CHECK(Rpc_Decode("030102", out) == 2);
+  CHECK(Rpc_Decode("0301", out) == 0);
+  CHECK(Rpc_Decode("04010203" "02", out) == 0);
+  CHECK(Rpc_Decode("020100", out) == 0);
+  CHECK(Rpc_Decode("0101", out) == 1);
+  CHECK(Rpc_Decode("ff01", out) == 0);
+  /* Any frame: no access outside it, never more bytes than it has */
+  for (i = 0; i < 20000; i++)
+  {
+    length = 1 + Host_Random(&seed) % 600;
+    p_garbage = malloc(length);
+    for (j = 0; j < length; j++)
+    {
+      p_garbage[j] = ((Host_Random(&seed) % 4) == 0) ? (uint8_t)(Host_Random(&seed) % 8) : (uint8_t)Host_Random(&seed);
+    }
+    CHECK(Rpc_CobsDecode(p_garbage, length) < length);
+    free(p_garbage);
+  }
+
+  /* Frames sealed by Tools/flash_rpc.py, without their delimiter: GETINFO
+     id 0x1234, and WRITE id 0x0201 of 16 bytes with zeros at 0x08017008 */
+  CHECK(Rpc_Decode("0201073412c63a6bd1", out) == 8);
+  CHECK((out[0] == RPC_CMD_GETINFO) && (out[2] == 0x34) && (out[3] == 0x12));
+  CHECK(Rpc_Crc32(out, 4) == (out[4] | (out[5] << 8) | (out[6] << 16) | ((uint32_t)out[7] << 24)));
+  CHECK(Rpc_Decode("0203070102087001080301020103ff80010301020103ff8005b90b6b2e", out) == 28);
+  CHECK((out[0] == RPC_CMD_WRITE) && (out[8] == 0) && (out[9] == 1) && (out[13] == 0xFF) && (out[23] == 0));
+  CHECK(Rpc_Crc32(out, 24) == (out[24] | (out[25] << 8) | (out[26] << 16) | ((uint32_t)out[27] << 24)));
+  printf("  %u run lengths, 4000 random payloads, 20000 malformed frames, 2 frames of flash_rpc.py: ok\n",
+         (unsigned int)(sizeof(aRuns) / sizeof(aRuns[0])));
+}
+
+/**
+  * @brief  Build a request in aRequest: header, up to three words, data
+  * @retval Bytes in the request
+  */
+static uint32_t Rpc_Request(uint8_t command, uint16_t id, uint32_t words, uint32_t w0, uint32_t w1, uint32_t w2,
+                            const uint8_t *p_data, uint32_t length)
+{
+  uint8_t *p_request = (uint8_t *)aRequest;
+  uint32_t aWords[3] = { w0, w1, w2 };
+
+  p_request[0] = command;
+  p_request[1] = 0;
+  p_request[2] = (uint8_t)id;
+  p_request[3] = (uint8_t)(id >> 8);
+  memcpy(&p_request[RPC_HEADER_SIZE], aWords, words * 4);
+  if (length != 0)
+  {
+    memcpy(&p_request[RPC_HEADER_SIZE + words * 4], p_data, length);
+  }
+  return RPC_HEADER_SIZE + words * 4 + length;
+}
+
+/**
+  * @brief  Run a request, check the header of the answer
+  * @retval Bytes in the answer
+  */
+static uint32_t Rpc_Run(uint32_t length, uint8_t status, uint32_t restart)
+{
+  const uint8_t *p_request = (const uint8_t *)aRequest, *p_reply = (const uint8_t *)aReply;
+  uint32_t count, again = 0;
+
+  count = Rpc_Execute(p_request, length, (uint8_t *)aReply, &again);
+  CHECK(p_reply[0] == (p_request[0] | RPC_REPLY));
+  CHECK(p_reply[1] == status);
+  CHECK((p_reply[2] == p_request[2]) && (p_reply[3] == p_request[3]));
+  CHECK(again == restart);
+  CHECK((status == RPC_STATUS_OK) || (count == RPC_HEADER_SIZE));
+  return count;
+}
+
+/**
+  * @brief  Each command of Rpc_Execute
+  */
+static void Rpc_Commands(void)
+{
+  static uint8_t aData[RPC_MAX_DATA + 8];
+  const uint8_t *p_reply = (const uint8_t *)aReply;
+  uint8_t expected[SHA256_DIGEST_SIZE];
+  uint32_t i, value, programmed, seed = RPC_SEED;
+
+  HostFlash_Reset();
+  Part_Init();
+  CHECK(Part_IsDefault());
+  RpcModified = 0;
+  Invalidated = 0;
+  for (i = 0; i < sizeof(aData); i++)
+  {
+    aData[i] = (uint8_t)Host_Random(&seed);
+  }
+
+  /* GETINFO: the three open slots of the default table */
+  CHECK(Rpc_Run(Rpc_Request(RPC_CMD_GETINFO, 0x1234, 0, 0, 0, 0, NULL, 0), RPC_STATUS_OK, 0) == (16 + 3 * 12));
+  CHECK((p_reply[4] == RPC_VERSION) && (p_reply[5] == 3) && (p_reply[6] == 0x00) && (p_reply[7] == 0x04));
+  memcpy(&value, &p_reply[8], 4);
+  CHECK(value == FLASH_PAGE_SIZE);
+  memcpy(&value, &p_reply[12], 4);
+  CHECK(value == RX_RING_SIZE);
+  CHECK((p_reply[16] == PART_TYPE_APP) && (p_reply[28] == PART_TYPE_CALIBRATION) && (p_reply[40] == PART_TYPE_RESOURCE));
+  memcpy(&value, &p_reply[32], 4);
+  CHECK(value == CALIBRATION_ADDRESS);
+  memcpy(&value, &p_reply[36], 4);
+  CHECK(value == CALIBRATION_SIZE);
+
+  /* ERASE: page aligned, inside one slot, the journal voided once */
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 1, 1, CALIBRATION_ADDRESS, 0, 0, NULL, 0), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 2, 3, CALIBRATION_ADDRESS, FLASH_PAGE_SIZE, 0, NULL, 0), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 3, 2, CALIBRATION_ADDRESS + 8, FLASH_PAGE_SIZE, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 4, 2, CALIBRATION_ADDRESS, 0, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 5, 2, FLASH_BASE, FLASH_PAGE_SIZE, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 6, 2, JOURNAL_ADDRESS, FLASH_PAGE_SIZE, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 7, 2, CALIBRATION_ADDRESS, CALIBRATION_SIZE + 1, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 8, 2, RESOURCE_ADDRESS, 0xFFFFFFFFU, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  CHECK((Invalidated == 0) && (HostFlashStats.pages_erased == 0));
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 9, 2, CALIBRATION_ADDRESS, CALIBRATION_SIZE, 0, NULL, 0), RPC_STATUS_OK, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_ERASE, 10, 2, RESOURCE_ADDRESS + FLASH_PAGE_SIZE, 1, 0, NULL, 0), RPC_STATUS_OK, 0);
+  CHECK((Invalidated == 1) && (HostFlashStats.pages_erased == 3));
+
+  /* WRITE: 8 aligned, a multiple of 8, at most RPC_MAX_DATA */
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 11, 1, CALIBRATION_ADDRESS, 0, 0, aData, 4), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 12, 1, CALIBRATION_ADDRESS, 0, 0, aData, 12), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 13, 1, CALIBRATION_ADDRESS, 0, 0, aData, RPC_MAX_DATA + 8), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 14, 1, CALIBRATION_ADDRESS + 4, 0, 0, aData, 8), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 15, 1, CALIBRATION_ADDRESS + CALIBRATION_SIZE - 8, 0, 0, aData, 16),
+          RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 16, 1, CALIBRATION_ADDRESS, 0, 0, aData, RPC_MAX_DATA), RPC_STATUS_OK, 0);
+  CHECK(memcmp((const void *)CALIBRATION_ADDRESS, aData, RPC_MAX_DATA) == 0);
+  /* The same write again, its answer lost: nothing programmed */
+  programmed = HostFlashStats.doublewords + HostFlashStats.fast_rows;
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 16, 1, CALIBRATION_ADDRESS, 0, 0, aData, RPC_MAX_DATA), RPC_STATUS_OK, 0);
+  CHECK(programmed == (HostFlashStats.doublewords + HostFlashStats.fast_rows));
+  /* Other data over it: not erased */
+  Rpc_Run(Rpc_Request(RPC_CMD_WRITE, 17, 1, CALIBRATION_ADDRESS, 0, 0, &aData[8], 8), RPC_STATUS_FLASH, 0);
+  CHECK((Invalidated == 1) && (HostFlashStats.refused == 0));
+
+  /* READ */
+  CHECK(Rpc_Run(Rpc_Request(RPC_CMD_READ, 18, 2, CALIBRATION_ADDRESS + 3, 100, 0, NULL, 0), RPC_STATUS_OK, 0) ==
+        (RPC_HEADER_SIZE + 100));
+  CHECK(memcmp(&p_reply[RPC_HEADER_SIZE], &aData[3], 100) == 0);
+  CHECK(Rpc_Run(Rpc_Request(RPC_CMD_READ, 19, 2, RESOURCE_ADDRESS, RPC_MAX_DATA, 0, NULL, 0), RPC_STATUS_OK, 0) ==
+        (RPC_HEADER_SIZE + RPC_MAX_DATA));
+  Rpc_Run(Rpc_Request(RPC_CMD_READ, 20, 2, RESOURCE_ADDRESS, RPC_MAX_DATA + 1, 0, NULL, 0), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_READ, 21, 1, RESOURCE_ADDRESS, 0, 0, NULL, 0), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_READ, 22, 2, PART_TABLE_ADDRESS, 16, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_READ, 23, 2, APPLICATION_ADDRESS - 8, 16, 0, NULL, 0), RPC_STATUS_RANGE, 0);
+
+  /* DIGEST: CRC-32 and SHA-256 of the area written */
+  CHECK(Rpc_Run(Rpc_Request(RPC_CMD_DIGEST, 24, 3, CALIBRATION_ADDRESS, 1000, DIGEST_ALGO_CRC32, NULL, 0),
+                RPC_STATUS_OK, 0) == (RPC_HEADER_SIZE + 4));
+  memcpy(&value, &p_reply[RPC_HEADER_SIZE], 4);
+  CHECK(value == Rpc_Crc32(aData, 1000));
+  CHECK(Rpc_Run(Rpc_Request(RPC_CMD_DIGEST, 25, 3, CALIBRATION_ADDRESS, 1000, DIGEST_ALGO_SHA256, NULL, 0),
+                RPC_STATUS_OK, 0) == (RPC_HEADER_SIZE + SHA256_DIGEST_SIZE));
+  Sha256(aData, 1000, expected);
+  CHECK(memcmp(&p_reply[RPC_HEADER_SIZE], expected, SHA256_DIGEST_SIZE) == 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_DIGEST, 26, 3, CALIBRATION_ADDRESS, 1000, 0x7F, NULL, 0), RPC_STATUS_COMMAND, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_DIGEST, 27, 3, CALIBRATION_ADDRESS, 0, DIGEST_ALGO_CRC32, NULL, 0), RPC_STATUS_RANGE, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_DIGEST, 28, 2, CALIBRATION_ADDRESS, 1000, 0, NULL, 0), RPC_STATUS_LENGTH, 0);
+
+  /* JUMP, and a command unknown */
+  Rpc_Run(Rpc_Request(RPC_CMD_JUMP, 29, 1, 0, 0, 0, NULL, 0), RPC_STATUS_LENGTH, 0);
+  Rpc_Run(Rpc_Request(RPC_CMD_JUMP, 0xFFFF, 0, 0, 0, 0, NULL, 0), RPC_STATUS_OK, 1);
+  Rpc_Run(Rpc_Request(0x7F, 30, 0, 0, 0, 0, NULL, 0), RPC_STATUS_COMMAND, 0);
+  Rpc_Run(Rpc_Request(0x00, 31, 0, 0, 0, 0, NULL, 0), RPC_STATUS_COMMAND, 0);
+  printf("  GETINFO, ERASE, WRITE, READ, DIGEST, JUMP and their refusals: ok\n");
+}
+
+/**
+  * @brief  Append bytes to the script of Rpc_Serve
+  */
+static void Rpc_Script(const uint8_t *p_data, uint32_t length)
+{
+  CHECK((ScriptLength + length) <= RPC_SCRIPT_SIZE);
+  memcpy(&aScript[ScriptLength], p_data, length);
+  ScriptLength += length;
+}
+
+/**
+  * @brief  Append the request in aRequest as a frame, CRC damaged if asked
+  */
+static void Rpc_ScriptRequest(uint32_t length, uint32_t damage)
+{
+  static uint8_t aFrame[RPC_MAX_FRAME + 8];
+  uint8_t *p_request = (uint8_t *)aRequest;
+  uint32_t crc = Rpc_Crc32(p_request, length) ^ damage;
+
+  memcpy(&p_request[length], &crc, RPC_CRC_SIZE);
+  Rpc_Script(aFrame, Rpc_RefEncode(p_request, length + RPC_CRC_SIZE, aFrame));
+}
+
+/**
+  * @brief  Decode a frame sent by Rpc_Serve and check its CRC
+  * @retval Bytes of the answer without the CRC
+  */
+static uint32_t Rpc_Sent(uint32_t index, uint8_t *p_answer)
+{
+  uint32_t length, crc;
+
+  CHECK((index < SentCount) && (aSent[index][aSentLength[index] - 1] == 0));
+  memcpy(p_answer, aSent[index], aSentLength[index] - 1);
+  length = Rpc_CobsDecode(p_answer, aSentLength[index] - 1);
+  CHECK(length >= (RPC_HEADER_SIZE + RPC_CRC_SIZE));
+  length -= RPC_CRC_SIZE;
+  memcpy(&crc, &p_answer[length], RPC_CRC_SIZE);
+  CHECK(crc == Rpc_Crc32(p_answer, length));
+  return length;
+}
+
+/**
+  * @brief  Rpc_Serve over the scripted line
+  */
+static void Rpc_Session(void)
+{
+  static uint8_t aAnswer[RPC_MAX_FRAME], aData[64], aLong[RPC_MAX_FRAME + 10];
+  static const uint8_t aPython[] =
+  {
+    0x02, 0x01, 0x07, 0x34, 0x12, 0xc6, 0x3a, 0x6b, 0xd1, 0x00
+  };
+  uint32_t length, i, seed = RPC_SEED;
+
+  HostFlash_Reset();
+  Part_Init();
+  ScriptLength = ScriptRead = SentCount = Invalidated = 0;
+  for (i = 0; i < sizeof(aData); i++)
+  {
+    aData[i] = (uint8_t)Host_Random(&seed);
+  }
+  memset(aLong, 0x33, sizeof(aLong));
+
+  /* Noise, GETINFO from flash_rpc.py, a frame too long, a bad CRC, a
+     truncated code, then ERASE, WRITE, READ and JUMP */
+  Rpc_Script((const uint8_t *)"\x00\x07\x00", 3);
+  Rpc_Script(aPython, sizeof(aPython));
+  Rpc_Script(aLong, sizeof(aLong));
+  Rpc_Script((const uint8_t *)"", 1);
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_READ, 40, 2, CALIBRATION_ADDRESS, 8, 0, NULL, 0), 0x100);
+  Rpc_Script((const uint8_t *)"\x09\x03\x00", 3);
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_ERASE, 41, 2, RESOURCE_ADDRESS, FLASH_PAGE_SIZE, 0, NULL, 0), 0);
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_WRITE, 42, 1, RESOURCE_ADDRESS + 8, 0, 0, aData, sizeof(aData)), 0);
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_READ, 43, 2, RESOURCE_ADDRESS, 16, 0, NULL, 0), 0);
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_JUMP, 44, 0, 0, 0, 0, NULL, 0), 0);
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_GETINFO, 45, 0, 0, 0, 0, NULL, 0), 0);
+
+  if (setjmp(RpcReset) == 0)
+  {
+    Rpc_Serve();
+    CHECK(0);
+  }
+  /* Restarted after the answer to JUMP, the last request left unread */
+  CHECK(SentCount == 5);
+  CHECK(ScriptRead < ScriptLength);
+  length = Rpc_Sent(0, aAnswer);
+  CHECK((length == (16 + 3 * 12)) && (aAnswer[0] == (RPC_CMD_GETINFO | RPC_REPLY)) && (aAnswer[2] == 0x34));
+  length = Rpc_Sent(1, aAnswer);
+  CHECK((length == RPC_HEADER_SIZE) && (aAnswer[1] == RPC_STATUS_OK) && (aAnswer[2] == 41));
+  length = Rpc_Sent(2, aAnswer);
+  CHECK((length == RPC_HEADER_SIZE) && (aAnswer[1] == RPC_STATUS_OK) && (aAnswer[2] == 42));
+  length = Rpc_Sent(3, aAnswer);
+  CHECK((length == (RPC_HEADER_SIZE + 16)) && (aAnswer[2] == 43));
+  CHECK((memcmp(&aAnswer[RPC_HEADER_SIZE], "\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF", 8) == 0) &&
+        (memcmp(&aAnswer[RPC_HEADER_SIZE + 8], aData, 8) == 0));
+  length = Rpc_Sent(4, aAnswer);
+  CHECK((length == RPC_HEADER_SIZE) && (aAnswer[0] == (RPC_CMD_JUMP | RPC_REPLY)) && (aAnswer[2] == 44));
+  CHECK(Invalidated == 1);
+
+  /* Idle line: back to the menu */
+  ScriptLength = ScriptRead = SentCount = 0;
+  Rpc_ScriptRequest(Rpc_Request(RPC_CMD_GETINFO, 46, 0, 0, 0, 0, NULL, 0), 0);
+  Rpc_Serve();
+  CHECK((SentCount == 1) && (ScriptRead == ScriptLength));
+  printf("  noise, a frame too long, a bad CRC, a truncated frame dropped, 5 answers then the restart: ok\n");
+}
+
+/* Public functions ---------------------------------------------------------*/
+HAL_StatusTypeDef HAL_CRC_Init(CRC_HandleTypeDef *hcrc)
+{
+  return HAL_OK;
+}
+
+/**
+  * @brief  The CRC unit in the setting of Digest_Crc32 only
+  */
+uint32_t HAL_CRC_Calculate(CRC_HandleTypeDef *hcrc, uint32_t pBuffer[], uint32_t BufferLength)
+{
+  CHECK((hcrc->Init.GeneratingPolynomial == 0x04C11DB7) && (hcrc->Init.InitValue == 0xFFFFFFFFU) &&
+        (hcrc->Init.InputDataInversionMode == CRC_INPUTDATA_INVERSION_BYTE) &&
+        (hcrc->Init.OutputDataInversionMode == CRC_OUTPUTDATA_INVERSION_ENABLE) &&
+        (hcrc->InputDataFormat == CRC_INPUTDATA_FORMAT_BYTES));
+  return Rpc_Crc32((const uint8_t *)pBuffer, BufferLength) ^ 0xFFFFFFFFU;
+}
+
+void MX_CRC_Init(void)
+{
+}
+
+void Journal_Invalidate(void)
+{
+  Invalidated++;
+}
+
+HAL_StatusTypeDef Serial_Receive(uint8_t *p_data, uint32_t size, uint32_t timeout)
+{
+  CHECK((size == 1) && (timeout == RPC_IDLE_TIMEOUT));
+  if (ScriptRead == ScriptLength)
+  {
+    return HAL_TIMEOUT;
+  }
+  *p_data = aScript[ScriptRead++];
+  return HAL_OK;
+}
+
+HAL_StatusTypeDef Serial_PutFrame(uint8_t *p_frame, uint16_t length)
+{
+  CHECK((SentCount < RPC_SENT_MAX) && (length <= RPC_MAX_FRAME));
+  memcpy(aSent[SentCount], p_frame, length);
+  aSentLength[SentCount++] = length;
+  return HAL_OK;
+}
+
+void Serial_WaitTxDone(void)
+{
+}
+
+void Serial_Flush(void)
+{
+}
+
+int main(void)
+{
+  printf("COBS\n");
+  Rpc_Cobs();
+  printf("Rpc_Execute\n");
+  Rpc_Commands();
+  printf("Rpc_Serve\n");
+  Rpc_Session();
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,179 @@
+/**
+  ******************************************************************************
+  * @file    test_rtt.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   Rtt_Update and Rtt_Backoff of ymodem.c on synthetic round-trip
+  *          time traces, against the floating point update of RFC 6298
+  *          (alpha 1/8, beta 1/4, K 4) and the clamping to RTO_MIN_TIMEOUT
+  *          and RTO_MAX_TIMEOUT.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "host_ymodem.h"
+#include "ymodem.c"
+#include <math.h>
+
+/* Private define ------------------------------------------------------------*/
+#define TRACE_LENGTH            ((uint32_t)400)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  double srtt;
+  double rttvar;
+  uint32_t samples;
+} Rtt_ReferenceTypeDef;
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  RFC 6298 section 2, in floating point, with the same clamping
+  * @retval Retry timeout in ms
+  */
+static double Rtt_Reference(Rtt_ReferenceTypeDef *p_ref, double sample)
+{
+  double rto;
+
+  if (p_ref->samples++ == 0)
+  {
+    p_ref->srtt = sample;
+    p_ref->rttvar = sample / 2;
+  }
+  else
+  {
+    p_ref->rttvar = 0.75 * p_ref->rttvar + 0.25 * fabs(p_ref->srtt - sample);
+    p_ref->srtt = 0.875 * p_ref->srtt + 0.125 * sample;
+  }
+  rto = p_ref->srtt + 4 * p_ref->rttvar;
+  return (rto < RTO_MIN_TIMEOUT) ? RTO_MIN_TIMEOUT : ((rto > RTO_MAX_TIMEOUT) ? RTO_MAX_TIMEOUT : rto);
+}
+
+/**
+  * @brief  Feed a trace to both estimators, the fixed point one stays within
+  *         a few ms of the reference
+  * @retval Largest difference in ms
+  */
+static double Rtt_Trace(const char *p_name, const uint32_t *p_trace, uint32_t length)
+{
+  RTT_EstimatorTypeDef rtt;
+  Rtt_ReferenceTypeDef ref = { 0.0, 0.0, 0 };
+  double expected, error, worst = 0.0;
+  uint32_t i;
+
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  CHECK(rtt.rto == DOWNLOAD_TIMEOUT);
+  for (i = 0; i < length; i++)
+  {
+    Rtt_Update(&rtt, p_trace[i]);
+    expected = Rtt_Reference(&ref, p_trace[i]);
+    CHECK((rtt.rto >= RTO_MIN_TIMEOUT) && (rtt.rto <= RTO_MAX_TIMEOUT));
+    error = fabs((double)rtt.rto - expected);
+    worst = (error > worst) ? error : worst;
+    /* Truncation of the scaled terms, a few ms at most, or 2 % of large values */
+    if (error > (4.0 + 0.02 * expected))
+    {
+      fprintf(stderr, "%s: sample %u of %u ms: rto %u, RFC 6298 %.1f\n", p_name, (unsigned int)i,
+              (unsigned int)p_trace[i], (unsigned int)rtt.rto, expected);
+      CHECK(0);
+    }
+  }
+  printf("  %-10s %3u samples, last rto %5u ms, worst difference %4.1f ms\n", p_name,
+         (unsigned int)length, (unsigned int)rtt.rto, worst);
+  return worst;
+}
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  static uint32_t aTrace[TRACE_LENGTH];
+  RTT_EstimatorTypeDef rtt;
+  uint32_t i, seed = 0xC0FFEEU, expected;
+
+  printf("RFC 6298 update\n");
+  /* Steady host */
+  for (i = 0; i < TRACE_LENGTH; i++)
+  {
+    aTrace[i] = 300;
+  }
+  Rtt_Trace("constant", aTrace, TRACE_LENGTH);
+
+  /* Jitter around 250 ms */
+  for (i = 0; i < TRACE_LENGTH; i++)
+  {
+    aTrace[i] = 200 + Host_Random(&seed) % 100;
+  }
+  Rtt_Trace("jitter", aTrace, TRACE_LENGTH);
+
+  /* The host starts erasing: 20 ms, then 800 ms */
+  for (i = 0; i < TRACE_LENGTH; i++)
+  {
+    aTrace[i] = (i < (TRACE_LENGTH / 2)) ? 20 : 800;
+  }
+  Rtt_Trace("step", aTrace, TRACE_LENGTH);
+
+  /* Rare long pauses of a busy host */
+  for (i = 0; i < TRACE_LENGTH; i++)
+  {
+    aTrace[i] = ((Host_Random(&seed) % 50) == 0) ? 3000 : 150;
+  }
+  Rtt_Trace("spikes", aTrace, TRACE_LENGTH);
+
+  /* A step up is covered within a few samples */
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  for (i = 0; i < 50; i++)
+  {
+    Rtt_Update(&rtt, 20);
+  }
+  for (i = 0; (i < 10) && (rtt.rto <= 800); i++)
+  {
+    Rtt_Update(&rtt, 800);
+  }
+  CHECK(rtt.rto > 800);
+  printf("  step 20 -> 800 ms covered after %u samples\n", (unsigned int)i);
+
+  printf("Clamping\n");
+  /* First sample: srtt = R, rttvar = R / 2, rto = 3 R */
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  Rtt_Update(&rtt, 50);
+  CHECK(rtt.samples == 1);
+  CHECK(rtt.rto == 150);
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  for (i = 0; i < 100; i++)
+  {
+    Rtt_Update(&rtt, 1);
+  }
+  CHECK(rtt.rto == RTO_MIN_TIMEOUT);
+  Rtt_Update(&rtt, 0);
+  CHECK(rtt.rto == RTO_MIN_TIMEOUT);
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  Rtt_Update(&rtt, 60000);
+  CHECK(rtt.rto == RTO_MAX_TIMEOUT);
+  printf("  rto stays within [%u, %u] ms\n", (unsigned int)RTO_MIN_TIMEOUT, (unsigned int)RTO_MAX_TIMEOUT);
+
+  printf("Backoff\n");
+  Rtt_Init(&rtt, RTO_MIN_TIMEOUT);
+  expected = RTO_MIN_TIMEOUT;
+  for (i = 0; i < 12; i++)
+  {
+    Rtt_Backoff(&rtt);
+    expected = ((expected * 2) > RTO_MAX_TIMEOUT) ? RTO_MAX_TIMEOUT : (expected * 2);
+    CHECK(rtt.rto == expected);
+  }
+  CHECK(rtt.rto == RTO_MAX_TIMEOUT);
+  /* The next clean sample recomputes the timeout from the estimate */
+  Rtt_Init(&rtt, DOWNLOAD_TIMEOUT);
+  Rtt_Update(&rtt, 100);
+  Rtt_Update(&rtt, 100);
+  Rtt_Backoff(&rtt);
+  Rtt_Backoff(&rtt);
+  Rtt_Update(&rtt, 100);
+  CHECK(rtt.rto < 400);
+  printf("  doubles up to %u ms, reset by the next sample\n", (unsigned int)RTO_MAX_TIMEOUT);
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,167 @@
+/**
+  ******************************************************************************
+  * @file    test_sha256.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   sha256.c against the FIPS 180-4 examples and against digests of
+  *          Python hashlib, with the data fed in pieces of every size around
+  *          the block boundaries, as the YMODEM path feeds it. Built with
+  *          HOST_BENCH, also times the compression on the host.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "sha256.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SHA_DATA_SIZE           ((uint32_t)65549)
+#define SHA_SEED                ((uint32_t)0x5EED)
+#define SHA_BENCH_SIZE          ((uint32_t)(1024 * 1024))
+#define SHA_BENCH_ROUNDS        ((uint32_t)16)
+
+/* Private typedef -----------------------------------------------------------*/
+typedef struct
+{
+  uint32_t length;
+  const char *p_digest;
+} Sha_VectorTypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+/* First length bytes of the Host_Random stream from SHA_SEED, digests given
+   by hashlib.sha256 */
+static const Sha_VectorTypeDef aVectors[] =
+{
+  {     0, "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855" },
+  {     1, "2e7d2c03a9507ae265ecf5b5356885a53393a2029d241394997265a1a25aefc6" },
+  {    55, "755fc4b1cc97a4b629e377ec8137a3630ee1f2356e14d5f7277e7aecee136e0a" },
+  {    56, "c99591c20777457c477f0dcc4ceefc27874b06db98ce4d5ac0787e997c308f54" },
+  {    63, "1d695519c7d24d1f431bb905bf7b367e82c58c002a133e0be47c20faefa83bd7" },
+  {    64, "838a7d7c3ab1ce7807fae66f37a348fa7c6a8491d2159743833a2461c6ccbcf8" },
+  {    65, "2106db1d730488710c3c7af393368ffb30a35700ff78fb6bcc6e763743fa95b6" },
+  {  1000, "894a950ab5a4d03b8def85ac2cc8d57154223344562c543818b94e6b5818306c" },
+  {  4097, "f97535a699ac672d9b4658bc43ee554dff0d461d6f240b649c413088f97d96fa" },
+  { 65549, "cf0c5bfb7148dc2da6a11ccc2a83a60d9bd18364ad437fbc37f26465f2c78a68" },
+};
+static uint8_t aData[SHA_DATA_SIZE];
+static uint8_t aOdd[SHA_DATA_SIZE + 1];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  Hash a buffer fed in pieces of the given size, one call at least
+  */
+static void Sha_Chunked(const uint8_t *p_data, uint32_t length, uint32_t chunk, uint8_t *p_digest)
+{
+  Sha256_CtxTypeDef ctx;
+  uint32_t offset, size;
+
+  Sha256_Init(&ctx);
+  Sha256_Update(&ctx, p_data, 0);
+  for (offset = 0; offset < length; offset += size)
+  {
+    size = ((length - offset) < chunk) ? (length - offset) : chunk;
+    Sha256_Update(&ctx, &p_data[offset], size);
+  }
+  Sha256_Final(&ctx, p_digest);
+}
+
+/**
+  * @brief  Check a digest against its hexadecimal form
+  */
+static void Sha_Expect(const uint8_t *p_digest, const char *p_hex)
+{
+  uint8_t expected[SHA256_DIGEST_SIZE];
+
+  CHECK(Host_Hex(expected, p_hex) == SHA256_DIGEST_SIZE);
+  CHECK(memcmp(p_digest, expected, SHA256_DIGEST_SIZE) == 0);
+}
+
+#ifdef HOST_BENCH
+/**
+  * @brief  Time the hash of SHA_BENCH_SIZE bytes fed in 1K blocks
+  */
+static void Sha_Bench(void)
+{
+  static uint8_t aBench[SHA_BENCH_SIZE];
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  uint64_t ns, cycles;
+  uint32_t i, seed = SHA_SEED;
+
+  for (i = 0; i < SHA_BENCH_SIZE; i++)
+  {
+    aBench[i] = (uint8_t)Host_Random(&seed);
+  }
+  ns = Host_Nanoseconds();
+  cycles = Host_Cycles();
+  for (i = 0; i < SHA_BENCH_ROUNDS; i++)
+  {
+    Sha_Chunked(aBench, SHA_BENCH_SIZE, 1024, digest);
+  }
+  cycles = Host_Cycles() - cycles;
+  ns = Host_Nanoseconds() - ns;
+  printf("bench: %.1f MB/s, %.2f ns/byte, %.1f host cycles/byte\n",
+         (double)SHA_BENCH_SIZE * SHA_BENCH_ROUNDS / ((double)ns / 1e9) / 1e6,
+         (double)ns / SHA_BENCH_SIZE / SHA_BENCH_ROUNDS,
+         (double)cycles / SHA_BENCH_SIZE / SHA_BENCH_ROUNDS);
+}
+#endif /* HOST_BENCH */
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  static const uint32_t aChunks[] = { 1, 3, 55, 63, 64, 65, 128, 1024, SHA_DATA_SIZE };
+  static uint8_t aMillion[1000000];
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  uint32_t i, j, seed = SHA_SEED;
+
+  /* FIPS 180-4 examples */
+  Sha256((const uint8_t *)"abc", 3, digest);
+  Sha_Expect(digest, "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+  Sha256((const uint8_t *)"abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq", 56, digest);
+  Sha_Expect(digest, "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+  memset(aMillion, 'a', sizeof(aMillion));
+  Sha_Chunked(aMillion, sizeof(aMillion), 1000, digest);
+  Sha_Expect(digest, "cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0");
+  printf("FIPS 180-4 examples: ok\n");
+
+  for (i = 0; i < SHA_DATA_SIZE; i++)
+  {
+    aData[i] = (uint8_t)Host_Random(&seed);
+  }
+  for (i = 0; i < (sizeof(aVectors) / sizeof(aVectors[0])); i++)
+  {
+    Sha256(aData, aVectors[i].length, digest);
+    Sha_Expect(digest, aVectors[i].p_digest);
+    for (j = 0; j < (sizeof(aChunks) / sizeof(aChunks[0])); j++)
+    {
+      Sha_Chunked(aData, aVectors[i].length, aChunks[j], digest);
+      Sha_Expect(digest, aVectors[i].p_digest);
+    }
+    /* Pieces of random sizes, from an odd address */
+    memcpy(&aOdd[1], aData, aVectors[i].length);
+    {
+      Sha256_CtxTypeDef ctx;
+      uint32_t offset, size;
+
+      Sha256_Init(&ctx);
+      for (offset = 0; offset < aVectors[i].length; offset += size)
+      {
+        size = Host_Random(&seed) % 200;
+        size = (size < (aVectors[i].length - offset)) ? size : (aVectors[i].length - offset);
+        Sha256_Update(&ctx, &aOdd[1 + offset], size);
+      }
+      Sha256_Final(&ctx, digest);
+      Sha_Expect(digest, aVectors[i].p_digest);
+    }
+  }
+  printf("hashlib digests of %u lengths, %u piece sizes each: ok\n",
+         (unsigned int)(sizeof(aVectors) / sizeof(aVectors[0])), (unsigned int)(sizeof(aChunks) / sizeof(aChunks[0])) + 1);
+#ifdef HOST_BENCH
+  Sha_Bench();
+#endif /* HOST_BENCH */
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
@@ -0,0 +1,465 @@
+/**
+  ******************************************************************************
+  * @file    test_ymodem.c
+  * @author  Lierda STBU
+  * @version 1.0.0
+  * @date    2026-10-18
+  * @brief   Ymodem_Receive of ymodem.c on the line model and the Flash model,
+  *          against a sender that answers each byte the receiver sends.
+  *
+  *          A download cut short is resumed by a different image of the same
+  *          name, size and header CRC: the blocks programmed before are
+  *          compared, the first one that differs restarts the programming
+  *          at its page and the image is read back from the Flash.
+  *
+  *          An XMODEM sender starts with block 1: it is NAKed as the header
+  *          and sent again. The 0x1A bytes are held back until data follows
+  *          them, so the image ends where the padding of its last block
+  *          starts. The length found at EOT, the Flash contents, the digest
+  *          read back over the signed part and the boot record are checked
+  *          with 128-byte and 1K blocks.
+  ******************************************************************************
+  */
+
+/* Includes ------------------------------------------------------------------*/
+#include "host.h"
+#include "host_ymodem.h"
+#include "host_flash.h"
+#include "stm32g0xx_hal.h"
+
+/* Prof_Now reads SysTick: a stopped one on the host */
+static SysTick_Type HostSysTick = { 0, 15999, 0, 0 };
+#undef SysTick
+#define SysTick                 (&HostSysTick)
+
+#include "ymodem.c"
+#include "journal.h"
+
+/* Private define ------------------------------------------------------------*/
+#define SENDER_TURNAROUND_NS    ((uint64_t)1000000)   /* Sender reaction to a response */
+#define TEST_IMAGE_SIZE         ((uint32_t)(9 * 1024 + 300))
+#define TEST_FILE_NAME          "image.bin"
+#define TEST_XMODEM_SIZE        ((uint32_t)(300 * PACKET_SIZE + 77))
+
+/* Private typedef -----------------------------------------------------------*/
+typedef enum
+{
+  SENDER_HEADER = 0,    /* File header sent, waiting for its ACK */
+  SENDER_WAIT_C,        /* Header ACKed, block 1 goes on 'C' */
+  SENDER_DATA,          /* Block Sender.block sent */
+  SENDER_EOT,
+  SENDER_END,           /* Empty header closing the YMODEM batch */
+  SENDER_SILENT,        /* Cut off: nothing more is sent */
+  SENDER_DONE
+} Sender_StateTypeDef;
+
+typedef struct
+{
+  const uint8_t *p_data;
+  uint32_t length;
+  uint32_t block_size;  /* PACKET_SIZE or PACKET_1K_SIZE */
+  uint32_t cut_after;   /* Block after whose ACK the line goes silent, 0 for none */
+  uint32_t xmodem;      /* No file header, nor empty header at the end */
+  Sender_StateTypeDef state;
+  uint32_t block;
+  uint32_t naks;
+  uint32_t nak_block;   /* Block of the first NAK */
+  uint32_t cancels;     /* CA bytes, two end the session */
+} Sender_TypeDef;
+
+/* Private variables ---------------------------------------------------------*/
+static Sender_TypeDef Sender;
+static uint8_t aFrame[PACKET_HEADER_SIZE + PACKET_1K_SIZE + PACKET_TRAILER_SIZE];
+static uint8_t aHeader[PACKET_SIZE];
+static uint8_t aImageA[TEST_IMAGE_SIZE];
+static uint8_t aImageB[TEST_IMAGE_SIZE];
+static uint8_t aXmodem[TEST_XMODEM_SIZE];
+/* Last call of Verify_Image */
+static uint32_t VerifySize;
+static uint8_t aVerifyDigest[SHA256_DIGEST_SIZE];
+
+/* Private functions ---------------------------------------------------------*/
+
+/**
+  * @brief  CRC16-XMODEM of the frames, computed apart from the receiver
+  */
+static uint16_t Sender_Crc16(const uint8_t *p_data, uint32_t length)
+{
+  uint32_t i, bit;
+  uint16_t crc = 0;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= (uint16_t)(p_data[i] << 8);
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 0x8000U) ? (uint16_t)((crc << 1) ^ 0x1021U) : (uint16_t)(crc << 1);
+    }
+  }
+  return crc;
+}
+
+/**
+  * @brief  Put one frame on the line, a turnaround after the last response
+  * @param  number: block number
+  * @param  p_data: data, padded with pad up to size
+  */
+static void Sender_Frame(uint8_t number, const uint8_t *p_data, uint32_t length, uint32_t size, uint8_t pad)
+{
+  uint16_t crc;
+
+  aFrame[0] = (size == PACKET_1K_SIZE) ? STX : SOH;
+  aFrame[1] = number;
+  aFrame[2] = (uint8_t)~number;
+  memcpy(&aFrame[PACKET_HEADER_SIZE], p_data, length);
+  memset(&aFrame[PACKET_HEADER_SIZE + length], pad, size - length);
+  crc = Sender_Crc16(&aFrame[PACKET_HEADER_SIZE], size);
+  aFrame[PACKET_HEADER_SIZE + size] = (uint8_t)(crc >> 8);
+  aFrame[PACKET_HEADER_SIZE + size + 1] = (uint8_t)crc;
+  Line_Send(aFrame, PACKET_HEADER_SIZE + size + PACKET_TRAILER_SIZE, HostTime + SENDER_TURNAROUND_NS);
+}
+
+/**
+  * @brief  Send the current block of the image
+  */
+static void Sender_Block(void)
+{
+  uint32_t offset = (Sender.block - 1) * Sender.block_size;
+  uint32_t length = Sender.length - offset;
+
+  length = (length > Sender.block_size) ? Sender.block_size : length;
+  Sender_Frame((uint8_t)Sender.block, &Sender.p_data[offset], length, Sender.block_size, XMODEM_PAD);
+}
+
+/**
+  * @brief  Send the end of the file
+  */
+static void Sender_Eot(void)
+{
+  uint8_t eot = EOT;
+
+  Line_Send(&eot, 1, HostTime + SENDER_TURNAROUND_NS);
+}
+
+/**
+  * @brief  The sender side: each byte of the receiver moves it on
+  */
+static void Sender_Respond(uint8_t response)
+{
+  if (response == CA)
+  {
+    Sender.cancels++;
+    Sender.state = SENDER_DONE;
+  }
+  if ((Sender.state == SENDER_SILENT) || (Sender.state == SENDER_DONE))
+  {
+    return;
+  }
+  switch (response)
+  {
+    case ACK:
+      if (Sender.state == SENDER_HEADER)
+      {
+        Sender.state = SENDER_WAIT_C;
+      }
+      else if (Sender.state == SENDER_DATA)
+      {
+        if (Sender.block == Sender.cut_after)
+        {
+          Sender.state = SENDER_SILENT;
+        }
+        else if ((Sender.block * Sender.block_size) >= Sender.length)
+        {
+          Sender.state = SENDER_EOT;
+          Sender_Eot();
+        }
+        else
+        {
+          Sender.block++;
+          Sender_Block();
+        }
+      }
+      else if ((Sender.state == SENDER_EOT) && Sender.xmodem)
+      {
+        Sender.state = SENDER_DONE;
+      }
+      else if (Sender.state == SENDER_EOT)
+      {
+        Sender.state = SENDER_END;
+        Sender_Frame(0, aHeader, 0, PACKET_SIZE, 0);
+      }
+      else if (Sender.state == SENDER_END)
+      {
+        Sender.state = SENDER_DONE;
+      }
+      break;
+    case CRC16:
+      if (Sender.state == SENDER_WAIT_C)
+      {
+        Sender.state = SENDER_DATA;
+        Sender.block = 1;
+        Sender_Block();
+      }
+      break;
+    case NAK:
+      Sender.nak_block = (Sender.naks++ == 0) ? Sender.block : Sender.nak_block;
+      if (Sender.state == SENDER_HEADER)
+      {
+        Sender_Frame(0, aHeader, PACKET_SIZE, PACKET_SIZE, 0);
+      }
+      else if (Sender.state == SENDER_DATA)
+      {
+        Sender_Block();
+      }
+      else if (Sender.state == SENDER_EOT)
+      {
+        Sender_Eot();
+      }
+      break;
+    default:
+      break;
+  }
+}
+
+/**
+  * @brief  YMODEM file header of TEST_FILE_NAME: name, size, zeros
+  */
+static void Sender_Header(uint32_t length)
+{
+  memset(aHeader, 0, sizeof(aHeader));
+  memcpy(aHeader, TEST_FILE_NAME, sizeof(TEST_FILE_NAME));
+  snprintf((char *)&aHeader[sizeof(TEST_FILE_NAME)], sizeof(aHeader) - sizeof(TEST_FILE_NAME), "%u ",
+           (unsigned int)length);
+}
+
+/**
+  * @brief  Run one YMODEM session of an image named TEST_FILE_NAME
+  * @param  cut_after: block after which the sender goes silent, 0 for none
+  * @retval Result of Ymodem_Receive
+  */
+static COM_StatusTypeDef Test_Download(const uint8_t *p_image, uint32_t length, uint32_t block_size,
+                                       uint32_t cut_after, COM_StatsTypeDef *p_stats)
+{
+  COM_StatusTypeDef result;
+  uint64_t size = 0;
+
+  memset(&Sender, 0, sizeof(Sender));
+  Sender.p_data = p_image;
+  Sender.length = length;
+  Sender.block_size = block_size;
+  Sender.cut_after = cut_after;
+  Sender.state = SENDER_HEADER;
+  Sender_Header(length);
+
+  Line_Reset();
+  pHostSender = Sender_Respond;
+  Sender_Frame(0, aHeader, PACKET_SIZE, PACKET_SIZE, 0);
+  result = Ymodem_Receive(&size, p_stats);
+  pHostSender = NULL;
+  CHECK((result != COM_OK) || (size == length));
+  return result;
+}
+
+/**
+  * @brief  Run one XMODEM session: block 1 first, no header
+  * @retval Result of Ymodem_Receive
+  */
+static COM_StatusTypeDef Test_XmodemSession(const uint8_t *p_image, uint32_t length, uint32_t block_size,
+                                            uint64_t *p_size, COM_StatsTypeDef *p_stats)
+{
+  COM_StatusTypeDef result;
+
+  memset(&Sender, 0, sizeof(Sender));
+  Sender.p_data = p_image;
+  Sender.length = length;
+  Sender.block_size = block_size;
+  Sender.xmodem = 1;
+  Sender.state = SENDER_DATA;
+  Sender.block = 1;
+
+  Line_Reset();
+  pHostSender = Sender_Respond;
+  Sender_Block();
+  *p_size = 0;
+  result = Ymodem_Receive(p_size, p_stats);
+  pHostSender = NULL;
+  return result;
+}
+
+/**
+  * @brief  Send length bytes of aXmodem, padded to the block, and check the
+  *         image of expected bytes found at EOT
+  */
+static void Test_Xmodem(const char *p_case, uint32_t length, uint32_t block_size, uint32_t expected)
+{
+  COM_StatsTypeDef stats;
+  Sha256_CtxTypeDef ctx;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  uint32_t app, i, size, crc;
+  uint64_t received;
+
+  HostFlash_Reset();
+  Part_Init();
+  app = Part_Address(PART_TYPE_APP);
+  VerifySize = 0;
+  CHECK(Test_XmodemSession(aXmodem, length, block_size, &received, &stats) == COM_OK);
+  CHECK((Sender.state == SENDER_DONE) && (Sender.cancels == 0));
+  /* Block 1 is taken for a header once, then programmed */
+  CHECK((Sender.naks == 1) && (Sender.nak_block == 1));
+  CHECK(aFileName[0] == '\0');
+  CHECK(stats.blocks == ((length + block_size - 1) / block_size));
+
+  /* The length at EOT stops before the padding held back, never programmed */
+  CHECK((received == expected) && (stats.bytes_programmed == expected));
+  CHECK(memcmp((const void *)(uintptr_t)app, aXmodem, expected) == 0);
+  for (i = expected; i < length; i++)
+  {
+    CHECK(*(const uint8_t *)(uintptr_t)(app + i) == 0xFF);
+  }
+  CHECK(HostFlashStats.refused == 0);
+
+  /* Hashed from the Flash at EOT, without the signature trailer */
+  Sha256_Init(&ctx);
+  Sha256_Update(&ctx, aXmodem, expected - VERIFY_TRAILER_SIZE);
+  Sha256_Final(&ctx, digest);
+  CHECK(memcmp(digest, aFileDigest, SHA256_DIGEST_SIZE) == 0);
+  CHECK((VerifySize == expected) && (memcmp(digest, aVerifyDigest, SHA256_DIGEST_SIZE) == 0));
+  CHECK(Journal_GetVerified(&size, &crc) && (size == expected) && (crc == Digest_Crc32(app, expected)));
+  printf("  %-34s %4u-byte blocks: %5u bytes sent, %5u at EOT\n", p_case, (unsigned int)block_size,
+         (unsigned int)length, (unsigned int)expected);
+}
+
+/**
+  * @brief  Cut a download of A short, then download B of the same name and
+  *         size, different from the byte at offset on
+  */
+static void Test_ResumeOther(uint32_t block_size, uint32_t cut_after, uint32_t offset)
+{
+  COM_StatsTypeDef stats;
+  Sha256_CtxTypeDef ctx;
+  uint8_t digest[SHA256_DIGEST_SIZE];
+  uint32_t seed = 0x1234567U + offset, i, app;
+
+  for (i = 0; i < TEST_IMAGE_SIZE; i++)
+  {
+    aImageA[i] = (uint8_t)Host_Random(&seed);
+  }
+  memcpy(aImageB, aImageA, TEST_IMAGE_SIZE);
+  for (i = offset; i < TEST_IMAGE_SIZE; i++)
+  {
+    aImageB[i] ^= 0x5A;
+  }
+
+  HostFlash_Reset();
+  Part_Init();
+  app = Part_Address(PART_TYPE_APP);
+  CHECK(Test_Download(aImageA, TEST_IMAGE_SIZE, block_size, cut_after, &stats) == COM_ERROR);
+  CHECK(Sender.cancels == 2);
+  CHECK(memcmp((const void *)(uintptr_t)app, aImageA, (cut_after * block_size) & ~(FLASH_PAGE_SIZE - 1)) == 0);
+
+  /* Same header: the journal resumes, the blocks before offset compare equal */
+  CHECK(Test_Download(aImageB, TEST_IMAGE_SIZE, block_size, 0, &stats) == COM_OK);
+  CHECK((Sender.state == SENDER_DONE) && (Sender.naks == 0) && (Sender.cancels == 0));
+  CHECK(memcmp((const void *)(uintptr_t)app, aImageB, TEST_IMAGE_SIZE) == 0);
+  CHECK(HostFlashStats.refused == 0);
+  Sha256_Init(&ctx);
+  Sha256_Update(&ctx, aImageB, TEST_IMAGE_SIZE - VERIFY_TRAILER_SIZE);
+  Sha256_Final(&ctx, digest);
+  CHECK(memcmp(digest, aFileDigest, SHA256_DIGEST_SIZE) == 0);
+  printf("  %4u-byte blocks, cut after block %2u, differing at %5u: blocks from %5u on programmed\n",
+         (unsigned int)block_size, (unsigned int)cut_after, (unsigned int)offset,
+         (unsigned int)(TEST_IMAGE_SIZE - stats.bytes_programmed));
+}
+
+/**
+  * @brief  The progress taken back by the restart is not resumed again
+  */
+static void Test_ResumeRewound(void)
+{
+  COM_StatsTypeDef stats;
+  uint32_t app;
+
+  /* A resumed up to 6K, B differs in the second half of the page at 2K */
+  Test_ResumeOther(PACKET_1K_SIZE, 6, 3 * PACKET_1K_SIZE + 5);
+  HostFlash_Reset();
+  Part_Init();
+  app = Part_Address(PART_TYPE_APP);
+  CHECK(Test_Download(aImageA, TEST_IMAGE_SIZE, PACKET_1K_SIZE, 6, &stats) == COM_ERROR);
+  /* B restarts at 2K and is cut again after block 5: 4K are journaled */
+  CHECK(Test_Download(aImageB, TEST_IMAGE_SIZE, PACKET_1K_SIZE, 5, &stats) == COM_ERROR);
+  Sender_Header(TEST_IMAGE_SIZE);
+  CHECK(Journal_Open(PART_TYPE_APP, TEST_IMAGE_SIZE, Sender_Crc16(aHeader, PACKET_SIZE)) == (2 * FLASH_PAGE_SIZE));
+  CHECK(Test_Download(aImageB, TEST_IMAGE_SIZE, PACKET_1K_SIZE, 0, &stats) == COM_OK);
+  CHECK(memcmp((const void *)(uintptr_t)app, aImageB, TEST_IMAGE_SIZE) == 0);
+  CHECK(HostFlashStats.refused == 0);
+  printf("  cut again after the restart: resumed at the restarted page\n");
+}
+
+/* Signature and boot record of the application slot -------------------------*/
+uint32_t Verify_Image(uint32_t start, uint32_t size, const uint8_t *p_digest)
+{
+  CHECK(start == Part_Address(PART_TYPE_APP));
+  VerifySize = size;
+  memcpy(aVerifyDigest, p_digest, SHA256_DIGEST_SIZE);
+  return 1;
+}
+
+uint32_t Digest_Crc32(uint32_t start, uint32_t length)
+{
+  const uint8_t *p_data = (const uint8_t *)(uintptr_t)start;
+  uint32_t i, bit, crc = 0xFFFFFFFFU;
+
+  for (i = 0; i < length; i++)
+  {
+    crc ^= p_data[i];
+    for (bit = 0; bit < 8; bit++)
+    {
+      crc = (crc & 1U) ? ((crc >> 1) ^ 0xEDB88320U) : (crc >> 1);
+    }
+  }
+  return crc ^ 0xFFFFFFFFU;
+}
+
+/* Public functions ---------------------------------------------------------*/
+int main(void)
+{
+  uint32_t seed = 0xA5A5A5A5U, i;
+
+  printf("XMODEM\n");
+  for (i = 0; i < TEST_XMODEM_SIZE; i++)
+  {
+    aXmodem[i] = (uint8_t)Host_Random(&seed);
+  }
+  aXmodem[4999] = 0x55;
+  Test_Xmodem("image", 5000, PACKET_1K_SIZE, 5000);
+  Test_Xmodem("image", 5000, PACKET_SIZE, 5000);
+  Test_Xmodem("image past block 255", TEST_XMODEM_SIZE - 1, PACKET_SIZE, TEST_XMODEM_SIZE - 1);
+
+  /* 0x1A inside the image: a run up to the end of block 2, then a whole block */
+  memset(&aXmodem[2 * PACKET_1K_SIZE - 200], XMODEM_PAD, 200);
+  memset(&aXmodem[3 * PACKET_1K_SIZE], XMODEM_PAD, PACKET_1K_SIZE);
+  Test_Xmodem("0x1A inside, held then programmed", 5000, PACKET_1K_SIZE, 5000);
+  Test_Xmodem("0x1A inside, held then programmed", 5000, PACKET_SIZE, 5000);
+
+  /* The image ends with 0x1A: taken for the padding, as any XMODEM receiver */
+  memset(&aXmodem[5000 - 5], XMODEM_PAD, 5);
+  Test_Xmodem("image ending in 0x1A", 5000, PACKET_1K_SIZE, 5000 - 5);
+  Test_Xmodem("image ending in 0x1A", 5000, PACKET_SIZE, 5000 - 5);
+
+  /* A sender padding a whole extra block */
+  aXmodem[4095] = 0x55;
+  memset(&aXmodem[4096], XMODEM_PAD, PACKET_1K_SIZE);
+  Test_Xmodem("last block only padding", 4096 + PACKET_1K_SIZE, PACKET_1K_SIZE, 4096);
+  Test_Xmodem("last block only padding", 4096 + PACKET_SIZE, PACKET_SIZE, 4096);
+
+  printf("Resume by a different image of the same header\n");
+  /* Differs at a page start, in the page of the cut, inside a block */
+  Test_ResumeOther(PACKET_1K_SIZE, 6, 2 * FLASH_PAGE_SIZE);
+  Test_ResumeOther(PACKET_1K_SIZE, 6, 5 * PACKET_1K_SIZE + 1);
+  Test_ResumeOther(PACKET_SIZE, 40, FLASH_PAGE_SIZE + 1500);
+  Test_ResumeOther(PACKET_SIZE, 40, 10);
+  Test_ResumeRewound();
+  return 0;
+}
+
+/*******************************END OF FILE************************************/
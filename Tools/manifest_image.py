@@ -0,0 +1,81 @@
+#!/usr/bin/env python3
+"""Prepend a signed page manifest to an image, for YMODEM_MANIFEST.
+
+The manifest is a hash tree whose leaves are the 2K Flash pages of the image
+(see Core/Inc/manifest.h). The bootloader checks each page before its last
+block is programmed, asks again for that block when the page does not match,
+and checks the pages a resumed download kept in Flash. Layout, little endian:
+
+    magic "IAPM" | version | reserved | leaves (2) | image length (4)
+    | reserved (4) | Ed25519 signature (64) | leaf of each page (32 each)
+    | 0xFF up to a multiple of 1024
+
+leaf = SHA-256(0x00 | page), node = SHA-256(0x01 | left | right), an odd node
+goes up as is. The signature covers the first 16 bytes then the root, with
+the key of sign_image.py. Sign the image first and encrypt last:
+
+    sign_image.py sign --key release.key app.bin app_signed.bin
+    manifest_image.py --key release.key app_signed.bin app_manifest.bin
+    encrypt_image.py encrypt --key image.key app_manifest.bin app.bin
+"""
+
+import argparse
+import hashlib
+import struct
+import sys
+
+import sign_image
+
+MAGIC = 0x4D504149
+VERSION = 1
+PAGE_SIZE = 0x800
+ALIGN = 1024
+MAX_LEAVES = (0x08020000 - 0x0800C000) // PAGE_SIZE
+
+
+def leaves(data):
+    return [hashlib.sha256(b"\x00" + data[i:i + PAGE_SIZE]).digest()
+            for i in range(0, len(data), PAGE_SIZE)]
+
+
+def root(level):
+    while len(level) > 1:
+        pairs = [hashlib.sha256(b"\x01" + level[i] + level[i + 1]).digest()
+                 for i in range(0, len(level) - 1, 2)]
+        level = pairs + level[len(pairs) * 2:]
+    return level[0]
+
+
+def build(seed, data):
+    leaf = leaves(data)
+    if not leaf or len(leaf) > MAX_LEAVES:
+        raise ValueError("image of %d bytes does not fit the Flash" % len(data))
+    head = struct.pack("<IBBHII", MAGIC, VERSION, 0, len(leaf), len(data), 0)
+    signature = sign_image.sign(seed, head + root(leaf))
+    manifest = head + signature + b"".join(leaf)
+    manifest += b"\xff" * (-len(manifest) % ALIGN)
+    return manifest
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--key", required=True, help="key file made by sign_image.py keygen")
+    parser.add_argument("image", help="binary to program")
+    parser.add_argument("output", help="manifest and image, to download")
+    args = parser.parse_args()
+
+    seed = sign_image.read_key(args.key)
+    with open(args.image, "rb") as f:
+        data = f.read()
+    try:
+        manifest = build(seed, data)
+    except ValueError as err:
+        sys.exit("error: %s" % err)
+    with open(args.output, "wb") as f:
+        f.write(manifest + data)
+    print("%s: %d pages, manifest %d bytes" % (args.output, len(leaves(data)), len(manifest)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,101 @@
+#!/usr/bin/env python3
+"""Build the flash partition table read by the IAP bootloader at startup.
+
+The table lives in the last Flash page (PART_TABLE_ADDRESS in
+Core/Inc/partition.h). Program the output there with the ST-Link tools:
+
+    part_table.py -o part.bin                     # built-in layout
+    part_table.py -o part.bin app:0xC000:0xB000 cal:0x17000:0x1000 \\
+                  res:0x18000:0x7000 journal:0x1F000:0x800
+    STM32_Programmer_CLI -c port=SWD -d part.bin 0x0801F800
+
+Slots are TYPE:OFFSET:SIZE[:ro], offsets from the Flash base. The boot and
+table slots are always added. Without a valid table the bootloader falls back
+to the layout of flash_if.h.
+
+A stage slot, one page larger than the app slot, lets the running application
+download its own update (APPCore/Src/update_agent.c); the bootloader installs
+it at the next reset:
+
+    part_table.py -o part.bin app:0xC000:0x5000 stage:0x11000:0x5800 \\
+                  cal:0x17000:0x1000 res:0x18000:0x7000 journal:0x1F000:0x800
+"""
+
+import argparse
+import struct
+import sys
+
+PART_MAGIC = 0x50504149
+PART_VERSION = 1
+PART_MAX_SLOTS = 8
+PAGE_SIZE = 0x800
+FLASH_SIZE = 0x20000
+BOOT_SIZE = 0xC000
+TABLE_OFFSET = 0x1F800
+FLAG_READONLY = 0x01
+
+TYPES = {"boot": 1, "app": 2, "cal": 3, "res": 4, "table": 5, "journal": 6,
+         "stage": 7}
+DEFAULT = ["app:0xC000:0xB000", "cal:0x17000:0x1000", "res:0x18000:0x7000",
+           "journal:0x1F000:0x800"]
+
+HEADER = struct.Struct("<IBBH")
+SLOT = struct.Struct("<IIBBH")
+
+
+def crc16_xmodem(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def parse_slot(text):
+    fields = text.split(":")
+    if len(fields) not in (3, 4) or fields[0] not in TYPES:
+        raise ValueError("bad slot '%s', expected TYPE:OFFSET:SIZE[:ro]" % text)
+    offset, size = int(fields[1], 0), int(fields[2], 0)
+    flags = FLAG_READONLY if len(fields) == 4 and fields[3] == "ro" else 0
+    return (offset, size, TYPES[fields[0]], flags)
+
+
+def build(slots):
+    slots = [(0, BOOT_SIZE, TYPES["boot"], FLAG_READONLY)] + slots + \
+            [(TABLE_OFFSET, PAGE_SIZE, TYPES["table"], FLAG_READONLY)]
+    if len(slots) > PART_MAX_SLOTS:
+        raise ValueError("at most %d slots with boot and table" % PART_MAX_SLOTS)
+    spans = []
+    for offset, size, _, _ in slots:
+        if offset % PAGE_SIZE or size % PAGE_SIZE or size == 0 or offset + size > FLASH_SIZE:
+            raise ValueError("slot 0x%x+0x%x is not page aligned inside the Flash" % (offset, size))
+        for start, end in spans:
+            if offset < end and start < offset + size:
+                raise ValueError("slot 0x%x+0x%x overlaps another slot" % (offset, size))
+        spans.append((offset, offset + size))
+    body = b"".join(SLOT.pack(offset, size, kind, flags, 0) for offset, size, kind, flags in slots)
+    table = HEADER.pack(PART_MAGIC, PART_VERSION, len(slots), crc16_xmodem(body)) + body
+    # unused slots stay erased
+    return table + b"\xff" * ((HEADER.size + PART_MAX_SLOTS * SLOT.size) - len(table))
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("slots", nargs="*", help="TYPE:OFFSET:SIZE[:ro], TYPE in %s" %
+                        ", ".join(t for t in TYPES if t not in ("boot", "table")))
+    parser.add_argument("-o", "--output", required=True, help="table binary to program")
+    args = parser.parse_args()
+
+    try:
+        table = build([parse_slot(text) for text in (args.slots or DEFAULT)])
+    except ValueError as err:
+        sys.exit("error: %s" % err)
+    with open(args.output, "wb") as f:
+        f.write(table)
+
+
+if __name__ == "__main__":
+    main()
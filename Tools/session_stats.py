@@ -0,0 +1,95 @@
+#!/usr/bin/env python3
+"""Fetch the statistics of the last IAP download from the bootloader.
+
+Send right after the YMODEM session ends (the bootloader keeps a short query
+window open). The answer is the STATS_QUERY_KEY frame from Core/Src/menu.c:
+
+    magic "IAPS" | version | size | 2 reserved | COM_StatsTypeDef | CRC16 (MSB first)
+
+    session_stats.py --port /dev/ttyUSB0                  # human readable
+    session_stats.py --port /dev/ttyUSB0 --csv log.csv --unit SN1234
+"""
+
+import argparse
+import csv
+import os
+import struct
+import sys
+import time
+
+STATS_MAGIC = 0x53504149
+HEADER = struct.Struct("<IBBH")
+FIELDS = ("total_time", "first_block_time", "blocks", "retransmits", "crc_errors",
+          "timeouts", "bytes_programmed", "erase_time", "program_time", "throughput",
+          "sleep_time", "sleep_ratio")
+
+
+def crc16_xmodem(data):
+    crc = 0
+    for byte in data:
+        crc ^= byte << 8
+        for _ in range(8):
+            crc = ((crc << 1) ^ 0x1021) if crc & 0x8000 else (crc << 1)
+            crc &= 0xFFFF
+    return crc
+
+
+def parse(frame):
+    if len(frame) < HEADER.size:
+        raise ValueError("no statistics frame received")
+    magic, version, size, _ = HEADER.unpack_from(frame)
+    if magic != STATS_MAGIC:
+        raise ValueError("bad statistics magic 0x%08x" % magic)
+    end = HEADER.size + size
+    if len(frame) < end + 2:
+        raise ValueError("truncated statistics frame")
+    if crc16_xmodem(frame[:end]) != struct.unpack_from(">H", frame, end)[0]:
+        raise ValueError("statistics frame CRC mismatch")
+    # newer firmware may append fields, keep the ones we know about
+    count = min(size // 4, len(FIELDS))
+    values = struct.unpack_from("<%dI" % count, frame, HEADER.size)
+    return version, dict(zip(FIELDS, values))
+
+
+def fetch(port, baud):
+    import serial  # pyserial
+
+    with serial.Serial(port, baud, timeout=1) as link:
+        link.reset_input_buffer()
+        link.write(b"S")
+        frame = link.read(HEADER.size)
+        if len(frame) == HEADER.size:
+            frame += link.read(frame[5] + 2)
+        return frame
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--port", required=True, help="serial port of the bootloader")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("--csv", help="append one row per unit to this CSV file")
+    parser.add_argument("--unit", default="", help="unit identifier for the CSV row")
+    args = parser.parse_args()
+
+    try:
+        version, stats = parse(fetch(args.port, args.baud))
+    except ValueError as err:
+        sys.exit("error: %s" % err)
+
+    if args.csv:
+        new = not os.path.exists(args.csv)
+        with open(args.csv, "a", newline="") as f:
+            writer = csv.writer(f)
+            if new:
+                writer.writerow(("time", "unit", "version") + FIELDS)
+            writer.writerow([time.strftime("%Y-%m-%dT%H:%M:%S"), args.unit, version] +
+                            [stats.get(name, "") for name in FIELDS])
+    else:
+        for name in FIELDS:
+            if name in stats:
+                print("%-17s %d" % (name, stats[name]))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,173 @@
+#!/usr/bin/env python3
+"""Sign an application image for a bootloader built with IAP_SIGNED_IMAGES.
+
+The image is padded with 0xFF to a doubleword, then the trailer checked by
+Core/Src/verify.c is appended:
+
+    Ed25519 signature of SHA-256(padded image) (64) | padded length (4, LE)
+    | magic "IAPG" (4)
+
+The key file holds the 32-byte Ed25519 secret seed. "keygen" makes one and
+writes the public key to Core/Inc/verify_key.h, which the bootloader needs to
+build with IAP_SIGNED_IMAGES or YMODEM_MANIFEST: no key is built in. "pubkey"
+writes the header again from the key file. Keep the key file off the build
+machines that do not sign releases.
+
+    sign_image.py keygen release.key
+    sign_image.py sign --key release.key app.bin app_signed.bin
+    sign_image.py pubkey release.key --header Core/Inc/verify_key.h
+
+Ed25519 is implemented here (RFC 8032) so that no package is needed; signing
+is not constant time, run it on a trusted host.
+"""
+
+import argparse
+import hashlib
+import os
+import struct
+import sys
+
+HEADER = os.path.join(os.path.dirname(os.path.abspath(__file__)), "..", "Core", "Inc", "verify_key.h")
+TRAILER_MAGIC = 0x47504149
+TRAILER_SIZE = 72
+DWORD = 8
+
+P = 2 ** 255 - 19
+L = 2 ** 252 + 27742317777372353535851937790883648493
+D = -121665 * pow(121666, P - 2, P) % P
+SQRT_M1 = pow(2, (P - 1) // 4, P)
+
+
+def recover_x(y, sign):
+    xx = (y * y - 1) * pow(D * y * y + 1, P - 2, P) % P
+    x = pow(xx, (P + 3) // 8, P)
+    if (x * x - xx) % P:
+        x = x * SQRT_M1 % P
+    if x & 1 != sign:
+        x = P - x
+    return x
+
+
+BASE_Y = 4 * pow(5, P - 2, P) % P
+BASE_X = recover_x(BASE_Y, 0)
+BASE = (BASE_X, BASE_Y, 1, BASE_X * BASE_Y % P)
+
+
+def point_add(p1, p2):
+    a = (p1[1] - p1[0]) * (p2[1] - p2[0]) % P
+    b = (p1[1] + p1[0]) * (p2[1] + p2[0]) % P
+    c = 2 * p1[3] * p2[3] * D % P
+    d = 2 * p1[2] * p2[2] % P
+    e, f, g, h = b - a, d - c, d + c, b + a
+    return (e * f % P, g * h % P, f * g % P, e * h % P)
+
+
+def point_mul(scalar, point):
+    result = (0, 1, 1, 0)
+    while scalar:
+        if scalar & 1:
+            result = point_add(result, point)
+        point = point_add(point, point)
+        scalar >>= 1
+    return result
+
+
+def encode(point):
+    zi = pow(point[2], P - 2, P)
+    x, y = point[0] * zi % P, point[1] * zi % P
+    return (y | ((x & 1) << 255)).to_bytes(32, "little")
+
+
+def expand(seed):
+    h = hashlib.sha512(seed).digest()
+    a = int.from_bytes(h[:32], "little")
+    a = (a & ((1 << 254) - 8)) | (1 << 254)
+    return a, h[32:]
+
+
+def public_key(seed):
+    return encode(point_mul(expand(seed)[0], BASE))
+
+
+def sign(seed, message):
+    a, prefix = expand(seed)
+    public = encode(point_mul(a, BASE))
+    r = int.from_bytes(hashlib.sha512(prefix + message).digest(), "little") % L
+    big_r = encode(point_mul(r, BASE))
+    k = int.from_bytes(hashlib.sha512(big_r + public + message).digest(), "little") % L
+    return big_r + ((r + k * a) % L).to_bytes(32, "little")
+
+
+def key_header(key):
+    rows = ["  " + ", ".join("0x%02x" % b for b in key[i:i + 16]) for i in range(0, len(key), 16)]
+    return ("/**\n"
+            "  ******************************************************************************\n"
+            "  * @file    verify_key.h\n"
+            "  * @brief   Public key of the signed images, made by Tools/sign_image.py\n"
+            "  *          keygen. Images are signed with the matching key file.\n"
+            "  ******************************************************************************\n"
+            "  */\n\n"
+            "#ifndef __VERIFY_KEY_H\n"
+            "#define __VERIFY_KEY_H\n\n"
+            "#define VERIFY_PUBLIC_KEY \\\n"
+            "{ \\\n" + ", \\\n".join(rows) + " \\\n}\n\n"
+            "#endif  /* __VERIFY_KEY_H */\n\n"
+            "/*******************************END OF FILE************************************/\n")
+
+
+def write_header(path, key, overwrite):
+    if os.path.exists(path) and not overwrite:
+        sys.exit("error: %s exists, not overwritten" % path)
+    with open(path, "w") as f:
+        f.write(key_header(key))
+    print("%s: public key %s" % (path, key.hex()))
+
+
+def read_key(path):
+    with open(path, "rb") as f:
+        seed = f.read()
+    if len(seed) != 32:
+        sys.exit("error: %s is not a 32-byte Ed25519 seed" % path)
+    return seed
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    commands = parser.add_subparsers(dest="command", required=True)
+    keygen = commands.add_parser("keygen", help="make a new key file and its verify_key.h")
+    keygen.add_argument("key")
+    keygen.add_argument("--header", default=HEADER, help="public key header of the bootloader")
+    pubkey = commands.add_parser("pubkey", help="write verify_key.h again from a key file")
+    pubkey.add_argument("key")
+    pubkey.add_argument("--header", default=HEADER, help="public key header of the bootloader")
+    signer = commands.add_parser("sign", help="append the signature trailer to an image")
+    signer.add_argument("--key", required=True, help="key file made by keygen")
+    signer.add_argument("image", help="application binary")
+    signer.add_argument("output", help="signed binary to download")
+    args = parser.parse_args()
+
+    if args.command == "keygen":
+        for path in (args.key, args.header):
+            if os.path.exists(path):
+                sys.exit("error: %s exists, not overwritten" % path)
+        seed = os.urandom(32)
+        with open(args.key, "wb") as f:
+            f.write(seed)
+        write_header(args.header, public_key(seed), False)
+    elif args.command == "pubkey":
+        write_header(args.header, public_key(read_key(args.key)), True)
+    else:
+        seed = read_key(args.key)
+        with open(args.image, "rb") as f:
+            data = f.read()
+        data += b"\xff" * (-len(data) % DWORD)
+        digest = hashlib.sha256(data).digest()
+        trailer = sign(seed, digest) + struct.pack("<II", len(data), TRAILER_MAGIC)
+        with open(args.output, "wb") as f:
+            f.write(data + trailer)
+        print("%s: %d bytes signed, SHA-256 %s" % (args.output, len(data), digest.hex()))
+
+
+if __name__ == "__main__":
+    main()
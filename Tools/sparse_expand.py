@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""Expand a sparse flash upload from the IAP bootloader into a plain image.
+
+Press '2' in the bootloader menu, then send 'S' ahead of the YMODEM 'C' to get
+UploadedFlashImage.sparse instead of the full image (see SPARSE_MAGIC in
+Core/Inc/ymodem.h):
+
+    magic "IAPZ" | base address | image length      (little endian 32-bit)
+    offset | length | data ...                       (one record per run)
+
+Bytes not covered by a record are erased flash and come out as 0xFF.
+
+    sparse_expand.py UploadedFlashImage.sparse -o image.bin
+"""
+
+import argparse
+import struct
+import sys
+
+SPARSE_MAGIC = 0x5A504149
+HEADER = struct.Struct("<III")
+RECORD = struct.Struct("<II")
+
+
+def expand(blob):
+    if len(blob) < HEADER.size:
+        raise ValueError("file shorter than the sparse header")
+    magic, base, length = HEADER.unpack_from(blob)
+    if magic != SPARSE_MAGIC:
+        raise ValueError("bad sparse magic 0x%08x" % magic)
+    image = bytearray(b"\xff" * length)
+    pos = HEADER.size
+    # YMODEM pads the last block with 0x1A, stop once the records are used up
+    while pos + RECORD.size <= len(blob):
+        offset, size = RECORD.unpack_from(blob, pos)
+        if offset + size > length:
+            break
+        pos += RECORD.size
+        if pos + size > len(blob):
+            raise ValueError("truncated record at offset 0x%x" % offset)
+        image[offset:offset + size] = blob[pos:pos + size]
+        pos += size
+    return base, bytes(image)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("sparse", help="sparse file received from the bootloader")
+    parser.add_argument("-o", "--output", required=True, help="plain image output file")
+    args = parser.parse_args()
+
+    with open(args.sparse, "rb") as f:
+        blob = f.read()
+    try:
+        base, image = expand(blob)
+    except ValueError as err:
+        sys.exit("error: %s" % err)
+    with open(args.output, "wb") as f:
+        f.write(image)
+    print("0x%08x: %d bytes from %d" % (base, len(image), len(blob)))
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+"""Decode the IAP bootloader event trace into Chrome trace JSON.
+
+The bootloader answers a 'T' sent right after a download session with a
+Trace_HeaderTypeDef followed by Trace_RecordTypeDef records (Core/Inc/trace.h).
+Either fetch it directly:
+
+    trace_decode.py --port /dev/ttyUSB0 -o session.json
+
+or decode a blob captured by other means:
+
+    trace_decode.py trace.bin -o session.json
+
+Open the result in chrome://tracing or https://ui.perfetto.dev.
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+TRACE_MAGIC = 0x54504149
+HEADER = struct.Struct("<IBBHII")
+RECORD = struct.Struct("<IBBH")
+
+CTRL_NAMES = {0x04: "EOT", 0x06: "ACK", 0x15: "NAK", 0x18: "CA", 0x43: "C"}
+
+# event code -> (name, track, phase); "B"/"E" pairs become duration slices
+EVENTS = {
+    0x01: ("session", "protocol", "B"),
+    0x02: ("session", "protocol", "E"),
+    0x10: ("packet start", "link", "i"),
+    0x11: ("header ok", "link", "i"),
+    0x12: ("sequence fail", "link", "i"),
+    0x13: ("crc ok", "link", "i"),
+    0x14: ("crc fail", "link", "i"),
+    0x15: ("timeout", "link", "i"),
+    0x20: ("erase", "flash", "B"),
+    0x21: ("erase", "flash", "E"),
+    0x22: ("program", "flash", "B"),
+    0x23: ("program", "flash", "E"),
+    0x30: ("tx", "protocol", "i"),
+}
+TRACKS = {"protocol": 1, "link": 2, "flash": 3}
+
+
+def parse(blob):
+    if len(blob) < HEADER.size:
+        raise ValueError("blob shorter than the trace header")
+    magic, version, record_size, count, clock_hz, dropped = HEADER.unpack_from(blob)
+    if magic != TRACE_MAGIC:
+        raise ValueError("bad trace magic 0x%08x" % magic)
+    if record_size != RECORD.size:
+        raise ValueError("unsupported record size %d (version %d)" % (record_size, version))
+    needed = HEADER.size + count * RECORD.size
+    if len(blob) < needed:
+        raise ValueError("truncated trace: %d of %d bytes" % (len(blob), needed))
+
+    records = []
+    last, high = None, 0
+    for i in range(count):
+        stamp, event, arg8, arg16 = RECORD.unpack_from(blob, HEADER.size + i * RECORD.size)
+        # stamps are 32-bit core cycles, unwrap them into a monotonic count
+        if last is not None and stamp < last:
+            high += 1 << 32
+        last = stamp
+        records.append((stamp + high, event, arg8, arg16))
+    return clock_hz, dropped, records
+
+
+def to_chrome(clock_hz, dropped, records):
+    out = []
+    base = records[0][0] if records else 0
+    for track, tid in TRACKS.items():
+        out.append({"ph": "M", "name": "thread_name", "pid": 1, "tid": tid,
+                    "args": {"name": track}})
+    for cycles, event, arg8, arg16 in records:
+        name, track, phase = EVENTS.get(event, ("event 0x%02x" % event, "protocol", "i"))
+        args = {"arg8": arg8, "arg16": arg16}
+        if event == 0x30:
+            name = "tx " + CTRL_NAMES.get(arg8, "0x%02x" % arg8)
+        elif event in (0x11, 0x12, 0x13, 0x14, 0x22):
+            args = {"block": arg8, "length": arg16}
+        entry = {"name": name, "cat": track, "ph": phase, "pid": 1,
+                 "tid": TRACKS[track], "ts": (cycles - base) * 1e6 / clock_hz,
+                 "args": args}
+        if phase == "i":
+            entry["s"] = "t"
+        out.append(entry)
+    return {"traceEvents": out, "displayTimeUnit": "ms",
+            "otherData": {"clock_hz": clock_hz, "dropped": dropped}}
+
+
+def fetch(port, baud):
+    import serial  # pyserial, only needed to talk to the board directly
+
+    with serial.Serial(port, baud, timeout=1) as link:
+        link.reset_input_buffer()
+        link.write(b"T")
+        blob = link.read(HEADER.size)
+        if len(blob) == HEADER.size:
+            count = HEADER.unpack_from(blob)[3]
+            blob += link.read(count * RECORD.size)
+        return blob
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__,
+                                     formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("blob", nargs="?", help="captured trace blob")
+    parser.add_argument("--port", help="serial port of the bootloader")
+    parser.add_argument("--baud", type=int, default=115200)
+    parser.add_argument("-o", "--output", help="JSON output file (default stdout)")
+    args = parser.parse_args()
+
+    if args.port:
+        blob = fetch(args.port, args.baud)
+    elif args.blob:
+        with open(args.blob, "rb") as f:
+            blob = f.read()
+    else:
+        parser.error("give a blob file or --port")
+
+    clock_hz, dropped, records = parse(blob)
+    if dropped:
+        print("warning: %d oldest events were overwritten" % dropped, file=sys.stderr)
+    text = json.dumps(to_chrome(clock_hz, dropped, records), indent=1)
+    if args.output:
+        with open(args.output, "w") as f:
+            f.write(text)
+    else:
+        print(text)
+
+
+if __name__ == "__main__":
+    main()